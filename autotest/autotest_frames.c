@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// autotest_frames.c
+//
+// Frame fixtures shared by autotests
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "autotest/autotest_frames.h"
+
+// generate frame parameters and payload from stream and frame index
+void autotest_frames_job(unsigned int             _stream,
+                         unsigned int             _n,
+                         unsigned int             _max_len,
+                         unsigned char *          _payload,
+                         struct wlan_txvector_s * _txvector)
+{
+    unsigned int rates[7] = {WLANFRAME_RATE_6,  WLANFRAME_RATE_12,
+                             WLANFRAME_RATE_18, WLANFRAME_RATE_24,
+                             WLANFRAME_RATE_36, WLANFRAME_RATE_48,
+                             WLANFRAME_RATE_54};
+    _txvector->LENGTH      = 1 + (_n * 397 + _stream * 131) % _max_len;
+    _txvector->DATARATE    = rates[(_n + 3*_stream) % 7];
+    _txvector->SERVICE     = 0;
+    _txvector->TXPWR_LEVEL = 0;
+
+    // fill whole payload so that callers may lengthen frame
+    unsigned int i;
+    for (i=0; i<_max_len; i++)
+        _payload[i] = (i + 13*_n + 101*_stream) & 0xff;
+}
+
+// does received frame match the one transmitted?
+int autotest_frames_match(unsigned char *        _payload,
+                          struct wlan_rxvector_s _rxvector,
+                          unsigned char *        _payload_tx,
+                          struct wlan_txvector_s _txvector)
+{
+    return _rxvector.LENGTH   == _txvector.LENGTH   &&
+           _rxvector.DATARATE == _txvector.DATARATE &&
+           memcmp(_payload, _payload_tx, _txvector.LENGTH) == 0;
+}
+
+// generate baseband signal of a stream's frames, each preceded by a gap
+float complex * autotest_frames_signal(wlanframegen        _fg,
+                                       unsigned int        _stream,
+                                       unsigned int        _num_frames,
+                                       unsigned int        _max_len,
+                                       unsigned int        _num_gap,
+                                       unsigned int        _num_gap_var,
+                                       unsigned long int * _starts,
+                                       unsigned int *      _num_samples)
+{
+    unsigned char payload[4095];
+    struct wlan_txvector_s txvector;
+    float complex * x = NULL;
+    unsigned int num_samples = 0;
+    unsigned int n;
+    for (n=0; n<_num_frames; n++) {
+        unsigned int num_gap = _num_gap + (_num_gap_var > 0 ? (n * 7919) % _num_gap_var : 0);
+        autotest_frames_job(_stream, n, _max_len, payload, &txvector);
+        wlanframegen_assemble(_fg, payload, txvector);
+        unsigned int frame_len = wlanframegen_getframelen(_fg);
+        x = (float complex*) realloc(x, (num_samples + num_gap + frame_len)*sizeof(float complex));
+        memset(&x[num_samples], 0x00, num_gap*sizeof(float complex));
+        wlanframegen_write_frame(_fg, &x[num_samples + num_gap]);
+        if (_starts != NULL)
+            _starts[n] = num_samples + num_gap;
+        num_samples += num_gap + frame_len;
+    }
+    *_num_samples = num_samples;
+    return x;
+}
+
+// write file, exiting on failure
+void autotest_frames_write(const char * _filename,
+                           const void * _data,
+                           size_t       _len)
+{
+    FILE * fid = fopen(_filename, "wb");
+    if (fid == NULL || fwrite(_data, 1, _len, fid) != _len) {
+        fprintf(stderr,"error: %s, could not write '%s'\n", __FILE__, _filename);
+        exit(1);
+    }
+    fclose(fid);
+}
+
+// initialize received frames
+void autotest_frames_init(struct autotest_frames_s * _q,
+                          unsigned int               _stream,
+                          unsigned int               _max_len)
+{
+    _q->stream     = _stream;
+    _q->max_len    = _max_len;
+    _q->num_frames = 0;
+    _q->valid      = 1;
+    _q->rssi       = NULL;
+    _q->max_frames = 0;
+}
+
+// record signal strength of each frame
+void autotest_frames_set_rssi(struct autotest_frames_s * _q,
+                              unsigned int *             _rssi,
+                              unsigned int               _max_frames)
+{
+    _q->rssi       = _rssi;
+    _q->max_frames = _max_frames;
+}
+
+// check received frame against next expected frame on stream
+void autotest_frames_receive(struct autotest_frames_s * _q,
+                             unsigned char *            _payload,
+                             struct wlan_rxvector_s     _rxvector)
+{
+    unsigned char payload[4095];
+    struct wlan_txvector_s txvector;
+    autotest_frames_job(_q->stream, _q->num_frames, _q->max_len, payload, &txvector);
+    if (!autotest_frames_match(_payload, _rxvector, payload, txvector)) {
+        fprintf(stderr,"autotest: stream %u, frame %u mismatch\n", _q->stream, _q->num_frames);
+        _q->valid = 0;
+    }
+
+    if (_q->rssi != NULL && _q->num_frames < _q->max_frames)
+        _q->rssi[_q->num_frames] = _rxvector.RSSI;
+    _q->num_frames++;
+}
+
+// frame synchronizer callback, with received frames as user data
+int autotest_frames_callback(unsigned char *        _payload,
+                             struct wlan_rxvector_s _rxvector,
+                             void *                 _userdata)
+{
+    autotest_frames_receive((struct autotest_frames_s*) _userdata, _payload, _rxvector);
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// autotest_frames.h
+//
+// Frame fixtures shared by autotests: deterministic frame parameters
+// and payloads for each stream, baseband signals of frames separated by
+// gaps, and a synchronizer callback checking frames as they arrive
+//
+
+#ifndef __LIQUID_WLAN_AUTOTEST_FRAMES_H__
+#define __LIQUID_WLAN_AUTOTEST_FRAMES_H__
+
+#include <stddef.h>
+#include <complex.h>
+
+#include "liquid-wlan.h"
+
+// generate frame parameters and payload from stream and frame index;
+// rates cycle through all those supported (not 9 Mb/s), and lengths
+// spread over [1,_max_len]
+//  _stream     :   stream (channel, antenna set, ...) index
+//  _n          :   frame index within stream
+//  _max_len    :   maximum payload length, 0 < _max_len <= 4095
+//  _payload    :   payload (output) [size: _max_len x 1]
+//  _txvector   :   framing options (output)
+void autotest_frames_job(unsigned int             _stream,
+                         unsigned int             _n,
+                         unsigned int             _max_len,
+                         unsigned char *          _payload,
+                         struct wlan_txvector_s * _txvector);
+
+// does received frame match the one transmitted?
+//  _payload        :   received payload
+//  _rxvector       :   received frame parameters
+//  _payload_tx     :   transmitted payload
+//  _txvector       :   transmitted framing options
+int autotest_frames_match(unsigned char *        _payload,
+                          struct wlan_rxvector_s _rxvector,
+                          unsigned char *        _payload_tx,
+                          struct wlan_txvector_s _txvector);
+
+// generate baseband signal of a stream's frames, each preceded by a gap
+// of _num_gap samples plus up to _num_gap_var - 1 more (varying from
+// frame to frame), returning the signal (to be freed by the caller)
+//  _fg             :   frame generator
+//  _stream         :   stream index
+//  _num_frames     :   number of frames
+//  _max_len        :   maximum payload length
+//  _num_gap        :   minimum number of samples before each frame
+//  _num_gap_var    :   gap variation (0 for none)
+//  _starts         :   frame start samples (output, ignored if NULL) [size: _num_frames x 1]
+//  _num_samples    :   number of samples in signal (output)
+float complex * autotest_frames_signal(wlanframegen        _fg,
+                                       unsigned int        _stream,
+                                       unsigned int        _num_frames,
+                                       unsigned int        _max_len,
+                                       unsigned int        _num_gap,
+                                       unsigned int        _num_gap_var,
+                                       unsigned long int * _starts,
+                                       unsigned int *      _num_samples);
+
+// write file, exiting on failure
+void autotest_frames_write(const char * _filename,
+                           const void * _data,
+                           size_t       _len);
+
+// frames received on one stream, checked in order against
+// autotest_frames_job()
+struct autotest_frames_s {
+    unsigned int stream;        // stream index
+    unsigned int max_len;       // maximum payload length
+    unsigned int num_frames;    // number of frames received
+    int valid;                  // all frames received correctly?
+    unsigned int * rssi;        // signal strength of each frame (ignored if NULL)
+    unsigned int max_frames;    // size of rssi array
+};
+
+// initialize received frames
+//  _q          :   received frames
+//  _stream     :   stream index
+//  _max_len    :   maximum payload length
+void autotest_frames_init(struct autotest_frames_s * _q,
+                          unsigned int               _stream,
+                          unsigned int               _max_len);
+
+// record signal strength of each frame
+//  _q          :   received frames
+//  _rssi       :   signal strength of each frame [size: _max_frames x 1]
+//  _max_frames :   maximum number of frames
+void autotest_frames_set_rssi(struct autotest_frames_s * _q,
+                              unsigned int *             _rssi,
+                              unsigned int               _max_frames);
+
+// check received frame against next expected frame on stream
+void autotest_frames_receive(struct autotest_frames_s * _q,
+                             unsigned char *            _payload,
+                             struct wlan_rxvector_s     _rxvector);
+
+// frame synchronizer callback, with received frames as user data
+int autotest_frames_callback(unsigned char *        _payload,
+                             struct wlan_rxvector_s _rxvector,
+                             void *                 _userdata);
+
+#endif // __LIQUID_WLAN_AUTOTEST_FRAMES_H__
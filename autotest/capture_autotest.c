@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+//
+// capture_autotest.c
+//
+// Test memory-mapped capture reader: frames written to capture files in
+// each sample format are read back through the frame synchronizer
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <complex.h>
+
+#include "liquid-wlan.internal.h"
+#include "autotest/autotest_frames.h"
+
+#define CAPTURE_AUTOTEST_NUM_FRAMES (6)
+
+// receive frames from capture file
+//  _filename   :   capture file name
+//  _format     :   format to open with
+//  _expected   :   expected format
+//  _num_samples:   expected number of samples
+void capture_autotest_receive(const char *      _filename,
+                              int               _format,
+                              int               _expected,
+                              unsigned long int _num_samples)
+{
+    wlancapture q = wlancapture_open(_filename, _format, 0);
+    if (wlancapture_get_format(q) != _expected ||
+        wlancapture_get_num_samples(q) != _num_samples)
+    {
+        fprintf(stderr,"fail: %s, '%s' format %d (expected %d), %lu samples (expected %lu)\n",
+                __FILE__, _filename, wlancapture_get_format(q), _expected,
+                wlancapture_get_num_samples(q), _num_samples);
+        exit(1);
+    }
+
+    struct autotest_frames_s testdata;
+    autotest_frames_init(&testdata, 0, 700);
+    unsigned long int num_read = 0;
+    unsigned int n;
+    wlanframesync fs = wlanframesync_create(autotest_frames_callback, (void*)&testdata);
+    while ( (n = wlancapture_execute(q, fs)) > 0)
+        num_read += n;
+    wlanframesync_destroy(fs);
+    wlancapture_close(q);
+
+    if (num_read != _num_samples || !testdata.valid || testdata.num_frames != CAPTURE_AUTOTEST_NUM_FRAMES) {
+        fprintf(stderr,"fail: %s, '%s' read %lu samples, received %u of %u frames\n",
+                __FILE__, _filename, num_read, testdata.num_frames, CAPTURE_AUTOTEST_NUM_FRAMES);
+        exit(1);
+    }
+    printf("  %u frames received (%s)\n", testdata.num_frames, _filename);
+}
+
+int main() {
+    unsigned int num_gap = 50000;   // number of samples between frames
+
+    // generate baseband signal
+    wlanframegen fg = wlanframegen_create();
+    unsigned int num_samples;
+    float complex * x = autotest_frames_signal(fg, 0, CAPTURE_AUTOTEST_NUM_FRAMES, 700, num_gap, 0, NULL, &num_samples);
+    wlanframegen_destroy(fg);
+    unsigned int i;
+
+    // convert formats at transmit scaling
+    int16_t * x16 = (int16_t*) malloc(2*num_samples*sizeof(int16_t));
+    int8_t  * x8  = (int8_t*)  malloc(2*num_samples*sizeof(int8_t) + 1);
+    liquid_wlan_cf_to_sc16(x, num_samples, WLANFRAMEGEN_SC16_SCALE, x16);
+    for (i=0; i<2*num_samples; i++)
+        x8[i] = (int8_t) (x16[i] / 256);
+    x8[2*num_samples] = 0;
+
+    // cf32 with extension, more than one block
+    autotest_frames_write("capture_autotest.cf32", x, num_samples*sizeof(float complex));
+    capture_autotest_receive("capture_autotest.cf32", LIQUID_WLAN_CAPTURE_AUTO,
+                             LIQUID_WLAN_CAPTURE_CF32, num_samples);
+
+    // sc16 with SigMF metadata
+    const char * meta = "{\n"
+                        "    \"global\": {\n"
+                        "        \"core:datatype\": \"ci16_le\",\n"
+                        "        \"core:sample_rate\": 20000000,\n"
+                        "        \"core:version\": \"1.0.0\"\n"
+                        "    },\n"
+                        "    \"captures\": [],\n"
+                        "    \"annotations\": []\n"
+                        "}\n";
+    autotest_frames_write("capture_autotest.sigmf-meta", meta, strlen(meta));
+    autotest_frames_write("capture_autotest.sigmf-data", x16, 2*num_samples*sizeof(int16_t));
+    capture_autotest_receive("capture_autotest.sigmf-data", LIQUID_WLAN_CAPTURE_AUTO,
+                             LIQUID_WLAN_CAPTURE_SC16, num_samples);
+
+    // sc8 with explicit format, with a partial trailing sample
+    autotest_frames_write("capture_autotest.dat", x8, 2*num_samples*sizeof(int8_t) + 1);
+    capture_autotest_receive("capture_autotest.dat", LIQUID_WLAN_CAPTURE_SC8,
+                             LIQUID_WLAN_CAPTURE_SC8, num_samples);
+
+    // blocks end on block boundaries, and start anywhere after seeking
+    wlancapture q = wlancapture_open("capture_autotest.sigmf-data", LIQUID_WLAN_CAPTURE_AUTO, 0);
+    unsigned int block_len = WLANCAPTURE_BLOCK_SIZE / (2*sizeof(int16_t));
+    const void * block;
+    if (wlancapture_get_sample_rate(q) != 20e6f ||
+        wlancapture_read(q, &block) != block_len ||
+        memcmp(block, x16, WLANCAPTURE_BLOCK_SIZE) != 0)
+    {
+        fprintf(stderr,"fail: %s, invalid first block\n", __FILE__);
+        exit(1);
+    }
+    wlancapture_seek(q, block_len - 10);
+    if (wlancapture_read(q, &block) != 10 ||
+        memcmp(block, &x16[2*(block_len-10)], 10*2*sizeof(int16_t)) != 0 ||
+        wlancapture_read(q, &block) != (num_samples < 2*block_len ? num_samples - block_len : block_len))
+    {
+        fprintf(stderr,"fail: %s, invalid block after seek\n", __FILE__);
+        exit(1);
+    }
+    wlancapture_seek(q, num_samples);
+    if (wlancapture_read(q, &block) != 0) {
+        fprintf(stderr,"fail: %s, read past end of capture\n", __FILE__);
+        exit(1);
+    }
+    wlancapture_close(q);
+    printf("  block boundaries ok\n");
+
+    remove("capture_autotest.cf32");
+    remove("capture_autotest.sigmf-meta");
+    remove("capture_autotest.sigmf-data");
+    remove("capture_autotest.dat");
+    free(x);
+    free(x16);
+    free(x8);
+    return 0;
+}
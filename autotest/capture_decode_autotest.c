@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+//
+// capture_decode_autotest.c
+//
+// Test parallel offline decoding: frames of all lengths, some spanning
+// several segments, are decoded from a capture file with short segments
+// and compared against their known positions; a 40 MS/s capture is
+// rejected without a front-end and decoded with one
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <complex.h>
+
+#include "liquid-wlan.internal.h"
+#include "autotest/autotest_frames.h"
+
+#define CAPTURE_DECODE_AUTOTEST_NUM_FRAMES  (24)
+#define CAPTURE_DECODE_AUTOTEST_FILENAME    "capture_decode_autotest.sc16"
+#define CAPTURE_DECODE_AUTOTEST_FILENAME_40 "capture_decode_autotest.sigmf-data"
+#define CAPTURE_DECODE_AUTOTEST_META_40     "capture_decode_autotest.sigmf-meta"
+
+// generate frame parameters from index: every eighth frame is the
+// longest possible, spanning segments
+void capture_decode_autotest_job(unsigned int             _n,
+                                 unsigned char *          _payload,
+                                 struct wlan_txvector_s * _txvector)
+{
+    autotest_frames_job(0, _n, (_n % 8) == 3 ? 4095 : 600, _payload, _txvector);
+    if ((_n % 8) == 3) {
+        _txvector->LENGTH   = 4095;
+        _txvector->DATARATE = WLANFRAME_RATE_6;
+    }
+}
+
+// structure for tracking decoded frames
+struct capture_decode_autotest_s {
+    unsigned long int * starts;     // frame start samples
+    long int tolerance;             // frame start tolerance (samples)
+    unsigned int num_frames;        // number of frames received
+    unsigned long int last;         // previous frame start
+    int valid;                      // all frames received correctly?
+};
+
+// callback function: compare each frame against its parameters and
+// position
+static int callback(unsigned long int      _sample,
+                    unsigned char *        _payload,
+                    struct wlan_rxvector_s _rxvector,
+                    void *                 _userdata)
+{
+    struct capture_decode_autotest_s * testdata = (struct capture_decode_autotest_s*) _userdata;
+    unsigned int n = testdata->num_frames++;
+    if (n >= CAPTURE_DECODE_AUTOTEST_NUM_FRAMES) {
+        testdata->valid = 0;
+        return 0;
+    }
+
+    unsigned char payload[4095];
+    struct wlan_txvector_s txvector;
+    capture_decode_autotest_job(n, payload, &txvector);
+    long int dt = (long int)_sample - (long int)testdata->starts[n];
+    if (!autotest_frames_match(_payload, _rxvector, payload, txvector) ||
+        dt < -testdata->tolerance || dt > testdata->tolerance ||
+        (n > 0 && _sample <= testdata->last))
+    {
+        fprintf(stderr,"capture_decode_autotest: frame %u mismatch (start %lu, expected %lu)\n",
+                n, _sample, testdata->starts[n]);
+        testdata->valid = 0;
+    }
+    testdata->last = _sample;
+    return 0;
+}
+
+// decode capture and check frames
+//  _q              :   capture file reader
+//  _starts         :   frame start samples
+//  _tolerance      :   frame start tolerance (samples)
+//  _num_threads    :   number of worker threads
+//  _segment_len    :   samples per segment
+void capture_decode_autotest(wlancapture         _q,
+                             unsigned long int * _starts,
+                             long int            _tolerance,
+                             unsigned int        _num_threads,
+                             unsigned long int   _segment_len)
+{
+    struct capture_decode_autotest_s testdata = {_starts, _tolerance, 0, 0, 1};
+    unsigned long int num_frames = wlancapture_decode(_q, _num_threads, _segment_len, callback, (void*)&testdata);
+
+    if (!testdata.valid || num_frames != CAPTURE_DECODE_AUTOTEST_NUM_FRAMES ||
+        testdata.num_frames != CAPTURE_DECODE_AUTOTEST_NUM_FRAMES)
+    {
+        fprintf(stderr,"fail: %s, %u thread(s), segment %lu: received %u of %u frames\n", __FILE__,
+                _num_threads, _segment_len, testdata.num_frames, CAPTURE_DECODE_AUTOTEST_NUM_FRAMES);
+        exit(1);
+    }
+    printf("  %u frames received (%u thread(s), segment %lu)\n",
+            testdata.num_frames, _num_threads, _segment_len);
+}
+
+// generate capture at 20 MS/s times _P, with gaps of varying length
+// between frames, returning number of samples
+//  _filename   :   capture file name
+//  _P          :   interpolation factor
+//  _starts     :   frame start samples (output)
+unsigned int capture_decode_autotest_write(const char *        _filename,
+                                           unsigned int        _P,
+                                           unsigned long int * _starts)
+{
+    wlanframegen fg = wlanframegen_create_interp(_P, 1);
+    unsigned char payload[4095];
+    struct wlan_txvector_s txvector;
+    float complex * x = NULL;
+    unsigned int num_samples = 0;
+    unsigned int n;
+    for (n=0; n<CAPTURE_DECODE_AUTOTEST_NUM_FRAMES; n++) {
+        unsigned int num_gap = _P*(500 + (n * 7919) % 8000);
+        capture_decode_autotest_job(n, payload, &txvector);
+        wlanframegen_assemble(fg, payload, txvector);
+        unsigned int frame_len = wlanframegen_getframelen(fg);
+        x = (float complex*) realloc(x, (num_samples + num_gap + frame_len)*sizeof(float complex));
+        memset(&x[num_samples], 0x00, num_gap*sizeof(float complex));
+        wlanframegen_write_frame(fg, &x[num_samples + num_gap]);
+
+        // output interpolator delays frame by 8 baseband samples
+        _starts[n] = num_samples + num_gap + (_P > 1 ? 8*_P : 0);
+        num_samples += num_gap + frame_len;
+    }
+    wlanframegen_destroy(fg);
+
+    int16_t * x16 = (int16_t*) malloc(2*num_samples*sizeof(int16_t));
+    liquid_wlan_cf_to_sc16(x, num_samples, WLANFRAMEGEN_SC16_SCALE, x16);
+    autotest_frames_write(_filename, x16, 2*num_samples*sizeof(int16_t));
+    free(x);
+    free(x16);
+    return num_samples;
+}
+
+// configuration callback: front-end from 40 MS/s
+static void config_40(wlanframesync _fs,
+                      void *        _userdata)
+{
+    wlanframesync_set_frontend(_fs, 1, 2, 0.0f);
+}
+
+int main() {
+    // decode: single segment, then short segments so that frames span
+    // several, with varying numbers of threads
+    unsigned long int starts[CAPTURE_DECODE_AUTOTEST_NUM_FRAMES];
+    capture_decode_autotest_write(CAPTURE_DECODE_AUTOTEST_FILENAME, 1, starts);
+    wlancapture q = wlancapture_open(CAPTURE_DECODE_AUTOTEST_FILENAME, LIQUID_WLAN_CAPTURE_AUTO, 0);
+    capture_decode_autotest(q, starts, 4, 1, 0);
+    capture_decode_autotest(q, starts, 4, 1, 100000);
+    capture_decode_autotest(q, starts, 4, 4, 100000);
+    capture_decode_autotest(q, starts, 4, 3, 65432);
+    wlancapture_close(q);
+    remove(CAPTURE_DECODE_AUTOTEST_FILENAME);
+
+    // 40 MS/s capture with SigMF metadata: rejected by default, decoded
+    // with a front-end, positions reported in capture samples
+    const char * meta = "{\"global\": {\"core:datatype\": \"ci16_le\", \"core:sample_rate\": 40000000}}\n";
+    autotest_frames_write(CAPTURE_DECODE_AUTOTEST_META_40, meta, strlen(meta));
+    capture_decode_autotest_write(CAPTURE_DECODE_AUTOTEST_FILENAME_40, 2, starts);
+    q = wlancapture_open(CAPTURE_DECODE_AUTOTEST_FILENAME_40, LIQUID_WLAN_CAPTURE_AUTO, 0);
+    if (wlancapture_is_decodable(q)) {
+        fprintf(stderr,"fail: %s, 40 MS/s capture accepted without front-end\n", __FILE__);
+        exit(1);
+    }
+    wlancapture_set_config(q, config_40, NULL);
+    capture_decode_autotest(q, starts, 8, 2, 150000);
+    wlancapture_close(q);
+    remove(CAPTURE_DECODE_AUTOTEST_FILENAME_40);
+    remove(CAPTURE_DECODE_AUTOTEST_META_40);
+
+    return 0;
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+//
+// capture_index_autotest.c
+//
+// Test frame index: a capture is decoded with an index, one frame having
+// its SIGNAL field blanked out; the index must list every frame,
+// including the rejected one, agree between single- and multi-threaded
+// decoding, and re-decode the same frames when read back. Once the
+// SIGNAL field is restored, re-decoding the index must recover the
+// rejected frame too, and a synchronizer configured off-channel must
+// find none.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <complex.h>
+
+#include "liquid-wlan.internal.h"
+#include "autotest/autotest_frames.h"
+
+#define CAPTURE_INDEX_AUTOTEST_NUM_FRAMES   (12)
+#define CAPTURE_INDEX_AUTOTEST_REJECTED     (5)
+#define CAPTURE_INDEX_AUTOTEST_FILENAME     "capture_index_autotest.sc16"
+#define CAPTURE_INDEX_AUTOTEST_INDEX        "capture_index_autotest.idx"
+
+// structure for tracking decoded frames
+struct capture_index_autotest_s {
+    unsigned long int * starts;     // frame start samples
+    unsigned int skip;              // frame not expected (NUM_FRAMES for none)
+    unsigned int num_frames;        // number of frames received
+    int valid;                      // all frames received correctly?
+};
+
+// callback function: compare each frame against its parameters and
+// position, skipping the rejected frame if not expected
+static int callback(unsigned long int      _sample,
+                    unsigned char *        _payload,
+                    struct wlan_rxvector_s _rxvector,
+                    void *                 _userdata)
+{
+    struct capture_index_autotest_s * testdata = (struct capture_index_autotest_s*) _userdata;
+    unsigned int n = testdata->num_frames++;
+    if (n >= testdata->skip)
+        n++;
+    if (n >= CAPTURE_INDEX_AUTOTEST_NUM_FRAMES) {
+        testdata->valid = 0;
+        return 0;
+    }
+
+    unsigned char payload[4095];
+    struct wlan_txvector_s txvector;
+    autotest_frames_job(0, n, 600, payload, &txvector);
+    long int dt = (long int)_sample - (long int)testdata->starts[n];
+    if (!autotest_frames_match(_payload, _rxvector, payload, txvector) ||
+        dt < -4 || dt > 4)
+    {
+        fprintf(stderr,"capture_index_autotest: frame %u mismatch (start %lu, expected %lu)\n",
+                n, _sample, testdata->starts[n]);
+        testdata->valid = 0;
+    }
+    return 0;
+}
+
+// check that all expected frames were received
+void capture_index_autotest_check(struct capture_index_autotest_s * _testdata,
+                                  unsigned long int                 _num_frames,
+                                  const char *                      _pass)
+{
+    unsigned int num_expected = CAPTURE_INDEX_AUTOTEST_NUM_FRAMES -
+        (_testdata->skip < CAPTURE_INDEX_AUTOTEST_NUM_FRAMES ? 1 : 0);
+    if (!_testdata->valid || _num_frames != num_expected || _testdata->num_frames != num_expected) {
+        fprintf(stderr,"fail: %s, %s: received %u of %u frames\n", __FILE__,
+                _pass, _testdata->num_frames, num_expected);
+        exit(1);
+    }
+    printf("  %u frames received (%s)\n", _testdata->num_frames, _pass);
+}
+
+// read index and check its entries against frame parameters
+//  _starts     :   frame start samples
+//  _entries    :   index entries (output) [size: NUM_FRAMES x 1]
+//  _num_samples:   number of samples in capture
+void capture_index_autotest_read(unsigned long int *                _starts,
+                                 struct wlancapture_index_entry_s * _entries,
+                                 unsigned long int                  _num_samples)
+{
+    FILE * fid = fopen(CAPTURE_INDEX_AUTOTEST_INDEX, "rb");
+    struct wlancapture_index_header_s header;
+    if (fid == NULL || fread(&header, sizeof(header), 1, fid) != 1 ||
+        memcmp(header.magic, "LWIX", 4) != 0 || header.num_samples != _num_samples)
+    {
+        fprintf(stderr,"fail: %s, invalid index header\n", __FILE__);
+        exit(1);
+    }
+    unsigned int num_entries = fread(_entries, sizeof(struct wlancapture_index_entry_s),
+                                     CAPTURE_INDEX_AUTOTEST_NUM_FRAMES+1, fid);
+    fclose(fid);
+    if (num_entries != CAPTURE_INDEX_AUTOTEST_NUM_FRAMES) {
+        fprintf(stderr,"fail: %s, index has %u entries, expected %u\n", __FILE__,
+                num_entries, CAPTURE_INDEX_AUTOTEST_NUM_FRAMES);
+        exit(1);
+    }
+
+    unsigned int n;
+    for (n=0; n<CAPTURE_INDEX_AUTOTEST_NUM_FRAMES; n++) {
+        unsigned char payload[4095];
+        struct wlan_txvector_s txvector;
+        autotest_frames_job(0, n, 600, payload, &txvector);
+        struct wlancapture_index_entry_s * e = &_entries[n];
+        long int dt = (long int)e->sample - (long int)_starts[n];
+        int rejected = n == CAPTURE_INDEX_AUTOTEST_REJECTED;
+        if (dt < -4 || dt > 4 || !isfinite(e->rssi) || fabsf(e->cfo) > 1e-3f ||
+            e->status != (rejected ? LIQUID_WLAN_CAPTURE_FRAME_REJECTED : LIQUID_WLAN_CAPTURE_FRAME_DECODED) ||
+            e->length != (rejected ? 0 : txvector.LENGTH) ||
+            e->rate   != (rejected ? 0 : txvector.DATARATE))
+        {
+            fprintf(stderr,"fail: %s, index entry %u mismatch (start %lu, expected %lu, status %u)\n",
+                    __FILE__, n, (unsigned long int)e->sample, _starts[n], e->status);
+            exit(1);
+        }
+    }
+}
+
+// write capture file
+void capture_index_autotest_write(float complex * _x,
+                                  unsigned int    _num_samples)
+{
+    int16_t * x16 = (int16_t*) malloc(2*_num_samples*sizeof(int16_t));
+    liquid_wlan_cf_to_sc16(_x, _num_samples, WLANFRAMEGEN_SC16_SCALE, x16);
+    autotest_frames_write(CAPTURE_INDEX_AUTOTEST_FILENAME, x16, 2*_num_samples*sizeof(int16_t));
+    free(x16);
+}
+
+// check synchronizer reports signal strength of the first frame after
+// seeking through the gap that follows it
+//  _x          :   capture samples
+//  _starts     :   frame start samples
+void capture_index_autotest_rssi(float complex *     _x,
+                                 unsigned long int * _starts)
+{
+    struct autotest_frames_s frames;
+    unsigned int rssi = 0;
+    autotest_frames_init(&frames, 0, 600);
+    autotest_frames_set_rssi(&frames, &rssi, 1);
+    wlanframesync fs = wlanframesync_create(autotest_frames_callback, (void*)&frames);
+    wlanframesync_execute(fs, _x, _starts[1]);
+    float rssi_fs = wlanframesync_get_rssi(fs);
+    wlanframesync_destroy(fs);
+    if (!frames.valid || frames.num_frames != 1 || fabsf(rssi_fs - (200.0f - (float)rssi)) > 1.0f) {
+        fprintf(stderr,"fail: %s, signal strength %.2f dB not that of last frame\n", __FILE__, rssi_fs);
+        exit(1);
+    }
+}
+
+// synchronizer configuration: mix down by a channel offset well beyond
+// the receiver's carrier offset range
+void capture_index_autotest_config(wlanframesync _fs,
+                                   void *        _userdata)
+{
+    unsigned int * num_calls = (unsigned int*) _userdata;
+    (*num_calls)++;
+    wlanframesync_set_frontend(_fs, 1, 1, 0.05f);
+}
+
+int main() {
+    // generate capture, with gaps of varying length between frames
+    wlanframegen fg = wlanframegen_create();
+    unsigned long int starts[CAPTURE_INDEX_AUTOTEST_NUM_FRAMES];
+    unsigned int num_samples;
+    float complex * x = autotest_frames_signal(fg, 0, CAPTURE_INDEX_AUTOTEST_NUM_FRAMES, 600,
+                                               500, 8000, starts, &num_samples);
+    wlanframegen_destroy(fg);
+    capture_index_autotest_rssi(x, starts);
+
+    // blank SIGNAL field of one frame (after short and long training
+    // sequences, 320 samples) so it is detected but not decoded
+    float complex signal[80];
+    memmove(signal, &x[starts[CAPTURE_INDEX_AUTOTEST_REJECTED] + 320], 80*sizeof(float complex));
+    memset(&x[starts[CAPTURE_INDEX_AUTOTEST_REJECTED] + 320], 0x00, 80*sizeof(float complex));
+    capture_index_autotest_write(x, num_samples);
+
+    // decode with index, single-threaded
+    wlancapture q = wlancapture_open(CAPTURE_INDEX_AUTOTEST_FILENAME, LIQUID_WLAN_CAPTURE_AUTO, 0);
+    wlancapture_set_index(q, CAPTURE_INDEX_AUTOTEST_INDEX);
+    struct capture_index_autotest_s testdata = {starts, CAPTURE_INDEX_AUTOTEST_REJECTED, 0, 1};
+    unsigned long int num_frames = wlancapture_decode(q, 1, 0, callback, (void*)&testdata);
+    capture_index_autotest_check(&testdata, num_frames, "decode");
+    struct wlancapture_index_entry_s entries[CAPTURE_INDEX_AUTOTEST_NUM_FRAMES+1];
+    capture_index_autotest_read(starts, entries, num_samples);
+
+    // decode with index, short segments across several threads: index
+    // must list the same frames
+    struct capture_index_autotest_s testdata_mt = {starts, CAPTURE_INDEX_AUTOTEST_REJECTED, 0, 1};
+    num_frames = wlancapture_decode(q, 3, 20000, callback, (void*)&testdata_mt);
+    capture_index_autotest_check(&testdata_mt, num_frames, "decode, 3 threads");
+    struct wlancapture_index_entry_s entries_mt[CAPTURE_INDEX_AUTOTEST_NUM_FRAMES+1];
+    capture_index_autotest_read(starts, entries_mt, num_samples);
+
+    // re-decode from index: rejected frame is retried, and rejected again
+    wlancapture_set_index(q, NULL);
+    struct capture_index_autotest_s testdata_idx = {starts, CAPTURE_INDEX_AUTOTEST_REJECTED, 0, 1};
+    num_frames = wlancapture_decode_index(q, CAPTURE_INDEX_AUTOTEST_INDEX, callback, (void*)&testdata_idx);
+    capture_index_autotest_check(&testdata_idx, num_frames, "index");
+    wlancapture_close(q);
+
+    // restore SIGNAL field: re-decoding the same index must recover the
+    // frame it lists as rejected
+    memmove(&x[starts[CAPTURE_INDEX_AUTOTEST_REJECTED] + 320], signal, 80*sizeof(float complex));
+    capture_index_autotest_write(x, num_samples);
+    q = wlancapture_open(CAPTURE_INDEX_AUTOTEST_FILENAME, LIQUID_WLAN_CAPTURE_AUTO, 0);
+    struct capture_index_autotest_s testdata_all = {starts, CAPTURE_INDEX_AUTOTEST_NUM_FRAMES, 0, 1};
+    num_frames = wlancapture_decode_index(q, CAPTURE_INDEX_AUTOTEST_INDEX, callback, (void*)&testdata_all);
+    capture_index_autotest_check(&testdata_all, num_frames, "index, SIGNAL restored");
+
+    // re-decode with synchronizer configured off-channel: no frames
+    unsigned int num_calls = 0;
+    wlancapture_set_config(q, capture_index_autotest_config, (void*)&num_calls);
+    num_frames = wlancapture_decode_index(q, CAPTURE_INDEX_AUTOTEST_INDEX, callback, (void*)&testdata_all);
+    if (num_calls != 1 || num_frames != 0) {
+        fprintf(stderr,"fail: %s, configuration not applied (%u calls, %lu frames)\n", __FILE__,
+                num_calls, num_frames);
+        exit(1);
+    }
+    printf("  no frames received (index, off-channel)\n");
+    wlancapture_close(q);
+
+    remove(CAPTURE_INDEX_AUTOTEST_FILENAME);
+    remove(CAPTURE_INDEX_AUTOTEST_INDEX);
+    free(x);
+    return 0;
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+//
+// channelizer_autotest.c
+//
+// Test polyphase channelizer: channel selectivity with tones, and
+// reception of simultaneous frames on every channel of a wideband
+// capture, or on alternate channels with nothing leaking into the
+// channels between them
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <complex.h>
+
+#include "liquid-wlan.h"
+#include "autotest/autotest_frames.h"
+
+#define CHANNELIZER_AUTOTEST_M      (4)     // number of channels
+#define CHANNELIZER_AUTOTEST_CF     (0)     // complex float input
+#define CHANNELIZER_AUTOTEST_SC16   (1)     // interleaved int16 I/Q input
+
+// check that a tone at each channel center appears only in its channel
+void channelizer_autotest_tones(int _offset)
+{
+    unsigned int M = CHANNELIZER_AUTOTEST_M;
+    unsigned int n = 2048;
+    float complex x[n*M];
+    float complex y[M][n];
+    float complex * py[M];
+    unsigned int i, j, k;
+    for (j=0; j<M; j++)
+        py[j] = y[j];
+
+    for (k=0; k<M; k++) {
+        float fk = (float)(2*k + _offset) / (float)(2*M);
+        for (i=0; i<n*M; i++)
+            x[i] = cexpf(_Complex_I*2*M_PI*fk*i);
+
+        wlanchannelizer q = wlanchannelizer_create(M, 12, _offset);
+        wlanchannelizer_execute(q, x, n*M, py);
+        wlanchannelizer_destroy(q);
+
+        // measure after filter transient
+        for (j=0; j<M; j++) {
+            float e = 0.0f;
+            for (i=n/2; i<n; i++)
+                e += crealf(y[j][i]*conjf(y[j][i]));
+            e /= (float)(n/2);
+            if (j == k && fabsf(e - 1.0f) > 0.02f) {
+                fprintf(stderr,"fail: %s, channel %u passband gain %f\n", __FILE__, k, e);
+                exit(1);
+            } else if (j != k && e > 1e-4f) {
+                fprintf(stderr,"fail: %s, channel %u leaks %.1f dB into channel %u\n", __FILE__, k, 10*log10f(e), j);
+                exit(1);
+            }
+        }
+    }
+    printf("  channel selectivity (offset %d) ok\n", _offset);
+}
+
+// receive simultaneous frames on channels in _mask, and none on the
+// others
+void channelizer_autotest_frames(int          _offset,
+                                 unsigned int _format,
+                                 unsigned int _mask)
+{
+    unsigned int M = CHANNELIZER_AUTOTEST_M;
+    unsigned int num_lead = 1000;       // zeros before frames
+    unsigned int num_tail = 2000;       // zeros after frames
+    unsigned int block_len = 1001;      // input block size
+
+    // generate frames at M x 20 MHz, each mixed to its channel center
+    wlanframegen fg = wlanframegen_create_interp(M, 1);
+    unsigned char payload[4095];
+    struct wlan_txvector_s txvector;
+    float complex * x = NULL;
+    unsigned int num_samples = 0;
+    unsigned int i, k;
+    for (k=0; k<M; k++) {
+        if ( !((_mask >> k) & 1) )
+            continue;
+        autotest_frames_job(k, 0, 400, payload, &txvector);
+        wlanframegen_assemble(fg, payload, txvector);
+        unsigned int frame_len = wlanframegen_getframelen(fg);
+        unsigned int n = num_lead + frame_len + num_tail;
+        if (n > num_samples) {
+            x = (float complex*) realloc(x, n*sizeof(float complex));
+            memset(&x[num_samples], 0x00, (n-num_samples)*sizeof(float complex));
+            num_samples = n;
+        }
+        float complex frame[frame_len];
+        wlanframegen_write_frame(fg, frame);
+        float fk = (float)(2*k + _offset) / (float)(2*M);
+        for (i=0; i<frame_len; i++)
+            x[num_lead+i] += frame[i] * cexpf(_Complex_I*2*M_PI*fk*(num_lead+i));
+    }
+    wlanframegen_destroy(fg);
+
+    // quantize
+    int16_t * x_sc16 = (int16_t*) malloc(2*num_samples*sizeof(int16_t));
+    for (i=0; i<2*num_samples; i++) {
+        float v = 8192.0f * (i % 2 ? cimagf(x[i/2]) : crealf(x[i/2]));
+        x_sc16[i] = v > 32767.0f ? 32767 : (v < -32768.0f ? -32768 : (int16_t)lrintf(v));
+    }
+
+    // create channelizer and bind a synchronizer to each channel
+    wlanchannelizer q = wlanchannelizer_create(M, 12, _offset);
+    wlanframesync fs[M];
+    struct autotest_frames_s testdata[M];
+    for (k=0; k<M; k++) {
+        autotest_frames_init(&testdata[k], k, 400);
+        fs[k] = wlanframesync_create(autotest_frames_callback, (void*)&testdata[k]);
+        wlanchannelizer_set_sync(q, k, fs[k]);
+    }
+
+    for (i=0; i<num_samples; i+=block_len) {
+        unsigned int n = i + block_len < num_samples ? block_len : num_samples - i;
+        if (_format == CHANNELIZER_AUTOTEST_SC16)
+            wlanchannelizer_execute_sc16(q, &x_sc16[2*i], n, NULL);
+        else
+            wlanchannelizer_execute(q, &x[i], n, NULL);
+    }
+
+    // check results
+    for (k=0; k<M; k++) {
+        unsigned int num_expected = (_mask >> k) & 1;
+        if (!testdata[k].valid || testdata[k].num_frames != num_expected) {
+            fprintf(stderr,"fail: %s, channel %u received %u of %u frames (offset %d, format %u)\n",
+                    __FILE__, k, testdata[k].num_frames, num_expected, _offset, _format);
+            exit(1);
+        }
+        wlanframesync_destroy(fs[k]);
+    }
+    printf("  channels 0x%x received (offset %d, format %u)\n", _mask, _offset, _format);
+
+    wlanchannelizer_destroy(q);
+    free(x);
+    free(x_sc16);
+}
+
+int main() {
+    int offset;
+    for (offset=0; offset<2; offset++) {
+        channelizer_autotest_tones(offset);
+        channelizer_autotest_frames(offset, CHANNELIZER_AUTOTEST_CF,   0xf);
+        channelizer_autotest_frames(offset, CHANNELIZER_AUTOTEST_SC16, 0xf);
+        channelizer_autotest_frames(offset, CHANNELIZER_AUTOTEST_SC16, 0x5);
+        channelizer_autotest_frames(offset, CHANNELIZER_AUTOTEST_CF,   0xa);
+    }
+
+    return 0;
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// fec_thread_autotest.c
+//
+// Stress test running many Viterbi decoders concurrently, with
+// decoders on alternating threads using inverted polynomials; decoder
+// state must not be shared between instances
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "liquid-wlan.internal.h"
+
+#define FEC_THREAD_AUTOTEST_NUM_THREADS     (8)
+#define FEC_THREAD_AUTOTEST_NUM_TRIALS      (40)
+
+// thread: encode and decode messages, counting errors
+void * fec_thread_autotest_worker(void * _arg)
+{
+    unsigned int id = *(unsigned int*)_arg;
+    int inverted = id % 2;
+    unsigned int num_errors = 0;
+
+    unsigned int n = 64;                // message length (bytes)
+    unsigned char msg_org[n];
+    unsigned char msg_enc[2*n];
+    unsigned char msg_dec[n];
+    unsigned char soft[16*n + 12];
+
+    unsigned int t;
+    unsigned int i;
+    for (t=0; t<FEC_THREAD_AUTOTEST_NUM_TRIALS; t++) {
+        // message with zero tail
+        for (i=0; i<n; i++)
+            msg_org[i] = (i*31 + t*7 + id*101) & 0xff;
+        msg_org[n-1] = 0x00;
+
+        // encode using half-rate code and unpack to soft bits, inverting
+        // if decoder uses inverted polynomials
+        wlan_fec_encode(LIQUID_WLAN_FEC_R1_2, n, msg_org, msg_enc);
+        for (i=0; i<16*n; i++) {
+            unsigned char bit = (msg_enc[i/8] >> (7-(i%8))) & 1;
+            soft[i] = (bit ^ inverted) ? LIQUID_WLAN_SOFTBIT_1 : LIQUID_WLAN_SOFTBIT_0;
+        }
+        memset(&soft[16*n], inverted ? LIQUID_WLAN_SOFTBIT_1 : LIQUID_WLAN_SOFTBIT_0, 12);
+
+        // decode
+        void * vp = wlan_create_viterbi27(8*n);
+        if (inverted) {
+            int polys[2] = {-V27POLYA, -V27POLYB};
+            wlan_set_viterbi27_polynomial(vp, polys);
+        }
+        wlan_init_viterbi27(vp,0);
+        wlan_update_viterbi27_blk(vp, soft, 8*n);
+        wlan_chainback_viterbi27(vp, msg_dec, 8*n-6, 0);
+        wlan_delete_viterbi27(vp);
+        num_errors += count_bit_errors_array(msg_org, msg_dec, n-1);
+
+        // full packet decoding path at varying rates
+        unsigned int rate = (t + id) % 8;
+        unsigned int length = 96;
+        unsigned int enc_msg_len = wlan_packet_compute_enc_msg_len(rate, length);
+        unsigned char payload[length];
+        unsigned char payload_enc[enc_msg_len];
+        unsigned char payload_soft[8*enc_msg_len];
+        unsigned char payload_dec[length];
+        for (i=0; i<length; i++)
+            payload[i] = (i*13 + t + id) & 0xff;
+        wlan_packet_encode(rate, 0x5d, length, payload, payload_enc);
+        for (i=0; i<8*enc_msg_len; i++)
+            payload_soft[i] = (payload_enc[i/8] >> (7-(i%8))) & 1 ? LIQUID_WLAN_SOFTBIT_1 : LIQUID_WLAN_SOFTBIT_0;
+        wlan_packet_decode_soft(rate, 0x5d, length, payload_soft, payload_dec);
+        num_errors += count_bit_errors_array(payload, payload_dec, length);
+    }
+
+    *(unsigned int*)_arg = num_errors;
+    return NULL;
+}
+
+int main() {
+    pthread_t threads[FEC_THREAD_AUTOTEST_NUM_THREADS];
+    unsigned int results[FEC_THREAD_AUTOTEST_NUM_THREADS];
+
+    // start threads; each result is initialized with thread id
+    unsigned int i;
+    for (i=0; i<FEC_THREAD_AUTOTEST_NUM_THREADS; i++) {
+        results[i] = i;
+        if (pthread_create(&threads[i], NULL, fec_thread_autotest_worker, &results[i]) != 0) {
+            fprintf(stderr,"error: %s, could not create thread\n", __FILE__);
+            exit(1);
+        }
+    }
+
+    // join threads and accumulate errors
+    unsigned int num_errors = 0;
+    for (i=0; i<FEC_THREAD_AUTOTEST_NUM_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        printf("  thread %u : %u bit errors\n", i, results[i]);
+        num_errors += results[i];
+    }
+
+    if (num_errors > 0) {
+        fprintf(stderr,"fail: %s, concurrent decoding failure\n", __FILE__);
+        exit(1);
+    }
+
+    return 0;
+}
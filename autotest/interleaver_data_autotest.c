@@ -88,6 +88,41 @@ int main(int argc, char*argv[])
         exit(1);
     }
 
+    //
+    // compare against structured table for all rates
+    //
+    unsigned int num_errors = 0;
+    for (rate=0; rate<8; rate++) {
+        ncbps = wlanframe_ratetab[rate].ncbps;
+        n = ncbps / 8;
+        unsigned char msg[n];
+        unsigned char msg_int[n];
+        unsigned char msg_int_tab[n];
+        unsigned char msg_deint[n];
+        unsigned char msg_deint_tab[n];
+
+        unsigned int t;
+        for (t=0; t<100; t++) {
+            for (i=0; i<n; i++)
+                msg[i] = rand() & 0xff;
+
+            wlan_interleaver_encode_symbol(rate, msg, msg_int);
+            wlan_interleaver_encode_symbol_tab(rate, msg, msg_int_tab);
+            wlan_interleaver_decode_symbol(rate, msg_int, msg_deint);
+            wlan_interleaver_decode_symbol_tab(rate, msg_int, msg_deint_tab);
+
+            num_errors += count_bit_errors_array(msg_int,   msg_int_tab,   n);
+            num_errors += count_bit_errors_array(msg_deint, msg_deint_tab, n);
+            num_errors += count_bit_errors_array(msg_deint, msg,           n);
+        }
+    }
+    printf("all rates errors : %3u\n", num_errors);
+
+    if (num_errors > 0) {
+        fprintf(stderr,"fail: %s, structured table mismatch\n", __FILE__);
+        exit(1);
+    }
+
     return 0;
 }
 
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// interleaver_soft_autotest.c
+//
+// Test soft-bit de-interleaver against hard de-interleaver with
+// de-puncturing, and decode packets through Viterbi decoder
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "liquid-wlan.internal.h"
+
+// compare soft de-interleaver against structured table and puncturing
+// matrix for a single OFDM symbol
+int interleaver_soft_symbol_runtest(unsigned int _rate)
+{
+    unsigned int ncbps = wlanframe_ratetab[_rate].ncbps;
+    unsigned int ndbps = wlanframe_ratetab[_rate].ndbps;
+    unsigned int fec_scheme = wlanframe_ratetab[_rate].fec_scheme;
+    int punctured                 = wlanconv_fectab[fec_scheme].punctured;
+    unsigned int P                = wlanconv_fectab[fec_scheme].P;
+    const unsigned char * pmatrix = wlanconv_fectab[fec_scheme].pmatrix;
+
+    unsigned char msg_enc[ncbps/8];
+    unsigned char msg_dec[ncbps/8];
+    unsigned char soft_enc[ncbps];
+    unsigned char soft_dec[2*ndbps];
+    unsigned char soft_ref[2*ndbps];
+
+    // random interleaved symbol
+    unsigned int i;
+    unsigned int r;
+    for (i=0; i<ncbps/8; i++)
+        msg_enc[i] = rand() & 0xff;
+    for (i=0; i<ncbps; i++)
+        soft_enc[i] = (msg_enc[i/8] >> (7-(i%8))) & 1 ? LIQUID_WLAN_SOFTBIT_1 : LIQUID_WLAN_SOFTBIT_0;
+
+    // reference: de-interleave hard bits, then insert erasures
+    wlan_interleaver_decode_symbol_tab(_rate, msg_enc, msg_dec);
+    unsigned int n = 0;
+    for (i=0; i<ndbps; i++) {
+        for (r=0; r<2; r++) {
+            if (!punctured || pmatrix[r*P + (i%P)]) {
+                soft_ref[2*i+r] = (msg_dec[n/8] >> (7-(n%8))) & 1 ? LIQUID_WLAN_SOFTBIT_1 : LIQUID_WLAN_SOFTBIT_0;
+                n++;
+            } else {
+                soft_ref[2*i+r] = LIQUID_WLAN_SOFTBIT_ERASURE;
+            }
+        }
+    }
+
+    wlan_interleaver_decode_symbol_soft(_rate, soft_enc, soft_dec);
+
+    unsigned int num_errors = 0;
+    for (i=0; i<2*ndbps; i++)
+        num_errors += soft_dec[i] == soft_ref[i] ? 0 : 1;
+    return num_errors;
+}
+
+// encode packet, convert to soft bits with erasures, and decode
+int interleaver_soft_packet_runtest(unsigned int _rate,
+                                    unsigned int _length)
+{
+    unsigned int enc_msg_len = wlan_packet_compute_enc_msg_len(_rate, _length);
+    unsigned int seed = 0x5d;
+
+    unsigned char msg_org[_length];
+    unsigned char msg_enc[enc_msg_len];
+    unsigned char soft_enc[8*enc_msg_len];
+    unsigned char msg_dec[_length];
+
+    unsigned int i;
+    for (i=0; i<_length; i++)
+        msg_org[i] = rand() & 0xff;
+
+    wlan_packet_encode(_rate, seed, _length, msg_org, msg_enc);
+
+    // unpack to soft bits, erasing one of every 16 bits
+    for (i=0; i<8*enc_msg_len; i++) {
+        if ((i%16) == 5)
+            soft_enc[i] = LIQUID_WLAN_SOFTBIT_ERASURE;
+        else
+            soft_enc[i] = (msg_enc[i/8] >> (7-(i%8))) & 1 ? 224 : 32;
+    }
+
+    wlan_packet_decode_soft(_rate, seed, _length, soft_enc, msg_dec);
+
+    return count_bit_errors_array(msg_org, msg_dec, _length);
+}
+
+int main() {
+    unsigned int rate;
+    unsigned int t;
+    for (rate=0; rate<8; rate++) {
+        unsigned int num_errors = 0;
+        for (t=0; t<20; t++)
+            num_errors += interleaver_soft_symbol_runtest(rate);
+        printf("  soft de-interleaver (%2u M bits/s) : %u errors\n",
+                wlanframe_ratetab[rate].rate, num_errors);
+        if (num_errors > 0) {
+            fprintf(stderr,"fail: %s, soft de-interleaver failure\n", __FILE__);
+            exit(1);
+        }
+
+        // NOTE: length chosen so that 9 M bits/s packet has an integer
+        //       number of data bytes (ndbps=36 is not a multiple of 8)
+        num_errors = interleaver_soft_packet_runtest(rate, 96);
+        printf("  soft packet decoder (%2u M bits/s) : %u bit errors\n",
+                wlanframe_ratetab[rate].rate, num_errors);
+        if (num_errors > 0) {
+            fprintf(stderr,"fail: %s, soft packet decoder failure\n", __FILE__);
+            exit(1);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// packet_codec_autotest.c
+//
+// Test rate-specialized packet codecs against the generic encoder, and
+// hard/soft decoding round trips at every rate
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "liquid-wlan.internal.h"
+
+// reference encoder: assemble data (prepend SERVICE bits, etc.),
+// scramble, encode the whole message and interleave symbol by symbol
+// using generic table look-ups; ndbps must be divisible by 8, which
+// excludes rate 9
+void packet_codec_encode_generic(unsigned int    _rate,
+                                 unsigned int    _seed,
+                                 unsigned int    _length,
+                                 unsigned char * _msg_dec,
+                                 unsigned char * _msg_enc)
+{
+    unsigned int ndbps = wlanframe_ratetab[_rate].ndbps;
+    unsigned int ncbps = wlanframe_ratetab[_rate].ncbps;
+    unsigned int nsym  = (16 + 8*_length + 6 + ndbps - 1) / ndbps;
+    unsigned int dec_msg_len = (nsym * ndbps) / 8;
+    unsigned int enc_msg_len = (nsym * ncbps) / 8;
+
+    // prepend SERVICE bits, reverse bytes and pad
+    unsigned char msg_org[dec_msg_len];
+    unsigned int i;
+    memset(msg_org, 0x00, dec_msg_len);
+    for (i=0; i<_length; i++)
+        msg_org[i+2] = liquid_wlan_reverse_byte[_msg_dec[i]];
+
+    // scramble, zeroing tail bits
+    unsigned char msg_scrambled[dec_msg_len];
+    wlan_data_scramble(msg_org, msg_scrambled, dec_msg_len, _seed);
+    msg_scrambled[_length+2] &= 0x03;
+
+    // encode and interleave
+    unsigned char msg_enc[enc_msg_len];
+    wlan_fec_encode(wlanframe_ratetab[_rate].fec_scheme, dec_msg_len, msg_scrambled, msg_enc);
+    for (i=0; i<nsym; i++)
+        wlan_interleaver_encode_symbol(_rate, &msg_enc[(i*ncbps)/8], &_msg_enc[(i*ncbps)/8]);
+}
+
+// run test with specific rate and payload length
+unsigned int packet_codec_runtest(unsigned int _rate,
+                                  unsigned int _length)
+{
+    unsigned int enc_msg_len = wlan_packet_compute_enc_msg_len(_rate, _length);
+    unsigned int ncbps = wlanframe_ratetab[_rate].ncbps;
+    unsigned int seed  = 1 + (rand() % 127);
+
+    unsigned char msg_org[_length];
+    unsigned char msg_enc[enc_msg_len];
+    unsigned char msg_ref[enc_msg_len];
+    unsigned char msg_dec[_length];
+    unsigned char soft[8*enc_msg_len];
+
+    unsigned int i;
+    for (i=0; i<_length; i++)
+        msg_org[i] = rand() & 0xff;
+
+    unsigned int num_errors = 0;
+    wlan_packet_encode(_rate, seed, _length, msg_org, msg_enc);
+
+    // number of encoded bytes must fill whole symbols
+    num_errors += (8*enc_msg_len) % ncbps == 0 ? 0 : 1;
+
+    // generic encoder requires ndbps divisible by 8
+    if (_rate != WLANFRAME_RATE_9) {
+        packet_codec_encode_generic(_rate, seed, _length, msg_org, msg_ref);
+        num_errors += memcmp(msg_enc, msg_ref, enc_msg_len) == 0 ? 0 : 1;
+    }
+
+    // hard-decision round trip
+    wlan_packet_decode(_rate, seed, _length, msg_enc, msg_dec);
+    num_errors += memcmp(msg_dec, msg_org, _length) == 0 ? 0 : 1;
+
+    // soft-decision round trip
+    for (i=0; i<8*enc_msg_len; i++)
+        soft[i] = (msg_enc[i/8] >> (7-(i%8))) & 0x01 ? LIQUID_WLAN_SOFTBIT_1 : LIQUID_WLAN_SOFTBIT_0;
+    memset(msg_dec, 0x00, _length);
+    wlan_packet_decode_soft(_rate, seed, _length, soft, msg_dec);
+    num_errors += memcmp(msg_dec, msg_org, _length) == 0 ? 0 : 1;
+
+    return num_errors;
+}
+
+int main() {
+    // run all rates with lengths covering odd and even symbol counts
+    unsigned int rate;
+    unsigned int length;
+    for (rate=0; rate<8; rate++) {
+        unsigned int num_errors = 0;
+        for (length=1; length<=120; length++)
+            num_errors += packet_codec_runtest(rate, length);
+        num_errors += packet_codec_runtest(rate, 1500);
+
+        printf("  packet codec (%2u M bits/s) : %u errors\n", wlanframe_ratetab[rate].rate, num_errors);
+        if (num_errors > 0) {
+            fprintf(stderr,"fail: %s, packet codec failure at %u M bits/s\n", __FILE__, wlanframe_ratetab[rate].rate);
+            exit(1);
+        }
+    }
+
+    return 0;
+}
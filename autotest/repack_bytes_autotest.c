@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// repack_bytes_autotest.c
+//
+// Test dedicated byte packing/unpacking kernels against generic
+// bit-wise repacking
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "liquid-wlan.internal.h"
+
+// run test with specific symbol size and input length
+int repack_bytes_runtest(unsigned int _bps,
+                         unsigned int _num_bytes)
+{
+    // packing symbols back may require one additional (padded) byte
+    unsigned int num_symbols = (8*_num_bytes + _bps - 1) / _bps;
+    unsigned int num_packed  = (_bps*num_symbols + 7) / 8;
+    unsigned char msg[_num_bytes];
+    unsigned char msg_test[num_packed];
+    unsigned char msg_ref[num_packed];
+    unsigned char sym[num_symbols];
+    unsigned char sym_test[num_symbols];
+    unsigned char sym_ref[num_symbols];
+
+    unsigned int i;
+    for (i=0; i<_num_bytes; i++)
+        msg[i] = rand() & 0xff;
+
+    // unpack bytes into symbols
+    unsigned int n_test;
+    unsigned int n_ref;
+    unsigned int num_errors = 0;
+    liquid_wlan_repack_bytes(msg, 8, _num_bytes, sym_test, _bps, num_symbols, &n_test);
+    liquid_wlan_repack_bytes_generic(msg, 8, _num_bytes, sym_ref, _bps, num_symbols, &n_ref);
+    num_errors += n_test == n_ref ? 0 : 1;
+    num_errors += memcmp(sym_test, sym_ref, n_ref) == 0 ? 0 : 1;
+
+    // pack random symbols (including unused upper bits) into bytes
+    for (i=0; i<num_symbols; i++)
+        sym[i] = rand() & 0xff;
+    liquid_wlan_repack_bytes(sym, _bps, num_symbols, msg_test, 8, num_packed, &n_test);
+    liquid_wlan_repack_bytes_generic(sym, _bps, num_symbols, msg_ref, 8, num_packed, &n_ref);
+    num_errors += n_test == n_ref && n_ref == num_packed ? 0 : 1;
+    num_errors += memcmp(msg_test, msg_ref, n_ref) == 0 ? 0 : 1;
+
+    // round trip
+    liquid_wlan_repack_bytes(sym_ref, _bps, num_symbols, msg_test, 8, num_packed, &n_test);
+    num_errors += memcmp(msg_test, msg, _num_bytes) == 0 ? 0 : 1;
+
+    return num_errors;
+}
+
+int main() {
+    unsigned int bps[4] = {1, 2, 4, 6};
+
+    // run tests over all symbol sizes and lengths covering partial groups
+    unsigned int i;
+    unsigned int n;
+    for (i=0; i<4; i++) {
+        unsigned int num_errors = 0;
+        for (n=1; n<=64; n++)
+            num_errors += repack_bytes_runtest(bps[i], n);
+
+        printf("  repack bytes (%u bits/symbol) : %u errors\n", bps[i], num_errors);
+        if (num_errors > 0) {
+            fprintf(stderr,"fail: %s, %u-bit repacking failure\n", __FILE__, bps[i]);
+            exit(1);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+//
+// synthesizer_autotest.c
+//
+// Test polyphase synthesizer: placement of tones at channel centers,
+// and reception of simultaneous frames through the channelizer, on
+// every channel or on some with the others idle (no input)
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <complex.h>
+
+#include "liquid-wlan.h"
+#include "autotest/autotest_frames.h"
+
+#define SYNTHESIZER_AUTOTEST_M      (4)     // number of channels
+
+// check that a constant input on each channel becomes a unit tone at
+// the channel center
+void synthesizer_autotest_tones(int _offset)
+{
+    unsigned int M = SYNTHESIZER_AUTOTEST_M;
+    unsigned int n = 512;
+    float complex x[n];
+    float complex y[n*M];
+    float complex * px[M];
+    unsigned int i, j, k;
+    for (i=0; i<n; i++)
+        x[i] = 1.0f;
+
+    for (k=0; k<M; k++) {
+        for (j=0; j<M; j++)
+            px[j] = j == k ? x : NULL;
+
+        wlansynthesizer q = wlansynthesizer_create(M, 12, _offset);
+        wlansynthesizer_execute(q, px, n, y);
+        wlansynthesizer_destroy(q);
+
+        // correlate with tone after filter transient
+        float fk = (float)(2*k + _offset) / (float)(2*M);
+        float complex r = 0.0f;
+        float e = 0.0f;
+        for (i=n*M/2; i<n*M; i++) {
+            r += y[i] * cexpf(-_Complex_I*2*M_PI*fk*i);
+            e += crealf(y[i]*conjf(y[i]));
+        }
+        r /= (float)(n*M/2);
+        e /= (float)(n*M/2);
+        if (fabsf(cabsf(r) - 1.0f) > 0.01f || fabsf(e - cabsf(r)*cabsf(r)) > 1e-3f) {
+            fprintf(stderr,"fail: %s, channel %u tone amplitude %f, power %f\n", __FILE__, k, cabsf(r), e);
+            exit(1);
+        }
+    }
+    printf("  channel placement (offset %d) ok\n", _offset);
+}
+
+// synthesize simultaneous frames on channels in _mask, leaving the
+// others idle, and receive them through the channelizer
+void synthesizer_autotest_frames(int          _offset,
+                                 unsigned int _mask)
+{
+    unsigned int M = SYNTHESIZER_AUTOTEST_M;
+    unsigned int num_tail  = 500;       // zeros after frames
+    unsigned int block_len = 173;       // synthesizer input block size
+
+    // generate a frame for each channel, padded to a common length
+    wlanframegen fg = wlanframegen_create();
+    unsigned char payload[4095];
+    struct wlan_txvector_s txvector;
+    float complex * x[M];
+    unsigned int frame_len[M];
+    unsigned int num_samples = 0;
+    unsigned int i, k;
+    for (k=0; k<M; k++) {
+        autotest_frames_job(k, 0, 400, payload, &txvector);
+        wlanframegen_assemble(fg, payload, txvector);
+        frame_len[k] = wlanframegen_getframelen(fg);
+        x[k] = (float complex*) malloc(frame_len[k]*sizeof(float complex));
+        wlanframegen_write_frame(fg, x[k]);
+        if (frame_len[k] + num_tail > num_samples)
+            num_samples = frame_len[k] + num_tail;
+    }
+    wlanframegen_destroy(fg);
+    for (k=0; k<M; k++) {
+        x[k] = (float complex*) realloc(x[k], num_samples*sizeof(float complex));
+        memset(&x[k][frame_len[k]], 0x00, (num_samples - frame_len[k])*sizeof(float complex));
+    }
+
+    // synthesize wideband stream
+    wlansynthesizer q = wlansynthesizer_create(M, 12, _offset);
+    float complex * y = (float complex*) malloc(M*num_samples*sizeof(float complex));
+    float complex * px[M];
+    for (i=0; i<num_samples; i+=block_len) {
+        for (k=0; k<M; k++)
+            px[k] = (_mask >> k) & 1 ? &x[k][i] : NULL;
+        unsigned int n = i + block_len < num_samples ? block_len : num_samples - i;
+        wlansynthesizer_execute(q, px, n, &y[M*i]);
+    }
+    wlansynthesizer_destroy(q);
+
+    // receive each channel
+    wlanchannelizer c = wlanchannelizer_create(M, 12, _offset);
+    wlanframesync fs[M];
+    struct autotest_frames_s testdata[M];
+    for (k=0; k<M; k++) {
+        autotest_frames_init(&testdata[k], k, 400);
+        fs[k] = wlanframesync_create(autotest_frames_callback, (void*)&testdata[k]);
+        wlanchannelizer_set_sync(c, k, fs[k]);
+    }
+    wlanchannelizer_execute(c, y, M*num_samples, NULL);
+
+    // check results
+    for (k=0; k<M; k++) {
+        unsigned int num_expected = (_mask >> k) & 1;
+        if (!testdata[k].valid || testdata[k].num_frames != num_expected) {
+            fprintf(stderr,"fail: %s, channel %u received %u of %u frames (offset %d)\n",
+                    __FILE__, k, testdata[k].num_frames, num_expected, _offset);
+            exit(1);
+        }
+        wlanframesync_destroy(fs[k]);
+        free(x[k]);
+    }
+    printf("  channels 0x%x received (offset %d)\n", _mask, _offset);
+
+    wlanchannelizer_destroy(c);
+    free(y);
+}
+
+int main() {
+    int offset;
+    for (offset=0; offset<2; offset++) {
+        synthesizer_autotest_tones(offset);
+        synthesizer_autotest_frames(offset, 0xf);
+        synthesizer_autotest_frames(offset, 0x9);
+    }
+
+    return 0;
+}
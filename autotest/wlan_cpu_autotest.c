@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlan_cpu_autotest.c
+//
+// Test every kernel available on the host against the portable
+// implementation, and the environment override of the feature level
+// and pext/pdep kernels
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "liquid-wlan.internal.h"
+
+// uniform random byte
+#define RANDB() (rand() & 0xff)
+
+// compare block mapper/demapper
+unsigned int wlan_cpu_test_modem(const struct wlan_cpu_s * _q,
+                                 const struct wlan_cpu_s * _ref)
+{
+    const float complex * table[3] = {wlan_modem_qpsk, wlan_modem_qam16, wlan_modem_qam64};
+    unsigned int mask[3]  = {0x03, 0x0f, 0x3f};
+    unsigned int nbits[3] = {1, 2, 3};
+    const float t[2] = {0.6172134f, 0.3086067f};
+
+    unsigned int num_errors = 0;
+    unsigned int i;
+    unsigned int n;
+    for (i=0; i<3; i++) {
+        for (n=1; n<=37; n++) {
+            unsigned char sym[n];
+            unsigned char sym_test[n];
+            unsigned char sym_ref[n];
+            float complex x_test[n];
+            float complex x_ref[n];
+            unsigned int j;
+            for (j=0; j<n; j++)
+                sym[j] = RANDB();
+
+            _q->modulate_block(table[i], mask[i], sym, n, x_test);
+            _ref->modulate_block(table[i], mask[i], sym, n, x_ref);
+            num_errors += memcmp(x_test, x_ref, sizeof(x_ref)) == 0 ? 0 : 1;
+
+            // perturb samples, then demodulate
+            for (j=0; j<n; j++)
+                x_ref[j] += 0.5f*((float)RANDB()/255.0f - 0.5f) + 0.5f*((float)RANDB()/255.0f - 0.5f)*_Complex_I;
+            _q->demodulate_block(t, nbits[i], x_ref, n, sym_test);
+            _ref->demodulate_block(t, nbits[i], x_ref, n, sym_ref);
+            num_errors += memcmp(sym_test, sym_ref, n) == 0 ? 0 : 1;
+        }
+    }
+    return num_errors;
+}
+
+// compare hard-bit interleaver and soft-bit de-interleaver
+unsigned int wlan_cpu_test_interleaver(const struct wlan_cpu_s * _q,
+                                       const struct wlan_cpu_s * _ref)
+{
+    unsigned int num_errors = 0;
+    unsigned int rate;
+    for (rate=0; rate<8; rate++) {
+        unsigned int ncbps = wlanframe_ratetab[rate].ncbps;
+        unsigned int ndbps = wlanframe_ratetab[rate].ndbps;
+        unsigned char msg[36];
+        unsigned char msg_test[36];
+        unsigned char msg_ref[36];
+        unsigned int i;
+        for (i=0; i<ncbps/8; i++)
+            msg[i] = RANDB();
+
+        _q->interleaver_encode_symbol(rate, msg, msg_test);
+        _ref->interleaver_encode_symbol(rate, msg, msg_ref);
+        num_errors += memcmp(msg_test, msg_ref, ncbps/8) == 0 ? 0 : 1;
+
+        _q->interleaver_decode_symbol(rate, msg, msg_test);
+        _ref->interleaver_decode_symbol(rate, msg, msg_ref);
+        num_errors += memcmp(msg_test, msg_ref, ncbps/8) == 0 ? 0 : 1;
+
+        // soft bits with erasure appended
+        unsigned char buf[288+4];
+        unsigned char soft_test[432];
+        unsigned char soft_ref[432];
+        for (i=0; i<ncbps; i++)
+            buf[i] = RANDB();
+        buf[ncbps] = LIQUID_WLAN_SOFTBIT_ERASURE;
+        _q->interleaver_gather_soft(wlan_intlv_soft_gentab[rate], buf, 2*ndbps, soft_test);
+        _ref->interleaver_gather_soft(wlan_intlv_soft_gentab[rate], buf, 2*ndbps, soft_ref);
+        num_errors += memcmp(soft_test, soft_ref, 2*ndbps) == 0 ? 0 : 1;
+    }
+    return num_errors;
+}
+
+// compare scrambler key stream application over several periods
+unsigned int wlan_cpu_test_scrambler(const struct wlan_cpu_s * _q,
+                                     const struct wlan_cpu_s * _ref)
+{
+    unsigned char ks[WLAN_DATA_SCRAMBLER_PERIOD+32];
+    unsigned int i;
+    for (i=0; i<WLAN_DATA_SCRAMBLER_PERIOD; i++)
+        ks[i] = RANDB();
+    memmove(&ks[WLAN_DATA_SCRAMBLER_PERIOD], ks, 32);
+
+    unsigned int num_errors = 0;
+    unsigned int n;
+    for (n=1; n<=600; n+=7) {
+        unsigned char x[n];
+        unsigned char y_test[n];
+        unsigned char y_ref[n];
+        for (i=0; i<n; i++)
+            x[i] = RANDB();
+        _q->data_scramble_xor(ks, x, n, y_test);
+        _ref->data_scramble_xor(ks, x, n, y_ref);
+        num_errors += memcmp(y_test, y_ref, n) == 0 ? 0 : 1;
+    }
+    return num_errors;
+}
+
+// compare byte pack/unpack
+unsigned int wlan_cpu_test_repack(const struct wlan_cpu_s * _q,
+                                  const struct wlan_cpu_s * _ref)
+{
+    unsigned int bps[4] = {1, 2, 4, 6};
+    unsigned int num_errors = 0;
+    unsigned int i;
+    unsigned int n;
+    for (i=0; i<4; i++) {
+        for (n=1; n<=40; n++) {
+            unsigned int num_symbols = (8*n + bps[i] - 1) / bps[i];
+            unsigned char msg[n];
+            unsigned char sym_test[num_symbols];
+            unsigned char sym_ref[num_symbols];
+            unsigned int j;
+            for (j=0; j<n; j++)
+                msg[j] = RANDB();
+
+            num_errors += _q->unpack_bytes(msg, n, sym_test, bps[i]) ==
+                          _ref->unpack_bytes(msg, n, sym_ref, bps[i]) ? 0 : 1;
+            num_errors += memcmp(sym_test, sym_ref, num_symbols) == 0 ? 0 : 1;
+
+            // pack random symbols (including unused upper bits)
+            unsigned int num_packed = (bps[i]*num_symbols + 7) / 8;
+            unsigned char msg_test[num_packed];
+            unsigned char msg_ref[num_packed];
+            for (j=0; j<num_symbols; j++)
+                sym_test[j] = RANDB();
+            num_errors += _q->pack_bytes(sym_test, num_symbols, msg_test, bps[i]) ==
+                          _ref->pack_bytes(sym_test, num_symbols, msg_ref, bps[i]) ? 0 : 1;
+            num_errors += memcmp(msg_test, msg_ref, num_packed) == 0 ? 0 : 1;
+        }
+    }
+    return num_errors;
+}
+
+// decode noisy r1/2 code with Viterbi implementation, returning number
+// of decoded byte errors
+unsigned int wlan_cpu_test_viterbi27(unsigned int _impl)
+{
+    unsigned int n = 64;    // message length (bytes), last byte is tail
+    unsigned char msg[n];
+    unsigned char msg_enc[2*n];
+    unsigned char msg_dec[n];
+    unsigned char soft[16*n];
+
+    unsigned int num_errors = 0;
+    unsigned int t;
+    unsigned int i;
+    for (t=0; t<20; t++) {
+        for (i=0; i<n; i++)
+            msg[i] = i < n-1 ? RANDB() : 0;
+        wlan_fec_encode(LIQUID_WLAN_FEC_R1_2, n, msg, msg_enc);
+
+        // soft bits with Gaussian noise and a few erasures
+        for (i=0; i<16*n; i++) {
+            unsigned int bit = (msg_enc[i/8] >> (7-(i%8))) & 1;
+            float u1 = ((float)rand() + 1.0f) / ((float)RAND_MAX + 1.0f);
+            float u2 = (float)rand() / ((float)RAND_MAX + 1.0f);
+            float v  = (bit ? 255.0f : 0.0f) + 40.0f*sqrtf(-2.0f*logf(u1))*cosf(2.0f*M_PI*u2);
+            soft[i] = v < 0.0f ? 0 : (v > 255.0f ? 255 : (unsigned char)v);
+            if ((i % 29) == 0)
+                soft[i] = LIQUID_WLAN_SOFTBIT_ERASURE;
+        }
+
+        void * vp;
+#if LIQUID_WLAN_HAVE_SSE2
+        if (_impl == LIQUID_WLAN_CPU_SSE2) {
+            vp = wlan_create_viterbi27_sse2(8*n);
+            wlan_init_viterbi27_sse2(vp, 0);
+            wlan_update_viterbi27_blk_sse2(vp, soft, 8*n);
+            wlan_chainback_viterbi27_sse2(vp, msg_dec, 8*n-6, 0);
+            wlan_delete_viterbi27_sse2(vp);
+        } else
+#endif
+        {
+            vp = wlan_create_viterbi27_port(8*n);
+            wlan_init_viterbi27_port(vp, 0);
+            wlan_update_viterbi27_blk_port(vp, soft, 8*n);
+            wlan_chainback_viterbi27_port(vp, msg_dec, 8*n-6, 0);
+            wlan_delete_viterbi27_port(vp);
+        }
+
+        for (i=0; i<n-1; i++)
+            num_errors += msg_dec[i] == msg[i] ? 0 : 1;
+    }
+    return num_errors;
+}
+
+int main() {
+    // force portable kernels before the dispatch table is first used
+    setenv("LIQUID_WLAN_CPU", "generic", 1);
+    if (liquid_wlan_cpu_get_level() != LIQUID_WLAN_CPU_GENERIC ||
+        strcmp(liquid_wlan_cpu_get_kernel("viterbi27"), "port") != 0 ||
+        strcmp(liquid_wlan_cpu_get_kernel("repack"), "generic") != 0 ||
+        liquid_wlan_cpu_get_kernel("unknown") != NULL)
+    {
+        fprintf(stderr,"fail: %s, environment override not applied\n", __FILE__);
+        exit(1);
+    }
+
+    // override list lowers level and disables pext/pdep kernels
+    unsigned int level_test = LIQUID_WLAN_CPU_AVX2;
+    int pdep_test = 1;
+    wlan_cpu_override("avx2,nopdep", &level_test, &pdep_test);
+    if (level_test != LIQUID_WLAN_CPU_AVX2 || pdep_test != 0) {
+        fprintf(stderr,"fail: %s, 'nopdep' override not applied\n", __FILE__);
+        exit(1);
+    }
+    pdep_test = 1;
+    wlan_cpu_override("sse2", &level_test, &pdep_test);
+    wlan_cpu_override("avx2", &level_test, &pdep_test);
+    if (level_test != LIQUID_WLAN_CPU_SSE2 || pdep_test != 1) {
+        fprintf(stderr,"fail: %s, level override not applied\n", __FILE__);
+        exit(1);
+    }
+
+    // AVX2 level without pext/pdep keeps table and shift kernels
+    struct wlan_cpu_s q_nopdep;
+    wlan_cpu_init(&q_nopdep, LIQUID_WLAN_CPU_AVX2, 0);
+    if (q_nopdep.pdep != 0 ||
+        strcmp(q_nopdep.impl[WLAN_CPU_KERNEL_INTERLEAVER], "tab") != 0 ||
+        strcmp(q_nopdep.impl[WLAN_CPU_KERNEL_REPACK], "generic") != 0)
+    {
+        fprintf(stderr,"fail: %s, pext/pdep kernels selected when disabled\n", __FILE__);
+        exit(1);
+    }
+
+    // run every level supported by host, with and without pext/pdep
+    // kernels, against portable kernels
+    struct wlan_cpu_s ref;
+    wlan_cpu_init(&ref, LIQUID_WLAN_CPU_GENERIC, 0);
+    unsigned int level_detected = wlan_cpu_detect();
+    unsigned int level;
+    int pdep;
+    for (level=0; level<=level_detected; level++) {
+        for (pdep=0; pdep<(level == LIQUID_WLAN_CPU_AVX2 ? 2 : 1); pdep++) {
+            struct wlan_cpu_s q;
+            wlan_cpu_init(&q, level, pdep);
+
+            unsigned int num_errors[5];
+            num_errors[0] = wlan_cpu_test_modem(&q, &ref);
+            num_errors[1] = wlan_cpu_test_interleaver(&q, &ref);
+            num_errors[2] = wlan_cpu_test_scrambler(&q, &ref);
+            num_errors[3] = wlan_cpu_test_repack(&q, &ref);
+            num_errors[4] = wlan_cpu_test_viterbi27(q.viterbi27);
+
+            printf("  level %u, pdep %d : modem %u, interleaver %u, scrambler %u, repack %u, viterbi27 %u errors\n",
+                    level, q.pdep, num_errors[0], num_errors[1], num_errors[2], num_errors[3], num_errors[4]);
+            unsigned int i;
+            for (i=0; i<5; i++) {
+                if (num_errors[i] > 0) {
+                    fprintf(stderr,"fail: %s, kernel mismatch at level %u\n", __FILE__, level);
+                    exit(1);
+                }
+            }
+        }
+    }
+
+    return 0;
+}
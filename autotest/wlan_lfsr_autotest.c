@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlan_lfsr_autotest.c
+//
+// Test linear feedback shift register jump-ahead and pilot polarity
+// table
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "liquid-wlan.internal.h"
+
+int main() {
+    unsigned int num_errors = 0;
+    unsigned int i;
+    unsigned int n;
+
+    // compare jump against stepping, from initial and arbitrary states
+    wlan_lfsr ms0 = wlan_lfsr_create(7, 0x91, 0x7f);
+    wlan_lfsr ms1 = wlan_lfsr_create(7, 0x91, 0x7f);
+    for (n=0; n<400; n++) {
+        wlan_lfsr_reset(ms0);
+        wlan_lfsr_reset(ms1);
+        for (i=0; i<n; i++)
+            wlan_lfsr_advance(ms0);
+        wlan_lfsr_jump(ms1, n);
+        num_errors += ms0->v == ms1->v ? 0 : 1;
+
+        // continue from arbitrary state
+        for (i=0; i<n%37; i++)
+            wlan_lfsr_advance(ms0);
+        wlan_lfsr_jump(ms1, n%37);
+        num_errors += ms0->v == ms1->v ? 0 : 1;
+        num_errors += wlan_lfsr_advance(ms0) == wlan_lfsr_advance(ms1) ? 0 : 1;
+    }
+    printf("  lfsr jump : %u errors\n", num_errors);
+    if (num_errors > 0) {
+        fprintf(stderr,"fail: %s, jump-ahead failure\n", __FILE__);
+        exit(1);
+    }
+
+    // longer register, large jump
+    wlan_lfsr ms2 = wlan_lfsr_create(16, 0x1002d, 0x0001);
+    wlan_lfsr ms3 = wlan_lfsr_create(16, 0x1002d, 0x0001);
+    for (i=0; i<100000; i++)
+        wlan_lfsr_advance(ms2);
+    wlan_lfsr_jump(ms3, 100000);
+    if (ms2->v != ms3->v) {
+        fprintf(stderr,"fail: %s, large jump-ahead failure\n", __FILE__);
+        exit(1);
+    }
+
+    // pilot polarity table matches scrambler output over two periods
+    wlan_lfsr_reset(ms0);
+    for (i=0; i<2*WLANFRAME_PILOT_PERIOD; i++)
+        num_errors += wlanframe_pilot_polarity[i % WLANFRAME_PILOT_PERIOD] == wlan_lfsr_advance(ms0) ? 0 : 1;
+    printf("  pilot polarity : %u errors\n", num_errors);
+    if (num_errors > 0) {
+        fprintf(stderr,"fail: %s, pilot polarity table failure\n", __FILE__);
+        exit(1);
+    }
+
+    wlan_lfsr_destroy(ms0);
+    wlan_lfsr_destroy(ms1);
+    wlan_lfsr_destroy(ms2);
+    wlan_lfsr_destroy(ms3);
+    return 0;
+}
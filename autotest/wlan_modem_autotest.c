@@ -68,6 +68,42 @@ int wlan_modem_runtest(unsigned int _scheme)
     return num_errors;
 }
 
+// compare block modulation/demodulation against scalar methods
+int wlan_modem_block_runtest(unsigned int _scheme)
+{
+    // odd length to exercise remainder of vectorized loops
+    unsigned int n = 1003;
+    unsigned char sym[n];
+    unsigned char sym_block[n];
+    float complex x[n];
+    float complex x_block[n];
+
+    unsigned int i;
+    for (i=0; i<n; i++)
+        sym[i] = rand() & 0xff;
+
+    // modulate (only low bits of each symbol are used)
+    unsigned int num_errors = 0;
+    wlan_modulate_block(_scheme, sym, n, x_block);
+    for (i=0; i<n; i++)
+        num_errors += x_block[i] == wlan_modulate(_scheme, sym[i]) ? 0 : 1;
+
+    // demodulate noisy samples, including samples on decision boundaries
+    for (i=0; i<n; i++) {
+        x[i] = 1.5f*((float)rand()/(float)RAND_MAX - 0.5f) +
+               1.5f*((float)rand()/(float)RAND_MAX - 0.5f)*_Complex_I;
+    }
+    x[0] = 0.0f;
+    x[1] = 0.6324555f + 0.6172134f*_Complex_I;
+    x[2] = 0.3086067f - 0.6172134f*_Complex_I;
+    wlan_demodulate_block(_scheme, x, n, sym_block);
+    for (i=0; i<n; i++)
+        num_errors += sym_block[i] == wlan_demodulate(_scheme, x[i]) ? 0 : 1;
+
+    printf("  block modem (scheme %u) : %u errors\n", _scheme, num_errors);
+    return num_errors;
+}
+
 
 int main() {
     // run tests
@@ -101,6 +137,15 @@ int main() {
         exit(1);
     }
 
+    // block modems
+    unsigned int scheme;
+    for (scheme=WLAN_MODEM_BPSK; scheme<=WLAN_MODEM_QAM64; scheme++) {
+        if (wlan_modem_block_runtest(scheme) > 0) {
+            fprintf(stderr,"fail: %s, block modem failure\n", __FILE__);
+            exit(1);
+        }
+    }
+
     return 0;
 }
 
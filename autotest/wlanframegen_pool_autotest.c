@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+//
+// wlanframegen_pool_autotest.c
+//
+// Test multi-threaded frame generation pool against a single frame
+// generator, validating that frames are returned in submission order
+// whatever order the workers finish in, and that no more frames than
+// slots are ever in flight
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "liquid-wlan.h"
+#include "autotest/autotest_frames.h"
+
+// generate frames with pool and compare against reference generator
+//  _num_threads    :   number of worker threads
+//  _num_slots      :   number of slots in pool
+//  _num_frames     :   number of frames to generate
+void wlanframegen_pool_autotest(unsigned int _num_threads,
+                                unsigned int _num_slots,
+                                unsigned int _num_frames)
+{
+    // create frame generation pool and reference frame generator
+    wlanframegen_pool pool = wlanframegen_pool_create(_num_threads, _num_slots);
+    wlanframegen fg = wlanframegen_create();
+
+    unsigned char payload[4095];
+    struct wlan_txvector_s txvector;
+    unsigned int num_submitted = 0;
+    unsigned int num_read = 0;
+    unsigned int i;
+    while (num_read < _num_frames) {
+        // keep pool full, long and short frames interleaved so workers
+        // finish out of order
+        while (num_submitted < _num_frames && wlanframegen_pool_get_backlog(pool) < _num_slots) {
+            autotest_frames_job(0, num_submitted, 4095, payload, &txvector);
+            wlanframegen_pool_submit(pool, payload, txvector);
+            num_submitted++;
+        }
+        if (wlanframegen_pool_get_backlog(pool) != num_submitted - num_read) {
+            fprintf(stderr,"fail: %s, backlog %u, expected %u\n", __FILE__,
+                    wlanframegen_pool_get_backlog(pool), num_submitted - num_read);
+            exit(1);
+        }
+
+        // read next frame
+        unsigned int frame_len;
+        float complex * frame = wlanframegen_pool_read(pool, &frame_len);
+
+        // generate reference frame
+        autotest_frames_job(0, num_read, 4095, payload, &txvector);
+        wlanframegen_assemble(fg, payload, txvector);
+        unsigned int frame_len_ref = wlanframegen_getframelen(fg);
+        float complex * frame_ref = (float complex*) malloc(frame_len_ref*sizeof(float complex));
+        wlanframegen_write_frame(fg, frame_ref);
+
+        // compare
+        if (frame_len != frame_len_ref) {
+            fprintf(stderr,"fail: %s, frame %u length mismatch\n", __FILE__, num_read);
+            exit(1);
+        }
+        for (i=0; i<frame_len; i++) {
+            if (cabsf(frame[i] - frame_ref[i]) > 1e-6f) {
+                fprintf(stderr,"fail: %s, frame %u sample mismatch\n", __FILE__, num_read);
+                exit(1);
+            }
+        }
+        free(frame_ref);
+
+        // releasing frame frees its slot
+        wlanframegen_pool_release(pool);
+        num_read++;
+        if (wlanframegen_pool_get_backlog(pool) != num_submitted - num_read) {
+            fprintf(stderr,"fail: %s, slot not freed on release\n", __FILE__);
+            exit(1);
+        }
+    }
+    printf("  %u frames generated with %u threads, %u slots\n", _num_frames, _num_threads, _num_slots);
+
+    // destroy objects
+    wlanframegen_pool_destroy(pool);
+    wlanframegen_destroy(fg);
+}
+
+int main() {
+    wlanframegen_pool_autotest(3, 5, 60);   // more slots than threads
+    wlanframegen_pool_autotest(4, 2, 30);   // more threads than slots
+    wlanframegen_pool_autotest(2, 1, 10);   // one frame at a time
+
+    return 0;
+}
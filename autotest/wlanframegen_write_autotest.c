@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanframegen_write_autotest.c
+//
+// Test whole-frame and arbitrary-length sample writers against
+// symbol-by-symbol frame generation
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "liquid-wlan.h"
+
+#include "annex-g-data/G1.c"
+
+// run test with a specific rate, sample writer block size, and output
+// interpolation factor _P/_Q
+int wlanframegen_write_runtest(unsigned int _rate,
+                               unsigned int _block_len,
+                               unsigned int _P,
+                               unsigned int _Q)
+{
+    // options
+    unsigned char * msg_org = annexg_G1;
+    struct wlan_txvector_s txvector;
+    txvector.LENGTH      = 100;
+    txvector.DATARATE    = _rate;
+    txvector.SERVICE     = 0;
+    txvector.TXPWR_LEVEL = 0;
+
+    // create frame generator
+    wlanframegen fg = wlanframegen_create_interp(_P, _Q);
+
+    // generate reference frame symbol by symbol
+    wlanframegen_assemble(fg, msg_org, txvector);
+    unsigned int frame_len = wlanframegen_getframelen(fg);
+    float complex frame_ref[frame_len];
+    unsigned int n = 0;
+    int last_frame = 0;
+    while (!last_frame) {
+        if (n + 80*_P/_Q > frame_len) {
+            fprintf(stderr,"fail: %s, frame length mismatch\n", __FILE__);
+            exit(1);
+        }
+        last_frame = wlanframegen_writesymbol(fg, &frame_ref[n]);
+        n += 80*_P/_Q;
+    }
+    if (n != frame_len) {
+        fprintf(stderr,"fail: %s, frame length mismatch\n", __FILE__);
+        exit(1);
+    }
+
+    unsigned int i;
+    unsigned int num_errors = 0;
+
+    // generate entire frame at once
+    float complex frame[frame_len];
+    wlanframegen_assemble(fg, msg_org, txvector);
+    wlanframegen_write_frame(fg, frame);
+    for (i=0; i<frame_len; i++)
+        num_errors += cabsf(frame[i] - frame_ref[i]) < 1e-6f ? 0 : 1;
+
+    // generate frame in blocks of arbitrary length, padding last block
+    unsigned int num_blocks = (frame_len + _block_len - 1) / _block_len;
+    float complex buffer[num_blocks*_block_len];
+    wlanframegen_assemble(fg, msg_org, txvector);
+    for (i=0; i<num_blocks; i++) {
+        last_frame = wlanframegen_write_samples(fg, &buffer[i*_block_len], _block_len);
+        if (last_frame != (i == num_blocks-1)) {
+            fprintf(stderr,"fail: %s, unexpected frame completion flag\n", __FILE__);
+            exit(1);
+        }
+    }
+    for (i=0; i<num_blocks*_block_len; i++) {
+        float complex v = i < frame_len ? frame_ref[i] : 0.0f;
+        num_errors += cabsf(buffer[i] - v) < 1e-6f ? 0 : 1;
+    }
+
+    // generate int16 I/Q frame at full scale and in blocks at reduced
+    // transmit power (12 is out of range, treated as 8), comparing against
+    // scaled, rounded, saturated reference
+    int16_t frame_sc16[2*num_blocks*_block_len];
+    unsigned int txpwr;
+    for (txpwr=0; txpwr<=12; txpwr+=4) {
+        txvector.TXPWR_LEVEL = txpwr;
+        wlanframegen_assemble(fg, msg_org, txvector);
+        if (txpwr == 0) {
+            wlanframegen_write_frame_sc16(fg, frame_sc16);
+        } else {
+            for (i=0; i<num_blocks; i++)
+                wlanframegen_write_samples_sc16(fg, &frame_sc16[2*i*_block_len], _block_len);
+        }
+        unsigned int level = txpwr > 8 ? 8 : txpwr;
+        float scale = WLANFRAMEGEN_SC16_SCALE * powf(10.0f, -0.15f*(level > 1 ? level-1 : 0));
+        for (i=0; i<2*frame_len; i++) {
+            float v = (i % 2 ? cimagf(frame_ref[i/2]) : crealf(frame_ref[i/2])) * scale;
+            v = v >  32767.0f ?  32767.0f : v;
+            v = v < -32768.0f ? -32768.0f : v;
+            num_errors += fabsf((float)frame_sc16[i] - v) <= 0.5f ? 0 : 1;
+        }
+    }
+    txvector.TXPWR_LEVEL = 0;
+
+    // generate frames with cached payload waveform: the first frame fills
+    // the cache and subsequent frames re-use it
+    wlanframegen_payload_cache_enable(fg);
+    unsigned int k;
+    for (k=0; k<3; k++) {
+        wlanframegen_assemble(fg, msg_org, txvector);
+        if (k == 1) {
+            wlanframegen_write_frame(fg, frame);
+        } else {
+            for (i=0; i<num_blocks; i++)
+                wlanframegen_write_samples(fg, &buffer[i*_block_len], _block_len);
+            memmove(frame, buffer, frame_len*sizeof(float complex));
+        }
+        for (i=0; i<frame_len; i++)
+            num_errors += cabsf(frame[i] - frame_ref[i]) < 1e-6f ? 0 : 1;
+    }
+    wlanframegen_payload_cache_disable(fg);
+
+    printf("  rate %u, block len %4u, interp %u/%u : %u sample errors\n", _rate, _block_len, _P, _Q, num_errors);
+
+    // destroy objects
+    wlanframegen_destroy(fg);
+
+    return num_errors;
+}
+
+int main() {
+    unsigned int block_len[5] = {1, 37, 80, 333, 1000};
+    unsigned int rates[7] = {WLANFRAME_RATE_6,  WLANFRAME_RATE_12,
+                             WLANFRAME_RATE_18, WLANFRAME_RATE_24,
+                             WLANFRAME_RATE_36, WLANFRAME_RATE_48,
+                             WLANFRAME_RATE_54};
+
+    unsigned int interp[4][2] = {{1,1}, {2,1}, {4,1}, {3,2}};
+
+    unsigned int i;
+    unsigned int j;
+    unsigned int k;
+    for (k=0; k<4; k++) {
+        for (i=0; i<7; i++) {
+            for (j=0; j<5; j++) {
+                if (wlanframegen_write_runtest(rates[i], block_len[j], interp[k][0], interp[k][1]) > 0) {
+                    fprintf(stderr,"fail: %s, sample writer failure\n", __FILE__);
+                    exit(1);
+                }
+            }
+        }
+    }
+
+    return 0;
+}
@@ -48,8 +48,14 @@ void usage()
     printf("  r     : rate {6,9,12,18,24,36,48,54} M bits/s\n");
 }
 
-// run test with a specific rate
-int wlanframesync_runtest(unsigned int _rate);
+// input sample formats
+#define WLANFRAMESYNC_AUTOTEST_CF   (0) // complex float
+#define WLANFRAMESYNC_AUTOTEST_SC16 (1) // interleaved int16 I/Q
+#define WLANFRAMESYNC_AUTOTEST_SC8  (2) // interleaved int8 I/Q
+
+// run test with a specific rate and input sample format
+int wlanframesync_runtest(unsigned int _rate,
+                          unsigned int _format);
 
 // callback function
 static int callback(unsigned char *        _payload,
@@ -58,14 +64,17 @@ static int callback(unsigned char *        _payload,
 
 int main() {
     // run tests
-    wlanframesync_runtest(WLANFRAME_RATE_6);
-    //wlanframesync_runtest(WLANFRAME_RATE_9);
-    wlanframesync_runtest(WLANFRAME_RATE_12);
-    wlanframesync_runtest(WLANFRAME_RATE_18);
-    wlanframesync_runtest(WLANFRAME_RATE_24);
-    wlanframesync_runtest(WLANFRAME_RATE_36);
-    wlanframesync_runtest(WLANFRAME_RATE_48);
-    wlanframesync_runtest(WLANFRAME_RATE_54);
+    unsigned int format;
+    for (format=0; format<3; format++) {
+        wlanframesync_runtest(WLANFRAME_RATE_6,  format);
+        //wlanframesync_runtest(WLANFRAME_RATE_9,  format);
+        wlanframesync_runtest(WLANFRAME_RATE_12, format);
+        wlanframesync_runtest(WLANFRAME_RATE_18, format);
+        wlanframesync_runtest(WLANFRAME_RATE_24, format);
+        wlanframesync_runtest(WLANFRAME_RATE_36, format);
+        wlanframesync_runtest(WLANFRAME_RATE_48, format);
+        wlanframesync_runtest(WLANFRAME_RATE_54, format);
+    }
 
     return 0;
 }
@@ -79,7 +88,8 @@ struct wlanframesync_autotest_s {
     unsigned int valid;
 };
 
-int wlanframesync_runtest(unsigned int _rate)
+int wlanframesync_runtest(unsigned int _rate,
+                          unsigned int _format)
 {
     srand(time(NULL));
     
@@ -104,6 +114,9 @@ int wlanframesync_runtest(unsigned int _rate)
 
     // arrays
     float complex buffer[80];   // data buffer
+    int16_t buffer_sc16[160];   // data buffer (int16 I/Q)
+    int8_t  buffer_sc8[160];    // data buffer (int8 I/Q)
+    unsigned int i;
 
     // create frame generator
     wlanframegen fg = wlanframegen_create();
@@ -137,7 +150,10 @@ int wlanframesync_runtest(unsigned int _rate)
     int last_frame = 0;
     while (!last_frame) {
         // write symbol
-        last_frame = wlanframegen_writesymbol(fg, buffer);
+        if (_format == WLANFRAMESYNC_AUTOTEST_SC16)
+            last_frame = wlanframegen_writesymbol_sc16(fg, buffer_sc16);
+        else
+            last_frame = wlanframegen_writesymbol(fg, buffer);
 
 #if 0
         // push through channel (add noise, carrier offset)
@@ -150,7 +166,20 @@ int wlanframesync_runtest(unsigned int _rate)
 #endif
 
         // run through synchronize
-        wlanframesync_execute(fs, buffer, 80);
+        switch (_format) {
+        case WLANFRAMESYNC_AUTOTEST_SC16:
+            wlanframesync_execute_sc16(fs, buffer_sc16, 80);
+            break;
+        case WLANFRAMESYNC_AUTOTEST_SC8:
+            for (i=0; i<160; i++) {
+                float v = 32.0f*(i % 2 ? cimagf(buffer[i/2]) : crealf(buffer[i/2]));
+                buffer_sc8[i] = v > 127.0f ? 127 : (v < -128.0f ? -128 : (int8_t)lrintf(v));
+            }
+            wlanframesync_execute_sc8(fs, buffer_sc8, 80);
+            break;
+        default:
+            wlanframesync_execute(fs, buffer, 80);
+        }
     }
 
     // destroy objects
@@ -164,7 +193,7 @@ int wlanframesync_runtest(unsigned int _rate)
     }
 
     if (!testdata.valid) {
-        fprintf(stderr,"fail: %s, synchronization failure (rate = %u)\n", __FILE__, _rate);
+        fprintf(stderr,"fail: %s, synchronization failure (rate = %u, format = %u)\n", __FILE__, _rate, _format);
         exit(1);
     }
     
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+//
+// wlanframesync_frontend_autotest.c
+//
+// Test frame synchronizer front-end: frames at common radio sample
+// rates with the channel off-center and a strong out-of-channel tone;
+// block boundaries must not affect the result, so every frame must be
+// reported identically whether the input arrives in short blocks or at
+// once
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <complex.h>
+
+#include "liquid-wlan.internal.h"
+#include "autotest/autotest_frames.h"
+
+#define WLANFRAMESYNC_FRONTEND_AUTOTEST_NUM_FRAMES  (8)
+
+// receive frames at input rate 20*_Q/_P MHz with the channel at _fc
+//  _P      :   front-end interpolation factor
+//  _Q      :   front-end decimation factor
+//  _fc     :   channel center frequency relative to input sample rate
+void wlanframesync_frontend_autotest(unsigned int _P,
+                                     unsigned int _Q,
+                                     float        _fc)
+{
+    unsigned int num_frames = WLANFRAMESYNC_FRONTEND_AUTOTEST_NUM_FRAMES;
+    unsigned int num_gap    = 500;      // number of samples between frames
+    float        f_tone     = 12.0f;    // tone offset from channel center [MHz]
+
+    // generate 20 MHz baseband signal
+    wlanframegen fg = wlanframegen_create();
+    unsigned int num_samples;
+    float complex * x = autotest_frames_signal(fg, 0, num_frames, 600, num_gap, 0, NULL, &num_samples);
+    wlanframegen_destroy(fg);
+    unsigned int i;
+
+    // measure signal level
+    float e = 0.0f;
+    for (i=0; i<num_samples; i++)
+        e += crealf(x[i]*conjf(x[i]));
+    float rms = sqrtf(e / (float)num_samples);
+
+    // resample to input rate
+    wlan_resamp r = wlan_resamp_create(_Q, _P, 16);
+    unsigned int num_input = wlan_resamp_get_num_output(r, num_samples);
+    float complex * y = (float complex*) malloc(num_input*sizeof(float complex));
+    wlan_resamp_execute(r, x, num_samples, y, &num_input);
+    wlan_resamp_destroy(r);
+
+    // mix to channel center and, when the input rate leaves room for it
+    // outside the channel, add tone at the same power as the signal
+    float fs = 20.0f * (float)_Q / (float)_P;
+    float ft = _fc + f_tone / fs;
+    float gt = _Q > _P ? rms : 0.0f;
+    for (i=0; i<num_input; i++)
+        y[i] = y[i]*cexpf(_Complex_I*2*M_PI*_fc*i) + gt*cexpf(_Complex_I*2*M_PI*ft*i);
+
+    // run synchronizer with short blocks, then with whole input
+    unsigned int block_len[2] = {313, num_input};
+    unsigned int rssi[2][WLANFRAMESYNC_FRONTEND_AUTOTEST_NUM_FRAMES];
+    unsigned int k;
+    for (k=0; k<2; k++) {
+        struct autotest_frames_s testdata;
+        autotest_frames_init(&testdata, 0, 600);
+        autotest_frames_set_rssi(&testdata, rssi[k], num_frames);
+        wlanframesync fs_rx = wlanframesync_create(autotest_frames_callback, (void*)&testdata);
+        wlanframesync_set_frontend(fs_rx, _P, _Q, _fc);
+        for (i=0; i<num_input; i+=block_len[k])
+            wlanframesync_execute(fs_rx, &y[i], i + block_len[k] < num_input ? block_len[k] : num_input - i);
+        wlanframesync_destroy(fs_rx);
+
+        if (!testdata.valid || testdata.num_frames != num_frames) {
+            fprintf(stderr,"fail: %s, %.2f MS/s, block %u received %u of %u frames\n", __FILE__,
+                    fs, block_len[k], testdata.num_frames, num_frames);
+            exit(1);
+        } else if (memcmp(rssi[k], rssi[0], sizeof(rssi[0])) != 0) {
+            fprintf(stderr,"fail: %s, %.2f MS/s, frames reported differently with whole input\n", __FILE__, fs);
+            exit(1);
+        }
+    }
+    printf("  %u frames received (%.2f MS/s, fc = %.3f)\n", num_frames, fs, _fc);
+
+    free(x);
+    free(y);
+}
+
+int main() {
+    wlanframesync_frontend_autotest(  4,   5,  0.15f);  // 25 MS/s
+    wlanframesync_frontend_autotest(125, 192, -0.20f);  // 30.72 MS/s
+    wlanframesync_frontend_autotest(  1,   2,  0.10f);  // 40 MS/s
+    wlanframesync_frontend_autotest(  1,   1,  0.05f);  // 20 MS/s, offset only
+
+    return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+//
+// wlanframesync_mrc_autotest.c
+//
+// Test multi-antenna frame synchronizer: frames received on two
+// antennas through frequency-selective channels whose fades fall on
+// different subcarriers, with a common carrier offset and noise; where
+// the fades are deep, a single-antenna synchronizer on any one antenna
+// must fail on the same input
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <complex.h>
+
+#include "liquid-wlan.internal.h"
+#include "autotest/autotest_frames.h"
+
+// receive frames on _num_antennas antennas, each with channel
+// h(z) = 1 + _h1[a] z^-1
+//  _num_antennas   :   number of antennas
+//  _h1             :   channel echo for each antenna [size: _num_antennas x 1]
+//  _snr            :   signal-to-noise ratio on each antenna [dB]
+//  _diversity      :   single antenna must fail to receive all frames?
+void wlanframesync_mrc_autotest(unsigned int    _num_antennas,
+                                float complex * _h1,
+                                float           _snr,
+                                int             _diversity)
+{
+    unsigned int num_frames = 8;        // number of frames to generate
+    unsigned int num_gap    = 400;      // number of samples between frames
+    unsigned int block_len  = 251;      // synchronizer input block size
+    float        dphi       = 0.003f;   // carrier frequency offset
+
+    // generate baseband signal
+    wlanframegen fg = wlanframegen_create();
+    unsigned int num_samples;
+    float complex * x = autotest_frames_signal(fg, 0, num_frames, 800, num_gap, 0, NULL, &num_samples);
+    wlanframegen_destroy(fg);
+    unsigned int a, i;
+
+    // measure signal level and set noise level
+    float e = 0.0f;
+    for (i=0; i<num_samples; i++)
+        e += crealf(x[i]*conjf(x[i]));
+    float nstd = sqrtf(e / (float)num_samples) * powf(10.0f, -_snr/20.0f);
+
+    // apply channel, carrier offset and noise for each antenna
+    float complex * y[_num_antennas];
+    for (a=0; a<_num_antennas; a++) {
+        y[a] = (float complex*) malloc(num_samples*sizeof(float complex));
+        for (i=0; i<num_samples; i++) {
+            float complex noise = ((float)rand()/RAND_MAX - 0.5f) + _Complex_I*((float)rand()/RAND_MAX - 0.5f);
+            y[a][i] = (x[i] + (i > 0 ? _h1[a]*x[i-1] : 0.0f)) * cexpf(_Complex_I*dphi*i) +
+                      nstd*sqrtf(6.0f)*noise;
+        }
+    }
+
+    // run synchronizer
+    struct autotest_frames_s testdata;
+    autotest_frames_init(&testdata, 0, 800);
+    wlanframesync_mrc fs = wlanframesync_mrc_create(_num_antennas, autotest_frames_callback, (void*)&testdata);
+    float complex * yb[_num_antennas];
+    for (i=0; i<num_samples; i+=block_len) {
+        for (a=0; a<_num_antennas; a++)
+            yb[a] = &y[a][i];
+        wlanframesync_mrc_execute(fs, yb, i + block_len < num_samples ? block_len : num_samples - i);
+    }
+    wlanframesync_mrc_destroy(fs);
+
+    if (!testdata.valid || testdata.num_frames != num_frames) {
+        fprintf(stderr,"fail: %s, %u antenna(s) received %u of %u frames\n", __FILE__,
+                _num_antennas, testdata.num_frames, num_frames);
+        exit(1);
+    }
+    printf("  %u frames received (%u antenna(s), SNR = %.1f dB)\n", num_frames, _num_antennas, _snr);
+
+    // run single-antenna synchronizer on each antenna
+    for (a=0; _diversity && a<_num_antennas; a++) {
+        struct autotest_frames_s testdata_single;
+        autotest_frames_init(&testdata_single, 0, 800);
+        wlanframesync fs_single = wlanframesync_create(autotest_frames_callback, (void*)&testdata_single);
+        wlanframesync_execute(fs_single, y[a], num_samples);
+        wlanframesync_destroy(fs_single);
+        if (testdata_single.valid && testdata_single.num_frames == num_frames) {
+            fprintf(stderr,"fail: %s, antenna %u alone received all %u frames\n", __FILE__,
+                    a, num_frames);
+            exit(1);
+        }
+        printf("  antenna %u alone: frames lost or corrupted\n", a);
+    }
+
+    for (a=0; a<_num_antennas; a++)
+        free(y[a]);
+    free(x);
+}
+
+int main() {
+    // single antenna, flat channel
+    float complex h0[1] = {0.0f};
+    wlanframesync_mrc_autotest(1, h0, 30.0f, 0);
+
+    // complementary fades: |H_0(k)|^2 + |H_1(k)|^2 is flat
+    float complex h1[2] = {0.9f*_Complex_I, -0.9f*_Complex_I};
+    wlanframesync_mrc_autotest(2, h1, 30.0f, 1);
+
+    // spectral nulls: each antenna loses a subcarrier entirely
+    float complex h3[2] = {_Complex_I, -_Complex_I};
+    wlanframesync_mrc_autotest(2, h3, 25.0f, 1);
+
+    // four antennas with independent echoes
+    float complex h2[4] = {0.9f, -0.9f, 0.9f*_Complex_I, -0.9f*_Complex_I};
+    wlanframesync_mrc_autotest(4, h2, 25.0f, 0);
+
+    return 0;
+}
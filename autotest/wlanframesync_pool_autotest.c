@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanframesync_pool_autotest.c
+//
+// Test frame synchronizer with a decoding pool against inline decoding,
+// validating that frames are delivered complete and in order, and that
+// the workers decode with the detection thread's estimates: every frame
+// must be reported exactly as inline decoding reports it
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <complex.h>
+
+#include "liquid-wlan.h"
+#include "autotest/autotest_frames.h"
+
+#define WLANFRAMESYNC_POOL_AUTOTEST_NUM_FRAMES  (28)
+
+int main() {
+    // options
+    unsigned int num_frames  = WLANFRAMESYNC_POOL_AUTOTEST_NUM_FRAMES;
+    unsigned int num_gap     = 400;     // number of samples between frames
+    float        dphi        = 0.001f;  // carrier frequency offset
+    unsigned int block_len   = 237;     // synchronizer input block size
+
+    // generate signal: frames separated by silence at levels varying
+    // over 12 dB, with carrier offset
+    wlanframegen fg = wlanframegen_create();
+    unsigned long int starts[WLANFRAMESYNC_POOL_AUTOTEST_NUM_FRAMES];
+    unsigned int num_samples;
+    float complex * x = autotest_frames_signal(fg, 0, num_frames, 400, num_gap, 0, starts, &num_samples);
+    wlanframegen_destroy(fg);
+    unsigned int i, n = 0;
+    for (i=0; i<num_samples; i++) {
+        if (n+1 < num_frames && i == starts[n+1])
+            n++;
+        x[i] *= powf(10.0f, -0.15f*(float)(n % 5)) * cexpf(_Complex_I*dphi*i);
+    }
+
+    // run inline synchronizer, then pooled synchronizers with more
+    // threads than slots and with a single slot
+    unsigned int num_threads[3] = {0, 3, 2};
+    unsigned int num_slots[3]   = {0, 2, 1};
+    unsigned int rssi[3][WLANFRAMESYNC_POOL_AUTOTEST_NUM_FRAMES];
+    unsigned int k;
+    for (k=0; k<3; k++) {
+        struct autotest_frames_s testdata;
+        autotest_frames_init(&testdata, 0, 400);
+        autotest_frames_set_rssi(&testdata, rssi[k], num_frames);
+        wlanframesync fs = k == 0 ?
+            wlanframesync_create(autotest_frames_callback, (void*)&testdata) :
+            wlanframesync_create_pool(autotest_frames_callback, (void*)&testdata, num_threads[k], num_slots[k]);
+
+        for (i=0; i<num_samples; i+=block_len)
+            wlanframesync_execute(fs, &x[i], i + block_len < num_samples ? block_len : num_samples - i);
+        wlanframesync_flush(fs);
+        wlanframesync_destroy(fs);
+
+        if (!testdata.valid || testdata.num_frames != num_frames) {
+            fprintf(stderr,"fail: %s, %u thread(s), %u slot(s) received %u of %u frames\n", __FILE__,
+                    num_threads[k], num_slots[k], testdata.num_frames, num_frames);
+            exit(1);
+        }
+        for (i=0; i<num_frames; i++) {
+            if (rssi[k][i] != rssi[0][i]) {
+                fprintf(stderr,"fail: %s, %u thread(s), %u slot(s): frame %u RSSI %u, inline %u\n", __FILE__,
+                        num_threads[k], num_slots[k], i, rssi[k][i], rssi[0][i]);
+                exit(1);
+            }
+        }
+        if (k == 0)
+            printf("  %u frames received (inline)\n", num_frames);
+        else
+            printf("  %u frames received (%u threads, %u slots)\n", num_frames, num_threads[k], num_slots[k]);
+    }
+
+    free(x);
+    return 0;
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+//
+// wlanframesync_wide_autotest.c
+//
+// Test wide frame synchronizer: independent streams with frames at
+// different times, levels and carrier offsets, received against a
+// separate synchronizer for each stream; a lane that detects a frame
+// hands it to a normal synchronizer, so the first frame on each stream,
+// detected from the same initial state, must be reported exactly as the
+// separate synchronizer reports it
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <complex.h>
+
+#include "liquid-wlan.h"
+#include "autotest/autotest_frames.h"
+
+#define WLANFRAMESYNC_WIDE_AUTOTEST_LANES   (13)    // number of streams
+#define WLANFRAMESYNC_WIDE_AUTOTEST_FRAMES  (3)     // frames per stream
+
+// frames received on each stream
+static struct autotest_frames_s testdata[WLANFRAMESYNC_WIDE_AUTOTEST_LANES];
+
+// callback for wide synchronizer
+static int callback_wide(unsigned int           _lane,
+                         unsigned char *        _payload,
+                         struct wlan_rxvector_s _rxvector,
+                         void *                 _userdata)
+{
+    if (_lane >= WLANFRAMESYNC_WIDE_AUTOTEST_LANES) {
+        fprintf(stderr,"fail: %s, invalid stream %u\n", __FILE__, _lane);
+        exit(1);
+    }
+    autotest_frames_receive(&testdata[_lane], _payload, _rxvector);
+    return 0;
+}
+
+int main() {
+    unsigned int num_lanes  = WLANFRAMESYNC_WIDE_AUTOTEST_LANES;
+    unsigned int num_frames_tx = WLANFRAMESYNC_WIDE_AUTOTEST_FRAMES;
+    unsigned int block_len  = 150;      // input block size
+    float        nstd       = 0.01f;    // noise standard deviation
+
+    // generate streams: frames at staggered times and levels, with
+    // carrier offset and noise
+    wlanframegen fg = wlanframegen_create();
+    unsigned char payload[4095];
+    struct wlan_txvector_s txvector;
+    float complex * x[num_lanes];
+    unsigned int len[num_lanes];
+    unsigned int num_samples = 0;
+    unsigned int i, l, n;
+    for (l=0; l<num_lanes; l++) {
+        x[l] = NULL;
+        len[l] = 0;
+        for (n=0; n<num_frames_tx; n++) {
+            unsigned int gap = n == 0 ? 100 + 97*l : 600 + 53*l;
+            autotest_frames_job(l, n, 300, payload, &txvector);
+            wlanframegen_assemble(fg, payload, txvector);
+            unsigned int frame_len = wlanframegen_getframelen(fg);
+            x[l] = (float complex*) realloc(x[l], (len[l] + gap + frame_len)*sizeof(float complex));
+            memset(&x[l][len[l]], 0x00, gap*sizeof(float complex));
+            wlanframegen_write_frame(fg, &x[l][len[l] + gap]);
+            len[l] += gap + frame_len;
+        }
+        if (len[l] > num_samples)
+            num_samples = len[l];
+    }
+    wlanframegen_destroy(fg);
+    num_samples += 500;
+    srand(1);
+    for (l=0; l<num_lanes; l++) {
+        x[l] = (float complex*) realloc(x[l], num_samples*sizeof(float complex));
+        memset(&x[l][len[l]], 0x00, (num_samples - len[l])*sizeof(float complex));
+        float dphi = 0.0005f*(float)(l % 5) - 0.001f;
+        float g    = powf(10.0f, -0.1f*(float)(l % 4));
+        for (i=0; i<num_samples; i++) {
+            float complex noise = ((float)rand()/RAND_MAX - 0.5f) + _Complex_I*((float)rand()/RAND_MAX - 0.5f);
+            x[l][i] = g*x[l][i]*cexpf(_Complex_I*dphi*i) + nstd*sqrtf(6.0f)*noise;
+        }
+    }
+
+    // receive with wide synchronizer, then with separate synchronizers
+    unsigned int rssi[2][WLANFRAMESYNC_WIDE_AUTOTEST_LANES][WLANFRAMESYNC_WIDE_AUTOTEST_FRAMES];
+    unsigned int k;
+    for (k=0; k<2; k++) {
+        for (l=0; l<num_lanes; l++) {
+            autotest_frames_init(&testdata[l], l, 300);
+            autotest_frames_set_rssi(&testdata[l], rssi[k][l], num_frames_tx);
+        }
+
+        float complex * px[num_lanes];
+        if (k == 0) {
+            wlanframesync_wide q = wlanframesync_wide_create(num_lanes, callback_wide, NULL);
+            for (i=0; i<num_samples; i+=block_len) {
+                for (l=0; l<num_lanes; l++)
+                    px[l] = &x[l][i];
+                wlanframesync_wide_execute(q, px, i + block_len < num_samples ? block_len : num_samples - i);
+            }
+            if (wlanframesync_wide_get_num_active(q) != 0) {
+                fprintf(stderr,"fail: %s, streams still active\n", __FILE__);
+                exit(1);
+            }
+            wlanframesync_wide_destroy(q);
+        } else {
+            for (l=0; l<num_lanes; l++) {
+                wlanframesync fs = wlanframesync_create(autotest_frames_callback, (void*)&testdata[l]);
+                wlanframesync_execute(fs, x[l], num_samples);
+                wlanframesync_destroy(fs);
+            }
+        }
+
+        for (l=0; l<num_lanes; l++) {
+            if (!testdata[l].valid || testdata[l].num_frames != num_frames_tx) {
+                fprintf(stderr,"fail: %s, %s stream %u received %u of %u frames\n", __FILE__,
+                        k == 0 ? "wide" : "separate", l, testdata[l].num_frames, num_frames_tx);
+                exit(1);
+            }
+        }
+        printf("  %u streams received (%s)\n", num_lanes, k == 0 ? "wide" : "separate");
+    }
+
+    // compare first frame reported by wide and separate synchronizers
+    for (l=0; l<num_lanes; l++) {
+        if (rssi[0][l][0] != rssi[1][l][0]) {
+            fprintf(stderr,"fail: %s, stream %u RSSI %u (wide), %u (separate)\n", __FILE__,
+                    l, rssi[0][l][0], rssi[1][l][0]);
+            exit(1);
+        }
+    }
+
+    for (l=0; l<num_lanes; l++)
+        free(x[l]);
+
+    return 0;
+}
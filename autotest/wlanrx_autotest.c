@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanrx_autotest.c
+//
+// Test multi-channel receiver, validating that every channel's frames
+// are delivered complete and in order, that the reported backlog never
+// exceeds the channel buffer and drains on flush, with and without
+// thread pinning and NUMA-local buffers
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <complex.h>
+
+#include "liquid-wlan.h"
+#include "autotest/autotest_frames.h"
+
+#define WLANRX_AUTOTEST_NUM_CHANNELS    (5)
+
+// callback function: compare each frame against its channel's
+// parameters; delivery is serialized within a channel
+static int callback(unsigned int           _channel,
+                    unsigned char *        _payload,
+                    struct wlan_rxvector_s _rxvector,
+                    void *                 _userdata)
+{
+    struct autotest_frames_s * testdata = (struct autotest_frames_s*) _userdata;
+    autotest_frames_receive(&testdata[_channel], _payload, _rxvector);
+    return 0;
+}
+
+// receive frames on every channel
+//  _flags      :   receiver options
+void wlanrx_autotest(int _flags)
+{
+    // options
+    unsigned int num_channels = WLANRX_AUTOTEST_NUM_CHANNELS;
+    unsigned int num_threads  = 3;      // number of worker threads
+    unsigned int buffer_len   = 3000;   // input samples buffered per channel
+    unsigned int num_frames   = 12;     // number of frames per channel
+    unsigned int num_gap      = 400;    // number of samples between frames
+    unsigned int block_len    = 500;    // input block size
+
+    // generate signal for each channel
+    wlanframegen fg = wlanframegen_create();
+    float complex * x[WLANRX_AUTOTEST_NUM_CHANNELS];
+    unsigned int num_samples[WLANRX_AUTOTEST_NUM_CHANNELS];
+    struct autotest_frames_s testdata[WLANRX_AUTOTEST_NUM_CHANNELS];
+    unsigned int i, c;
+    for (c=0; c<num_channels; c++) {
+        x[c] = autotest_frames_signal(fg, c, num_frames, 300, num_gap, 0, NULL, &num_samples[c]);
+        autotest_frames_init(&testdata[c], c, 300);
+    }
+    wlanframegen_destroy(fg);
+
+    // push blocks to channels in turn
+    wlanrx q = wlanrx_create(num_channels, num_threads, buffer_len, _flags,
+                             callback, (void*)testdata);
+    int done = 0;
+    for (i=0; !done; i+=block_len) {
+        done = 1;
+        for (c=0; c<num_channels; c++) {
+            if (i >= num_samples[c])
+                continue;
+            wlanrx_execute(q, c, &x[c][i], i + block_len < num_samples[c] ? block_len : num_samples[c] - i);
+            if (wlanrx_get_backlog(q, c) > buffer_len) {
+                fprintf(stderr,"fail: %s, channel %u backlog %u exceeds buffer\n", __FILE__,
+                        c, wlanrx_get_backlog(q, c));
+                exit(1);
+            }
+            done = 0;
+        }
+    }
+    wlanrx_flush(q);
+
+    // check results
+    for (c=0; c<num_channels; c++) {
+        if (wlanrx_get_backlog(q, c) != 0 || wlanrx_get_frame_backlog(q, c) != 0) {
+            fprintf(stderr,"fail: %s, channel %u backlog not empty after flush\n", __FILE__, c);
+            exit(1);
+        } else if (!testdata[c].valid || testdata[c].num_frames != num_frames) {
+            fprintf(stderr,"fail: %s, channel %u received %u of %u frames\n", __FILE__,
+                    c, testdata[c].num_frames, num_frames);
+            exit(1);
+        }
+    }
+    printf("  %u channels x %u frames received with %u threads (flags 0x%x)\n",
+            num_channels, num_frames, num_threads, _flags);
+
+    // destroy objects
+    wlanrx_destroy(q);
+    for (c=0; c<num_channels; c++)
+        free(x[c]);
+}
+
+int main() {
+    wlanrx_autotest(0);
+    wlanrx_autotest(LIQUID_WLAN_RX_PIN_THREADS | LIQUID_WLAN_RX_NUMA_LOCAL);
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+//
+// wlanframegen_pool_benchmark.c
+//
+// Measure frame generation pool throughput against the number of worker
+// threads; execution time is wall-clock rather than processor time.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <complex.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "liquid-wlan.h"
+
+double calculate_execution_time(struct timeval _start, struct timeval _finish)
+{
+    return _finish.tv_sec - _start.tv_sec
+        + 1e-6*(_finish.tv_usec - _start.tv_usec);
+}
+
+// Helper function to keep code base small
+void wlanframegen_pool_benchmark(struct timeval *    _start,
+                                 struct timeval *    _finish,
+                                 unsigned long int * _num_iterations,
+                                 unsigned int        _num_threads)
+{
+    unsigned long int i;
+    unsigned int dec_msg_len = 100;
+    unsigned int num_slots = 4*_num_threads;
+
+    // options
+    struct wlan_txvector_s txvector;
+    txvector.LENGTH      = dec_msg_len;
+    txvector.SERVICE     = 0;
+    txvector.TXPWR_LEVEL = 0;
+    unsigned int rates[7] = {WLANFRAME_RATE_6,  WLANFRAME_RATE_12,
+                             WLANFRAME_RATE_18, WLANFRAME_RATE_24,
+                             WLANFRAME_RATE_36, WLANFRAME_RATE_48,
+                             WLANFRAME_RATE_54};
+
+    // initialize
+    unsigned char msg_org[dec_msg_len];
+    for (i=0; i<dec_msg_len; i++)
+        msg_org[i] = rand() & 0xff;
+
+    // create frame generation pool
+    wlanframegen_pool pool = wlanframegen_pool_create(_num_threads, num_slots);
+
+    // sample counter
+    unsigned long int n = 0;
+
+    // start trials
+    gettimeofday(_start, NULL);
+
+    unsigned long int num_submitted = 0;
+    for (i=0; i<(*_num_iterations); i++) {
+        // keep pool full
+        while (num_submitted < *_num_iterations && wlanframegen_pool_get_backlog(pool) < num_slots) {
+            txvector.DATARATE = rates[num_submitted % 7];
+            wlanframegen_pool_submit(pool, msg_org, txvector);
+            num_submitted++;
+        }
+
+        // read frame, increasing sample counter
+        unsigned int frame_len;
+        wlanframegen_pool_read(pool, &frame_len);
+        wlanframegen_pool_release(pool);
+        n += frame_len;
+    }
+    gettimeofday(_finish, NULL);
+
+    // set number of iterations to number of samples generated
+    *_num_iterations = n;
+
+    // destroy frame generation pool
+    wlanframegen_pool_destroy(pool);
+}
+
+int main() {
+    struct timeval start, finish;
+    long int num_cores = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned int num_threads;
+
+    // run benchmark(s) with increasing number of threads
+    for (num_threads=1; num_threads<=(num_cores < 1 ? 1 : num_cores); num_threads*=2) {
+        unsigned long int n = 20000;
+        wlanframegen_pool_benchmark(&start, &finish, &n, num_threads);
+
+        // compute execution time
+        float extime = calculate_execution_time(start, finish);
+
+        // print results
+        char name[32];
+        snprintf(name, 32, "wlanframegen_pool (%u)", num_threads);
+        printf("%-24s : time : %8.5f s, iterations : %8lu (%10.4e samples/s)\n", name, extime, n, (float)n/extime);
+    }
+
+    return 0;
+}
@@ -76,6 +76,33 @@ extern "C" {
 
 LIQUID_WLAN_DEFINE_COMPLEX(float,  liquid_float_complex);
 
+#include <stdint.h>
+
+//
+// run-time CPU feature dispatch
+//
+
+// feature levels, each including those below it
+#define LIQUID_WLAN_CPU_GENERIC (0) // portable C
+#define LIQUID_WLAN_CPU_SSE2    (1) // x86 SSE2
+#define LIQUID_WLAN_CPU_AVX2    (2) // x86 AVX2 and BMI2
+
+// get feature level used by kernels; the host is probed once on first
+// use, and the level may be lowered (never raised) by setting the
+// LIQUID_WLAN_CPU environment variable to "generic", "sse2" or "avx2".
+// The pext/pdep interleaver and repack kernels are chosen separately,
+// only on hosts known to execute pext/pdep quickly, and are disabled by
+// adding "nopdep" to the variable, e.g. "avx2,nopdep"
+unsigned int liquid_wlan_cpu_get_level(void);
+
+// get name of implementation selected for kernel ("viterbi27", "fft",
+// "modem", "interleaver", "interleaver_soft", "scrambler", "repack"),
+// or NULL if the kernel is unknown
+const char * liquid_wlan_cpu_get_kernel(const char * _kernel);
+
+// print feature levels and selected kernels
+void liquid_wlan_cpu_print(void);
+
 // rates
 #define WLANFRAME_RATE_6        (0) // BPSK,   r1/2, 1101
 #define WLANFRAME_RATE_9        (1) // BPSK,   r3/4, 1111
@@ -94,6 +121,11 @@ struct wlan_txvector_s {
     unsigned int TXPWR_LEVEL;   // transmit power level, (1-8)
 };
 
+// sc16 output scaling at full transmit power (TXPWR_LEVEL 0 or 1); each
+// subsequent level reduces the digital gain by 3 dB (levels above 8 are
+// treated as 8)
+#define WLANFRAMEGEN_SC16_SCALE (8192.0f)
+
 // RXVECTOR parameters structure
 struct wlan_rxvector_s {
     unsigned int LENGTH;        // length of payload (1-4095)
@@ -112,6 +144,14 @@ typedef struct wlanframegen_s * wlanframegen;
 // create WLAN framing generator object
 wlanframegen wlanframegen_create();
 
+// create WLAN framing generator object with output interpolation,
+// resampling the 20 MHz baseband signal by _P/_Q (e.g. 2/1 for 40 MHz);
+// every symbol is 80*_P/_Q samples at the output
+//  _P          :   interpolation factor, _P > 0
+//  _Q          :   decimation factor, _Q > 0, 80*_P/_Q must be an integer
+wlanframegen wlanframegen_create_interp(unsigned int _P,
+                                       unsigned int _Q);
+
 // destroy WLAN framing generator object
 void wlanframegen_destroy(wlanframegen _q);
 
@@ -131,10 +171,99 @@ void wlanframegen_assemble(wlanframegen           _q,
 
 // write OFDM symbol, returning '1' when frame is complete
 //  _q          :   framing generator object
-//  _buffer     :   output sample buffer [size: 80 x 1]
+//  _buffer     :   output sample buffer [size: 80*P/Q x 1]
 int wlanframegen_writesymbol(wlanframegen           _q,
                              liquid_float_complex * _buffer);
 
+// get length of assembled frame (number of samples)
+unsigned int wlanframegen_getframelen(wlanframegen _q);
+
+// write entire frame to buffer; must be invoked immediately after
+// assembling the frame
+//  _q          :   framing generator object
+//  _buffer     :   output sample buffer [size: wlanframegen_getframelen() x 1]
+void wlanframegen_write_frame(wlanframegen           _q,
+                              liquid_float_complex * _buffer);
+
+// write samples to buffer, resuming where the previous call left off
+// and returning '1' when frame is complete; samples beyond the end of
+// the frame are set to zero
+//  _q          :   framing generator object
+//  _buffer     :   output sample buffer [size: _n x 1]
+//  _n          :   number of samples to write
+int wlanframegen_write_samples(wlanframegen           _q,
+                               liquid_float_complex * _buffer,
+                               unsigned int           _n);
+
+// write OFDM symbol as interleaved int16 I/Q, applying the TXPWR_LEVEL
+// gain with rounding and saturation; returns '1' when frame is complete
+//  _q          :   framing generator object
+//  _buffer     :   output I/Q buffer [size: 2*80*P/Q x 1]
+int wlanframegen_writesymbol_sc16(wlanframegen _q,
+                                  int16_t *    _buffer);
+
+// write entire frame as interleaved int16 I/Q (see
+// wlanframegen_writesymbol_sc16)
+//  _q          :   framing generator object
+//  _buffer     :   output I/Q buffer [size: 2*wlanframegen_getframelen() x 1]
+void wlanframegen_write_frame_sc16(wlanframegen _q,
+                                   int16_t *    _buffer);
+
+// write samples as interleaved int16 I/Q (see
+// wlanframegen_write_samples and wlanframegen_writesymbol_sc16)
+//  _q          :   framing generator object
+//  _buffer     :   output I/Q buffer [size: 2*_n x 1]
+//  _n          :   number of samples to write
+int wlanframegen_write_samples_sc16(wlanframegen _q,
+                                    int16_t *    _buffer,
+                                    unsigned int _n);
+
+// enable/disable caching of DATA field waveform for repeated frames
+// (e.g. beacons); takes effect at the next call to assemble()
+void wlanframegen_payload_cache_enable(wlanframegen _q);
+void wlanframegen_payload_cache_disable(wlanframegen _q);
+
+
+// 
+// wlan frame generation pool (multi-threaded)
+//
+
+// forward declaration of WLAN frame generation pool
+typedef struct wlanframegen_pool_s * wlanframegen_pool;
+
+// create frame generation pool
+//  _num_threads    :   number of worker threads, _num_threads > 0
+//  _num_slots      :   number of jobs/frames in flight, _num_slots > 0
+wlanframegen_pool wlanframegen_pool_create(unsigned int _num_threads,
+                                           unsigned int _num_slots);
+
+// destroy frame generation pool; frames not yet read are discarded
+void wlanframegen_pool_destroy(wlanframegen_pool _q);
+
+// print frame generation pool object internals
+void wlanframegen_pool_print(wlanframegen_pool _q);
+
+// submit frame for generation, blocking while all slots are in use
+//  _q          :   frame generation pool
+//  _payload    :   raw payload data [size: _txvector.LENGTH x 1]
+//  _txvector   :   framing options
+void wlanframegen_pool_submit(wlanframegen_pool      _q,
+                              unsigned char *        _payload,
+                              struct wlan_txvector_s _txvector);
+
+// read next frame in submission order, blocking until it is ready; the
+// returned buffer is valid until wlanframegen_pool_release() is invoked
+//  _q          :   frame generation pool
+//  _frame_len  :   number of samples in frame
+liquid_float_complex * wlanframegen_pool_read(wlanframegen_pool _q,
+                                              unsigned int *    _frame_len);
+
+// release frame returned by wlanframegen_pool_read(), freeing its slot
+void wlanframegen_pool_release(wlanframegen_pool _q);
+
+// get number of frames submitted but not yet released
+unsigned int wlanframegen_pool_get_backlog(wlanframegen_pool _q);
+
 
 // 
 // wlan frame synchronizer
@@ -157,6 +286,19 @@ typedef int (*wlanframesync_callback)(unsigned char *        _payload,
 wlanframesync wlanframesync_create(wlanframesync_callback _callback,
                                    void *                 _userdata);
 
+// create WLAN framing synchronizer object which only detects frames,
+// handing each aligned DATA field to a pool of worker threads for
+// equalization, demodulation and decoding; the callback is invoked from
+// the worker threads, one frame at a time and in order of detection
+//  _callback       :   user-defined callback function
+//  _userdata       :   user-defined data structure
+//  _num_threads    :   number of decoding threads, _num_threads > 0
+//  _num_slots      :   number of frames in flight, _num_slots > 0
+wlanframesync wlanframesync_create_pool(wlanframesync_callback _callback,
+                                        void *                 _userdata,
+                                        unsigned int           _num_threads,
+                                        unsigned int           _num_slots);
+
 // destroy WLAN framing synchronizer object
 void wlanframesync_destroy(wlanframesync _q);
 
@@ -166,6 +308,24 @@ void wlanframesync_print(wlanframesync _q);
 // reset WLAN framing synchronizer object internal state
 void wlanframesync_reset(wlanframesync _q);
 
+// set input front-end: the input is mixed down by _fc and resampled by
+// _P/_Q to 20 MHz in a single pass before synchronization, e.g.
+// _P/_Q = 4/5 for 25 MS/s, 125/192 for 30.72 MS/s, 1/2 for 40 MS/s;
+// _P = _Q with _fc = 0 removes the front-end; resets the object
+//  _q      :   framing synchronizer object
+//  _P      :   interpolation factor, _P > 0
+//  _Q      :   decimation factor, _Q > 0
+//  _fc     :   channel center frequency relative to input sample rate, -0.5 <= _fc <= 0.5
+void wlanframesync_set_frontend(wlanframesync _q,
+                                unsigned int  _P,
+                                unsigned int  _Q,
+                                float         _fc);
+
+// block until every frame handed to the decoding pool has been decoded
+// and delivered to the callback; returns immediately if frames are
+// decoded inline
+void wlanframesync_flush(wlanframesync _q);
+
 // execute framing synchronizer on input buffer
 //  _q      :   framing synchronizer object
 //  _buffer :   input buffer [size: _n x 1]
@@ -174,9 +334,32 @@ void wlanframesync_execute(wlanframesync          _q,
                            liquid_float_complex * _buffer,
                            unsigned int           _n);
 
-// query methods
-float wlanframesync_get_rssi(wlanframesync _q); // received signal strength indication
-float wlanframesync_get_cfo(wlanframesync _q);  // carrier offset estimate
+// execute framing synchronizer on interleaved int16 I/Q input, scaled
+// by 1/32768; samples are converted in small blocks as they are consumed
+//  _q      :   framing synchronizer object
+//  _buffer :   input I/Q buffer [size: 2*_n x 1]
+//  _n      :   number of input samples
+void wlanframesync_execute_sc16(wlanframesync _q,
+                                int16_t *     _buffer,
+                                unsigned int  _n);
+
+// execute framing synchronizer on interleaved int8 I/Q input, scaled
+// by 1/128 (see wlanframesync_execute_sc16)
+//  _q      :   framing synchronizer object
+//  _buffer :   input I/Q buffer [size: 2*_n x 1]
+//  _n      :   number of input samples
+void wlanframesync_execute_sc8(wlanframesync _q,
+                               int8_t *      _buffer,
+                               unsigned int  _n);
+
+// query methods, for the most recent frame
+float wlanframesync_get_rssi(wlanframesync _q); // received signal strength [dB]
+float wlanframesync_get_cfo(wlanframesync _q);  // carrier offset estimate [radians/sample]
+
+// get index of the first sample of the most recent frame, counting 20
+// MHz baseband samples (after the front-end, if any) from creation; for
+// frames decoded inline, this is the frame passed to the callback
+unsigned long int wlanframesync_get_frame_start(wlanframesync _q);
 
 // 
 // internal/debugging methods
@@ -185,6 +368,389 @@ void wlanframesync_debug_enable(wlanframesync _q);
 void wlanframesync_debug_disable(wlanframesync _q);
 void wlanframesync_debug_print(wlanframesync _q, const char * _filename);
 
+//
+// multi-antenna frame synchronizer
+//
+
+// forward declaration of multi-antenna frame synchronizer
+typedef struct wlanframesync_mrc_s * wlanframesync_mrc;
+
+// create frame synchronizer for a single stream received on several
+// antennas sharing a local oscillator: detection, timing and carrier
+// offset are estimated jointly, and subcarriers are combined by
+// maximum-ratio combining before demodulation
+//  _num_antennas   :   number of antennas, _num_antennas > 0
+//  _callback       :   user-defined callback function
+//  _userdata       :   user-defined data structure
+wlanframesync_mrc wlanframesync_mrc_create(unsigned int           _num_antennas,
+                                           wlanframesync_callback _callback,
+                                           void *                 _userdata);
+
+// destroy multi-antenna frame synchronizer object
+void wlanframesync_mrc_destroy(wlanframesync_mrc _q);
+
+// print multi-antenna frame synchronizer object internals
+void wlanframesync_mrc_print(wlanframesync_mrc _q);
+
+// reset multi-antenna frame synchronizer object internal state
+void wlanframesync_mrc_reset(wlanframesync_mrc _q);
+
+// execute multi-antenna frame synchronizer on the same number of
+// samples from every antenna
+//  _q      :   multi-antenna frame synchronizer object
+//  _x      :   input for each antenna [size: _num_antennas x _n]
+//  _n      :   number of input samples per antenna
+void wlanframesync_mrc_execute(wlanframesync_mrc       _q,
+                               liquid_float_complex ** _x,
+                               unsigned int            _n);
+
+//
+// multi-channel receiver
+//
+
+// multi-channel receiver options
+#define LIQUID_WLAN_RX_PIN_THREADS  (1<<0)  // pin each worker thread to a CPU
+#define LIQUID_WLAN_RX_NUMA_LOCAL   (1<<1)  // place channel buffers on home worker's node
+
+// forward declaration of multi-channel receiver
+typedef struct wlanrx_s * wlanrx;
+
+// callback function
+//  _channel    :   channel index
+//  _payload    :   received payload
+//  _rxvector   :   received vector (see Table 77)
+//  _userdata   :   user-defined data object
+typedef int (*wlanrx_callback)(unsigned int           _channel,
+                               unsigned char *        _payload,
+                               struct wlan_rxvector_s _rxvector,
+                               void *                 _userdata);
+
+// create multi-channel receiver: one frame synchronizer per channel, with
+// detection and decoding scheduled on a work-stealing pool of threads;
+// the callback is invoked from the worker threads, in order of detection
+// within each channel but concurrently across channels
+//  _num_channels   :   number of channels, _num_channels > 0
+//  _num_threads    :   number of worker threads, _num_threads > 0
+//  _buffer_len     :   input samples buffered per channel, _buffer_len > 0
+//  _flags          :   options (LIQUID_WLAN_RX_PIN_THREADS, etc.)
+//  _callback       :   user-defined callback function
+//  _userdata       :   user-defined data structure
+wlanrx wlanrx_create(unsigned int    _num_channels,
+                     unsigned int    _num_threads,
+                     unsigned int    _buffer_len,
+                     int             _flags,
+                     wlanrx_callback _callback,
+                     void *          _userdata);
+
+// destroy multi-channel receiver, processing buffered samples first
+void wlanrx_destroy(wlanrx _q);
+
+// print multi-channel receiver object internals
+void wlanrx_print(wlanrx _q);
+
+// push samples for channel, blocking while its buffer is full
+//  _q          :   multi-channel receiver
+//  _channel    :   channel index
+//  _x          :   input samples [size: _n x 1]
+//  _n          :   number of input samples
+void wlanrx_execute(wlanrx                 _q,
+                    unsigned int           _channel,
+                    liquid_float_complex * _x,
+                    unsigned int           _n);
+
+// block until every buffered sample has been processed and every
+// detected frame delivered
+void wlanrx_flush(wlanrx _q);
+
+// get number of input samples buffered for channel but not yet processed
+unsigned int wlanrx_get_backlog(wlanrx       _q,
+                                unsigned int _channel);
+
+// get number of frames detected on channel but not yet delivered
+unsigned int wlanrx_get_frame_backlog(wlanrx       _q,
+                                      unsigned int _channel);
+
+//
+// wide frame synchronizer
+//
+
+// forward declaration of wide frame synchronizer
+typedef struct wlanframesync_wide_s * wlanframesync_wide;
+
+// create frame synchronizer for many independent streams fed in
+// lockstep: idle streams are searched for frames together, one stream
+// per vector lane, and each stream hands off to its own wlanframesync
+// while a frame is received
+//  _num_lanes  :   number of streams, _num_lanes > 0
+//  _callback   :   user-defined callback function, invoked with the
+//                  stream index
+//  _userdata   :   user-defined data structure
+wlanframesync_wide wlanframesync_wide_create(unsigned int    _num_lanes,
+                                             wlanrx_callback _callback,
+                                             void *          _userdata);
+
+// destroy wide frame synchronizer object
+void wlanframesync_wide_destroy(wlanframesync_wide _q);
+
+// print wide frame synchronizer object internals
+void wlanframesync_wide_print(wlanframesync_wide _q);
+
+// reset wide frame synchronizer object internal state
+void wlanframesync_wide_reset(wlanframesync_wide _q);
+
+// execute wide frame synchronizer on the same number of samples from
+// every stream
+//  _q      :   wide frame synchronizer object
+//  _x      :   input for each stream [size: _num_lanes x _n]
+//  _n      :   number of input samples per stream
+void wlanframesync_wide_execute(wlanframesync_wide      _q,
+                                liquid_float_complex ** _x,
+                                unsigned int            _n);
+
+// get number of streams currently receiving a frame
+unsigned int wlanframesync_wide_get_num_active(wlanframesync_wide _q);
+
+//
+// wideband channelizer
+//
+
+// forward declaration of wideband channelizer
+typedef struct wlanchannelizer_s * wlanchannelizer;
+
+// create polyphase channelizer, splitting a stream sampled at _M x 20 MHz
+// into _M channel streams at 20 MHz; channel k is centered at
+// (k + _offset/2) x 20 MHz modulo the input rate, so channels above the
+// input Nyquist rate lie below the capture center
+//  _M      :   number of channels, _M > 0
+//  _m      :   filter semi-length (output samples), _m > 0, e.g. 12
+//  _offset :   channel centers offset by half a channel (e.g. an 80 MHz
+//              capture centered between four 20 MHz channels)?
+wlanchannelizer wlanchannelizer_create(unsigned int _M,
+                                       unsigned int _m,
+                                       int          _offset);
+
+// destroy channelizer (bound synchronizers are not destroyed)
+void wlanchannelizer_destroy(wlanchannelizer _q);
+
+// print channelizer object internals
+void wlanchannelizer_print(wlanchannelizer _q);
+
+// reset channelizer object internal state
+void wlanchannelizer_reset(wlanchannelizer _q);
+
+// bind frame synchronizer to channel
+//  _q          :   channelizer object
+//  _channel    :   channel index
+//  _fs         :   frame synchronizer (NULL to unbind)
+void wlanchannelizer_set_sync(wlanchannelizer _q,
+                              unsigned int    _channel,
+                              wlanframesync   _fs);
+
+// feed every channel into the same channel of a multi-channel receiver
+//  _q          :   channelizer object
+//  _rx         :   multi-channel receiver with at least M channels (NULL to unbind)
+void wlanchannelizer_set_rx(wlanchannelizer _q,
+                            wlanrx          _rx);
+
+// get number of output samples per channel produced by next _n input
+// samples
+unsigned int wlanchannelizer_get_num_output(wlanchannelizer _q,
+                                            unsigned int    _n);
+
+// execute channelizer on input block, feeding bound consumers
+//  _q          :   channelizer object
+//  _x          :   input samples [size: _n x 1]
+//  _n          :   number of input samples
+//  _y          :   output for each channel, or NULL to only feed bound
+//                  consumers [size: M x wlanchannelizer_get_num_output(_q,_n)]
+void wlanchannelizer_execute(wlanchannelizer         _q,
+                             liquid_float_complex *  _x,
+                             unsigned int            _n,
+                             liquid_float_complex ** _y);
+
+// execute channelizer on interleaved int16 I/Q input, scaled by 1/32768
+//  _q          :   channelizer object
+//  _x          :   input I/Q buffer [size: 2*_n x 1]
+//  _n          :   number of input samples
+//  _y          :   output for each channel, or NULL to only feed bound
+//                  consumers [size: M x wlanchannelizer_get_num_output(_q,_n)]
+void wlanchannelizer_execute_sc16(wlanchannelizer         _q,
+                                  int16_t *               _x,
+                                  unsigned int            _n,
+                                  liquid_float_complex ** _y);
+
+//
+// wideband synthesizer
+//
+
+// forward declaration of wideband synthesizer
+typedef struct wlansynthesizer_s * wlansynthesizer;
+
+// create polyphase synthesizer, combining _M channel streams at 20 MHz
+// into one stream sampled at _M x 20 MHz; channels are placed as for
+// wlanchannelizer_create(), which recovers them
+//  _M      :   number of channels, _M > 0
+//  _m      :   filter semi-length (input samples), _m > 0, e.g. 12
+//  _offset :   channel centers offset by half a channel?
+wlansynthesizer wlansynthesizer_create(unsigned int _M,
+                                       unsigned int _m,
+                                       int          _offset);
+
+// destroy synthesizer
+void wlansynthesizer_destroy(wlansynthesizer _q);
+
+// print synthesizer object internals
+void wlansynthesizer_print(wlansynthesizer _q);
+
+// reset synthesizer object internal state
+void wlansynthesizer_reset(wlansynthesizer _q);
+
+// execute synthesizer on a block of samples from each channel (e.g.
+// wlanframegen output)
+//  _q          :   synthesizer object
+//  _x          :   input for each channel, NULL for a silent channel
+//                  [size: M x _n]
+//  _n          :   number of input samples per channel
+//  _y          :   output samples [size: M*_n x 1]
+void wlansynthesizer_execute(wlansynthesizer         _q,
+                             liquid_float_complex ** _x,
+                             unsigned int            _n,
+                             liquid_float_complex *  _y);
+
+//
+// I/Q capture file reader
+//
+
+// capture sample formats
+#define LIQUID_WLAN_CAPTURE_AUTO        (0) // from SigMF metadata or file extension
+#define LIQUID_WLAN_CAPTURE_CF32        (1) // interleaved float I/Q
+#define LIQUID_WLAN_CAPTURE_SC16        (2) // interleaved int16 I/Q, full scale 32768
+#define LIQUID_WLAN_CAPTURE_SC8         (3) // interleaved int8 I/Q, full scale 128
+
+// capture reader options
+#define LIQUID_WLAN_CAPTURE_HUGE_PAGES  (1<<0)  // map with huge pages where supported
+
+// frame index entry status
+#define LIQUID_WLAN_CAPTURE_FRAME_DECODED   (0) // frame decoded
+#define LIQUID_WLAN_CAPTURE_FRAME_REJECTED  (1) // frame detected, SIGNAL field not valid
+
+// forward declaration of capture file reader
+typedef struct wlancapture_s * wlancapture;
+
+// open capture file, memory-mapped; with LIQUID_WLAN_CAPTURE_AUTO the
+// format is read from <name>.sigmf-meta (for <name>.sigmf-data or
+// <name>), else inferred from the extension (.cf32, .sc16, .sc8)
+//  _filename   :   capture file name
+//  _format     :   sample format, e.g. LIQUID_WLAN_CAPTURE_SC16
+//  _flags      :   options, e.g. LIQUID_WLAN_CAPTURE_HUGE_PAGES
+wlancapture wlancapture_open(const char * _filename,
+                             int          _format,
+                             unsigned int _flags);
+
+// close capture file
+void wlancapture_close(wlancapture _q);
+
+// print capture file reader object internals
+void wlancapture_print(wlancapture _q);
+
+// query methods
+int               wlancapture_get_format(wlancapture _q);       // sample format
+float             wlancapture_get_sample_rate(wlancapture _q);  // sample rate from metadata (0 if unknown)
+unsigned long int wlancapture_get_num_samples(wlancapture _q);  // number of samples
+
+// set position of next sample to read
+//  _q      :   capture file reader
+//  _sample :   sample index, _sample <= number of samples
+void wlancapture_seek(wlancapture       _q,
+                      unsigned long int _sample);
+
+// get next block of samples in the capture's own format directly from
+// the mapping (no copy), returning the number of samples (zero at end
+// of capture); the block is read-only
+//  _q      :   capture file reader
+//  _block  :   samples (output), e.g. interleaved int16 I/Q for sc16
+unsigned int wlancapture_read(wlancapture   _q,
+                              const void ** _block);
+
+// run next block of samples through frame synchronizer, converting
+// format as samples are consumed, returning the number of samples
+// (zero at end of capture)
+//  _q      :   capture file reader
+//  _fs     :   frame synchronizer
+unsigned int wlancapture_execute(wlancapture   _q,
+                                 wlanframesync _fs);
+
+// offline decoding callback
+//  _sample     :   index of the frame's first sample in the capture
+//  _payload    :   received payload
+//  _rxvector   :   received vector (see Table 77)
+//  _userdata   :   user-defined data object
+typedef int (*wlancapture_callback)(unsigned long int      _sample,
+                                    unsigned char *        _payload,
+                                    struct wlan_rxvector_s _rxvector,
+                                    void *                 _userdata);
+
+// decode every frame in a 20 MHz baseband capture (or any rate, with a
+// front-end set by wlancapture_set_config), independent of the
+// reading position: the capture is cut into overlapping segments which
+// are synchronized and decoded in parallel, and frames found twice near
+// segment boundaries are delivered once; the callback is invoked from
+// the calling thread in order of frame start. Returns number of frames.
+//  _q              :   capture file reader
+//  _num_threads    :   number of worker threads, _num_threads > 0
+//  _segment_len    :   samples per segment (0: default)
+//  _callback       :   user-defined callback function
+//  _userdata       :   user-defined data structure
+unsigned long int wlancapture_decode(wlancapture          _q,
+                                     unsigned int         _num_threads,
+                                     unsigned long int    _segment_len,
+                                     wlancapture_callback _callback,
+                                     void *               _userdata);
+
+// frame synchronizer configuration callback for offline decoding,
+// invoked once on each frame synchronizer as it is created, e.g. to set
+// a front-end (wlanframesync_set_frontend) for captures not at 20 MS/s;
+// frame start positions are reported in capture samples regardless
+//  _fs         :   frame synchronizer
+//  _userdata   :   user-defined data object
+typedef void (*wlancapture_config)(wlanframesync _fs,
+                                   void *        _userdata);
+
+// set configuration applied to each frame synchronizer created by
+// wlancapture_decode() and wlancapture_decode_index(); without one, a
+// capture whose metadata gives a sample rate other than 20 MS/s is
+// rejected
+//  _q          :   capture file reader
+//  _config     :   configuration callback (NULL: default synchronizer)
+//  _userdata   :   user-defined data structure passed to _config
+void wlancapture_set_config(wlancapture        _q,
+                            wlancapture_config _config,
+                            void *             _userdata);
+
+// set frame index file written by subsequent calls to
+// wlancapture_decode(): one entry per frame detected (sample index,
+// rssi, carrier offset, length, rate, status), including frames whose
+// SIGNAL field was not valid
+//  _q          :   capture file reader
+//  _filename   :   index file name (NULL: no index)
+void wlancapture_set_index(wlancapture  _q,
+                           const char * _filename);
+
+// re-decode frames listed in an index written by wlancapture_decode(),
+// synchronizing only a window around each entry rather than the whole
+// capture, with the configuration set by wlancapture_set_config(),
+// which may differ from the pass that wrote the index; frames whose
+// SIGNAL field was not valid are retried. The callback is invoked in
+// index order for each frame decoded. Returns number of frames.
+//  _q          :   capture file reader
+//  _filename   :   index file name
+//  _callback   :   user-defined callback function
+//  _userdata   :   user-defined data structure
+unsigned long int wlancapture_decode_index(wlancapture          _q,
+                                           const char *         _filename,
+                                           wlancapture_callback _callback,
+                                           void *               _userdata);
+
 
 #ifdef __cplusplus
 } /* extern "C" */
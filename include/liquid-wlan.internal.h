@@ -23,11 +23,143 @@
 // Configuration file
 #include "config.h"
 
+#include <stdio.h>
 #include <complex.h>
 #include <liquid/liquid.h>
 
+#ifdef __SSE__
+#   include <xmmintrin.h>
+#endif
+
 #include "liquid-wlan.h"
 
+//
+// run-time CPU feature dispatch
+//
+
+// SIMD kernels are built with function target attributes when run-time
+// dispatch is available; otherwise only those enabled by the compiler
+// flags are built, and the detected level never exceeds them
+#if HAVE_CPU_DISPATCH
+#   define LIQUID_WLAN_HAVE_SSE2    1
+#   define LIQUID_WLAN_HAVE_AVX2    1
+#   define LIQUID_WLAN_TARGET_SSE2  __attribute__((target("sse2")))
+#   define LIQUID_WLAN_TARGET_AVX2  __attribute__((target("avx2,bmi2")))
+#else
+#   if defined(__SSE2__)
+#       define LIQUID_WLAN_HAVE_SSE2 1
+#   else
+#       define LIQUID_WLAN_HAVE_SSE2 0
+#   endif
+#   if defined(__AVX2__) && defined(__BMI2__)
+#       define LIQUID_WLAN_HAVE_AVX2 1
+#   else
+#       define LIQUID_WLAN_HAVE_AVX2 0
+#   endif
+#   define LIQUID_WLAN_TARGET_SSE2
+#   define LIQUID_WLAN_TARGET_AVX2
+#endif
+
+// dispatched kernels, indexing wlan_cpu_s.impl
+#define WLAN_CPU_KERNEL_VITERBI27           (0) // Viterbi butterfly
+#define WLAN_CPU_KERNEL_FFT                 (1) // OFDM transform
+#define WLAN_CPU_KERNEL_MODEM               (2) // block mapper/demapper
+#define WLAN_CPU_KERNEL_INTERLEAVER         (3) // hard-bit interleaver
+#define WLAN_CPU_KERNEL_INTERLEAVER_SOFT    (4) // soft-bit de-interleaver
+#define WLAN_CPU_KERNEL_SCRAMBLER           (5) // data scrambler
+#define WLAN_CPU_KERNEL_REPACK              (6) // byte pack/unpack
+#define WLAN_CPU_KERNEL_SEEK                (7) // lane-parallel frame detection
+#define WLAN_CPU_NUM_KERNELS                (8)
+
+// kernel names, indexed by WLAN_CPU_KERNEL_*
+extern const char * const wlan_cpu_kernel_str[WLAN_CPU_NUM_KERNELS];
+
+// kernel dispatch table, filled once on first use and read-only
+// thereafter
+struct wlan_cpu_s {
+    unsigned int level;             // selected level (LIQUID_WLAN_CPU_*)
+    unsigned int level_detected;    // highest level supported by host
+    int pdep;                       // pext/pdep kernels selected?
+    const char * impl[WLAN_CPU_NUM_KERNELS];    // implementation names
+
+    // Viterbi decoder implementation (LIQUID_WLAN_CPU_GENERIC/SSE2)
+    unsigned int viterbi27;
+
+    // block mapper/demapper
+    void (*modulate_block)(const float complex * _table,
+                           unsigned int          _mask,
+                           unsigned char *       _sym,
+                           unsigned int          _n,
+                           float complex *       _x);
+    void (*demodulate_block)(const float *   _t,
+                             unsigned int    _nbits,
+                             float complex * _x,
+                             unsigned int    _n,
+                             unsigned char * _sym);
+
+    // interleaver
+    void (*interleaver_encode_symbol)(unsigned int    _rate,
+                                      unsigned char * _msg_dec,
+                                      unsigned char * _msg_enc);
+    void (*interleaver_decode_symbol)(unsigned int    _rate,
+                                      unsigned char * _msg_enc,
+                                      unsigned char * _msg_dec);
+    void (*interleaver_gather_soft)(const unsigned short * _idx,
+                                    unsigned char *        _buf,
+                                    unsigned int           _n,
+                                    unsigned char *        _soft_dec);
+
+    // data scrambler key stream application
+    void (*data_scramble_xor)(const unsigned char * _ks,
+                              unsigned char *       _x,
+                              unsigned int          _n,
+                              unsigned char *       _y);
+
+    // byte pack/unpack
+    unsigned int (*unpack_bytes)(unsigned char * _sym_in,
+                                 unsigned int    _sym_in_len,
+                                 unsigned char * _sym_out,
+                                 unsigned int    _bps);
+    unsigned int (*pack_bytes)(unsigned char * _sym_in,
+                               unsigned int    _sym_in_len,
+                               unsigned char * _sym_out,
+                               unsigned int    _bps);
+
+    // lane-parallel frame detection metrics
+    void (*seek_metrics)(const float * _x,
+                         unsigned int  _stride,
+                         const float * _w,
+                         float *       _s);
+};
+
+// get kernel dispatch table, detecting host features and applying the
+// LIQUID_WLAN_CPU environment override on first use
+const struct wlan_cpu_s * wlan_cpu_get(void);
+
+// detect highest feature level supported by host
+unsigned int wlan_cpu_detect(void);
+
+// detect whether host executes pext/pdep quickly
+int wlan_cpu_detect_pdep(void);
+
+// apply LIQUID_WLAN_CPU override, a comma-separated list in which a
+// level name lowers the level and "nopdep" disables the pext/pdep
+// kernels; unknown entries are ignored
+//  _s          :   override string, e.g. "avx2,nopdep"
+//  _level      :   feature level (LIQUID_WLAN_CPU_*), lowered in place
+//  _pdep       :   pext/pdep kernels enabled?, cleared in place
+void wlan_cpu_override(const char *   _s,
+                       unsigned int * _level,
+                       int *          _pdep);
+
+// fill dispatch table for feature level
+//  _q          :   dispatch table
+//  _level      :   feature level (LIQUID_WLAN_CPU_*)
+//  _pdep       :   use pext/pdep kernels at level LIQUID_WLAN_CPU_AVX2?
+void wlan_cpu_init(struct wlan_cpu_s * _q,
+                   unsigned int        _level,
+                   int                 _pdep);
+
 //
 // utility
 //
@@ -58,6 +190,89 @@ void liquid_wlan_repack_bytes(unsigned char * _sym_in,
                               unsigned int    _sym_out_len,
                               unsigned int *  _num_written);
 
+// repack bytes with arbitrary symbol sizes, one bit at a time (see
+// liquid_wlan_repack_bytes)
+void liquid_wlan_repack_bytes_generic(unsigned char * _sym_in,
+                                      unsigned int    _sym_in_bps,
+                                      unsigned int    _sym_in_len,
+                                      unsigned char * _sym_out,
+                                      unsigned int    _sym_out_bps,
+                                      unsigned int    _sym_out_len,
+                                      unsigned int *  _num_written);
+
+// unpack bytes into 1, 2, 4, or 6-bit symbols, most-significant bit
+// first, returning number of symbols written
+//  _sym_in     :   input bytes [size: _sym_in_len x 1]
+//  _sym_in_len :   number of input bytes
+//  _sym_out    :   output symbols [size: ceil(8*_sym_in_len/_bps) x 1]
+//  _bps        :   bits per output symbol
+unsigned int liquid_wlan_unpack_bytes(unsigned char * _sym_in,
+                                      unsigned int    _sym_in_len,
+                                      unsigned char * _sym_out,
+                                      unsigned int    _bps);
+
+// pack 1, 2, 4, or 6-bit symbols into bytes, most-significant bit
+// first, returning number of bytes written
+//  _sym_in     :   input symbols [size: _sym_in_len x 1]
+//  _sym_in_len :   number of input symbols
+//  _sym_out    :   output bytes [size: ceil(_bps*_sym_in_len/8) x 1]
+//  _bps        :   bits per input symbol
+unsigned int liquid_wlan_pack_bytes(unsigned char * _sym_in,
+                                    unsigned int    _sym_in_len,
+                                    unsigned char * _sym_out,
+                                    unsigned int    _bps);
+
+// unpack/pack kernels (see liquid_wlan_unpack_bytes/_pack_bytes)
+unsigned int liquid_wlan_unpack_bytes_generic(unsigned char * _sym_in,
+                                              unsigned int    _sym_in_len,
+                                              unsigned char * _sym_out,
+                                              unsigned int    _bps);
+unsigned int liquid_wlan_pack_bytes_generic(unsigned char * _sym_in,
+                                            unsigned int    _sym_in_len,
+                                            unsigned char * _sym_out,
+                                            unsigned int    _bps);
+#if LIQUID_WLAN_HAVE_AVX2
+unsigned int liquid_wlan_unpack_bytes_bmi2(unsigned char * _sym_in,
+                                           unsigned int    _sym_in_len,
+                                           unsigned char * _sym_out,
+                                           unsigned int    _bps);
+unsigned int liquid_wlan_pack_bytes_bmi2(unsigned char * _sym_in,
+                                         unsigned int    _sym_in_len,
+                                         unsigned char * _sym_out,
+                                         unsigned int    _bps);
+#endif
+
+// convert complex float samples to interleaved int16 I/Q, scaling,
+// rounding to nearest and saturating
+//  _x          :   input samples [size: _n x 1]
+//  _n          :   number of samples
+//  _scale      :   scaling factor
+//  _y          :   output I/Q pairs [size: 2*_n x 1]
+void liquid_wlan_cf_to_sc16(float complex * _x,
+                            unsigned int    _n,
+                            float           _scale,
+                            int16_t *       _y);
+
+// convert interleaved int16 I/Q to complex float samples
+//  _x          :   input I/Q pairs [size: 2*_n x 1]
+//  _n          :   number of samples
+//  _scale      :   scaling factor
+//  _y          :   output samples [size: _n x 1]
+void liquid_wlan_sc16_to_cf(int16_t *       _x,
+                            unsigned int    _n,
+                            float           _scale,
+                            float complex * _y);
+
+// convert interleaved int8 I/Q to complex float samples
+//  _x          :   input I/Q pairs [size: 2*_n x 1]
+//  _n          :   number of samples
+//  _scale      :   scaling factor
+//  _y          :   output samples [size: _n x 1]
+void liquid_wlan_sc8_to_cf(int8_t *        _x,
+                           unsigned int    _n,
+                           float           _scale,
+                           float complex * _y);
+
 // Use fftw library if installed, otherwise use liquid-dsp (less
 // efficient) fft library.
 #if HAVE_FFTW3_H
@@ -174,6 +389,28 @@ unsigned int wlan_lfsr_generate_symbol(wlan_lfsr _ms,
 // reset wlan_lfsr shift register to original state, typically '1'
 void wlan_lfsr_reset(wlan_lfsr _ms);
 
+// advance wlan_lfsr by _n steps without generating intermediate bits
+//  _ms     :   m-sequence object
+//  _n      :   number of steps
+void wlan_lfsr_jump(wlan_lfsr    _ms,
+                    unsigned int _n);
+
+// advance shift register state by one step
+//  _v      :   shift register state
+//  _g      :   generator polynomial (most significant bit removed)
+//  _n      :   register mask, (2^m)-1
+unsigned int wlan_lfsr_step(unsigned int _v,
+                            unsigned int _g,
+                            unsigned int _n);
+
+// multiply GF(2) matrix by vector
+//  _A      :   matrix columns [size: _m x 1]
+//  _m      :   matrix dimension
+//  _v      :   input vector
+unsigned int wlan_lfsr_matvec(unsigned int * _A,
+                              unsigned int   _m,
+                              unsigned int   _v);
+
 // 
 // encoding/decoding
 //
@@ -191,7 +428,7 @@ void wlan_lfsr_reset(wlan_lfsr _ms);
 
 // generic interface
 void * wlan_create_viterbi27(int len);
-void wlan_set_viterbi27_polynomial(int polys[2]);
+void wlan_set_viterbi27_polynomial(void *vp,int polys[2]);
 int wlan_init_viterbi27(void *vp,int starting_state);
 int wlan_update_viterbi27_blk(void *vp,unsigned char sym[],int npairs);
 int wlan_chainback_viterbi27(void *vp, unsigned char *data,unsigned int nbits,unsigned int endstate);
@@ -199,12 +436,22 @@ void wlan_delete_viterbi27(void *vp);
 
 // portable C interface
 void * wlan_create_viterbi27_port(int len);
-void wlan_set_viterbi27_polynomial_port(int polys[2]);
+void wlan_set_viterbi27_polynomial_port(void *p,int polys[2]);
 int wlan_init_viterbi27_port(void *p,int starting_state);
 int wlan_chainback_viterbi27_port(void *p,unsigned char *data,unsigned int nbits,unsigned int endstate);
 void wlan_delete_viterbi27_port(void *p);
 int wlan_update_viterbi27_blk_port(void *p,unsigned char *syms,int nbits);
 
+#if LIQUID_WLAN_HAVE_SSE2
+// SSE2 interface
+void * wlan_create_viterbi27_sse2(int len);
+void wlan_set_viterbi27_polynomial_sse2(void *p,int polys[2]);
+int wlan_init_viterbi27_sse2(void *p,int starting_state);
+int wlan_chainback_viterbi27_sse2(void *p,unsigned char *data,unsigned int nbits,unsigned int endstate);
+void wlan_delete_viterbi27_sse2(void *p);
+int wlan_update_viterbi27_blk_sse2(void *p,unsigned char *syms,int nbits);
+#endif
+
 static inline int parity(int x){
   /* Fold down to one byte */
   x ^= (x >> 16);
@@ -233,6 +480,15 @@ extern const unsigned  int wlanconv_genpoly[2];         // r1/2 base generator p
 extern const unsigned char wlanconv_v27p23_pmatrix[12]; // r2/3 puncturing matrix
 extern const unsigned char wlanconv_v27p34_pmatrix[18]; // r3/4 puncturing matrix
 
+// puncturing matrix rows as bit masks (bit j set when column j is 1),
+// for codecs specialized at compile time
+#define WLANCONV_V27P12_MASK0   (0x001)
+#define WLANCONV_V27P12_MASK1   (0x001)
+#define WLANCONV_V27P23_MASK0   (0x03f)
+#define WLANCONV_V27P23_MASK1   (0x015)
+#define WLANCONV_V27P34_MASK0   (0x0db)
+#define WLANCONV_V27P34_MASK1   (0x16d)
+
 #define LIQUID_WLAN_FEC_R1_2    (0) // r1/2
 #define LIQUID_WLAN_FEC_R2_3    (1) // r2/3
 #define LIQUID_WLAN_FEC_R3_4    (2) // r3/4
@@ -270,6 +526,15 @@ void wlan_fec_decode(unsigned int    _fec_scheme,
                      unsigned char * _msg_enc,
                      unsigned char * _msg_dec);
 
+// decode de-punctured soft bits using convolutional code, terminating
+// in the zero state with the tail bits
+//  _nbits      :   number of data bits preceding tail
+//  _soft       :   de-punctured soft bits [size: 2*(_nbits+6) x 1]
+//  _msg_dec    :   decoded message [size: ceil(_nbits/8) x 1]
+void wlan_fec_decode_soft(unsigned int    _nbits,
+                          unsigned char * _soft,
+                          unsigned char * _msg_dec);
+
 
 //
 // data scrambler/de-scrambler
@@ -295,6 +560,33 @@ void wlan_data_unscramble(unsigned char * _msg_enc,
                           unsigned int _n,
                           unsigned int _seed);
 
+// scrambler sequence period (bytes); the 127-bit sequence repeats
+// every 127 bytes
+#define WLAN_DATA_SCRAMBLER_PERIOD  (127)
+
+// apply scrambler key stream to data
+//  _ks         :   key stream, one period followed by its first 32
+//                  bytes [size: WLAN_DATA_SCRAMBLER_PERIOD+32 x 1]
+//  _x          :   input data [size: _n x 1]
+//  _n          :   length of input/output (bytes)
+//  _y          :   output data [size: _n x 1]
+void wlan_data_scramble_xor_generic(const unsigned char * _ks,
+                                    unsigned char *       _x,
+                                    unsigned int          _n,
+                                    unsigned char *       _y);
+#if LIQUID_WLAN_HAVE_SSE2
+void wlan_data_scramble_xor_sse2(const unsigned char * _ks,
+                                 unsigned char *       _x,
+                                 unsigned int          _n,
+                                 unsigned char *       _y);
+#endif
+#if LIQUID_WLAN_HAVE_AVX2
+void wlan_data_scramble_xor_avx2(const unsigned char * _ks,
+                                 unsigned char *       _x,
+                                 unsigned int          _n,
+                                 unsigned char *       _y);
+#endif
+
 //
 // interleaver
 //
@@ -308,17 +600,32 @@ struct wlan_interleaver_tab_s {
 };
 
 // external auto-generated structured interleaver tables (see liquid-wlan/src/gentab)
-extern struct wlan_interleaver_tab_s wlan_intlv_R6[48];
-extern struct wlan_interleaver_tab_s wlan_intlv_R9[48];
-extern struct wlan_interleaver_tab_s wlan_intlv_R12[96];
-extern struct wlan_interleaver_tab_s wlan_intlv_R18[96];
-extern struct wlan_interleaver_tab_s wlan_intlv_R24[192];
-extern struct wlan_interleaver_tab_s wlan_intlv_R36[192];
-extern struct wlan_interleaver_tab_s wlan_intlv_R48[288];
-extern struct wlan_interleaver_tab_s wlan_intlv_R54[288];
+extern const struct wlan_interleaver_tab_s wlan_intlv_R6[48];
+extern const struct wlan_interleaver_tab_s wlan_intlv_R9[48];
+extern const struct wlan_interleaver_tab_s wlan_intlv_R12[96];
+extern const struct wlan_interleaver_tab_s wlan_intlv_R18[96];
+extern const struct wlan_interleaver_tab_s wlan_intlv_R24[192];
+extern const struct wlan_interleaver_tab_s wlan_intlv_R36[192];
+extern const struct wlan_interleaver_tab_s wlan_intlv_R48[288];
+extern const struct wlan_interleaver_tab_s wlan_intlv_R54[288];
 
 // indexable table of above structured auto-generated tables
-extern struct wlan_interleaver_tab_s * wlan_intlv_gentab[8];
+extern const struct wlan_interleaver_tab_s * const wlan_intlv_gentab[8];
+
+// external auto-generated soft de-interleaver index tables (see
+// liquid-wlan/src/gentab); each entry gives the interleaved index of
+// the de-punctured coded bit, or ncbps for an erasure
+extern const unsigned short wlan_intlv_soft_R6[48];
+extern const unsigned short wlan_intlv_soft_R9[72];
+extern const unsigned short wlan_intlv_soft_R12[96];
+extern const unsigned short wlan_intlv_soft_R18[144];
+extern const unsigned short wlan_intlv_soft_R24[192];
+extern const unsigned short wlan_intlv_soft_R36[288];
+extern const unsigned short wlan_intlv_soft_R48[384];
+extern const unsigned short wlan_intlv_soft_R54[432];
+
+// indexable table of above soft de-interleaver tables
+extern const unsigned short * const wlan_intlv_soft_gentab[8];
 
 // intereleave one OFDM symbol
 //  _rate       :   primitive rate
@@ -336,6 +643,52 @@ void wlan_interleaver_decode_symbol(unsigned int    _rate,
                                     unsigned char * _msg_dec,
                                     unsigned char * _msg_enc);
 
+// intereleave/de-interleave one OFDM symbol one bit at a time using
+// structured table (portable)
+void wlan_interleaver_encode_symbol_tab(unsigned int    _rate,
+                                        unsigned char * _msg_dec,
+                                        unsigned char * _msg_enc);
+void wlan_interleaver_decode_symbol_tab(unsigned int    _rate,
+                                        unsigned char * _msg_enc,
+                                        unsigned char * _msg_dec);
+
+// de-interleave one OFDM symbol of soft bits (one byte per bit),
+// inserting erasures at punctured indices; output is ready for the
+// Viterbi decoder
+//  _rate       :   primitive rate
+//  _soft_enc   :   interleaved soft bits [size: ncbps x 1]
+//  _soft_dec   :   de-punctured soft bits [size: 2*ndbps x 1]
+void wlan_interleaver_decode_symbol_soft(unsigned int    _rate,
+                                         unsigned char * _soft_enc,
+                                         unsigned char * _soft_dec);
+
+// gather soft bits by index (see wlan_interleaver_decode_symbol_soft)
+//  _idx        :   gather indices [size: _n x 1]
+//  _buf        :   soft bits with erasure appended, padded by three bytes
+//  _n          :   number of output soft bits, multiple of eight
+//  _soft_dec   :   output soft bits [size: _n x 1]
+void wlan_interleaver_gather_soft_generic(const unsigned short * _idx,
+                                          unsigned char *        _buf,
+                                          unsigned int           _n,
+                                          unsigned char *        _soft_dec);
+#if LIQUID_WLAN_HAVE_AVX2
+void wlan_interleaver_gather_soft_avx2(const unsigned short * _idx,
+                                       unsigned char *        _buf,
+                                       unsigned int           _n,
+                                       unsigned char *        _soft_dec);
+#endif
+
+#if LIQUID_WLAN_HAVE_AVX2
+// intereleave/de-interleave one OFDM symbol using 64-bit words with
+// bit permutation instructions
+void wlan_interleaver_encode_symbol_word(unsigned int    _rate,
+                                         unsigned char * _msg_dec,
+                                         unsigned char * _msg_enc);
+void wlan_interleaver_decode_symbol_word(unsigned int    _rate,
+                                         unsigned char * _msg_enc,
+                                         unsigned char * _msg_dec);
+#endif
+
 
 //
 // high-level packet encoder/decoder
@@ -359,6 +712,38 @@ void wlan_packet_decode(unsigned int    _rate,
                         unsigned char * _msg_enc,
                         unsigned char * _msg_dec);
 
+// de-interleave soft bits, decode, de-scramble, extract data
+//  _rate       :   primitive rate
+//  _seed       :   data scrambler seed
+//  _length     :   original data length (bytes)
+//  _soft_enc   :   interleaved soft bits [size: nsym*ncbps x 1]
+//  _msg_dec    :   decoded data [size: _length x 1]
+void wlan_packet_decode_soft(unsigned int    _rate,
+                             unsigned int    _seed,
+                             unsigned int    _length,
+                             unsigned char * _soft_enc,
+                             unsigned char * _msg_dec);
+
+// packet codec specialized for one rate, with symbol sizes and
+// puncturing pattern fixed at compile time
+struct wlan_packet_codec_s {
+    void (*encode)(unsigned int    _seed,
+                   unsigned int    _length,
+                   unsigned char * _msg_dec,
+                   unsigned char * _msg_enc);
+    void (*decode)(unsigned int    _seed,
+                   unsigned int    _length,
+                   unsigned char * _msg_enc,
+                   unsigned char * _msg_dec);
+    void (*decode_soft)(unsigned int    _seed,
+                        unsigned int    _length,
+                        unsigned char * _soft_enc,
+                        unsigned char * _msg_dec);
+};
+
+// rate-specialized codecs, indexed by rate (e.g. WLANFRAME_RATE_36)
+extern const struct wlan_packet_codec_s wlan_packet_codec[8];
+
 // 
 // modem (modulation/demodulation)
 //
@@ -368,6 +753,8 @@ void wlan_packet_decode(unsigned int    _rate,
 #define WLAN_MODEM_QAM16    (2)
 #define WLAN_MODEM_QAM64    (3)
 
+extern const float complex wlan_modem_bpsk[2];
+extern const float complex wlan_modem_qpsk[4];
 extern const float complex wlan_modem_qam16[16];
 extern const float complex wlan_modem_qam64[64];
 
@@ -387,6 +774,54 @@ unsigned char wlan_demodulate_qpsk(float complex _sample);
 unsigned char wlan_demodulate_qam16(float complex _sample);
 unsigned char wlan_demodulate_qam64(float complex _sample);
 
+// modulate block of symbols
+//  _scheme     :   modulation scheme (e.g. WLAN_MODEM_QAM16)
+//  _sym        :   input symbols [size: _n x 1]
+//  _n          :   number of symbols
+//  _x          :   output samples [size: _n x 1]
+void wlan_modulate_block(unsigned int    _scheme,
+                         unsigned char * _sym,
+                         unsigned int    _n,
+                         float complex * _x);
+
+// demodulate block of samples (hard decision)
+//  _scheme     :   modulation scheme (e.g. WLAN_MODEM_QAM16)
+//  _x          :   input samples [size: _n x 1]
+//  _n          :   number of samples
+//  _sym        :   output symbols [size: _n x 1]
+void wlan_demodulate_block(unsigned int    _scheme,
+                           float complex * _x,
+                           unsigned int    _n,
+                           unsigned char * _sym);
+
+// block mapper/demapper kernels for multi-bit schemes
+//  _table      :   modulation table
+//  _mask       :   symbol mask
+//  _t          :   decision thresholds, largest first [size: _nbits-1 x 1]
+//  _nbits      :   bits per dimension
+void wlan_modulate_block_generic(const float complex * _table,
+                                 unsigned int          _mask,
+                                 unsigned char *       _sym,
+                                 unsigned int          _n,
+                                 float complex *       _x);
+void wlan_demodulate_block_generic(const float *   _t,
+                                   unsigned int    _nbits,
+                                   float complex * _x,
+                                   unsigned int    _n,
+                                   unsigned char * _sym);
+#if LIQUID_WLAN_HAVE_AVX2
+void wlan_modulate_block_avx2(const float complex * _table,
+                              unsigned int          _mask,
+                              unsigned char *       _sym,
+                              unsigned int          _n,
+                              float complex *       _x);
+void wlan_demodulate_block_avx2(const float *   _t,
+                                unsigned int    _nbits,
+                                float complex * _x,
+                                unsigned int    _n,
+                                unsigned char * _sym);
+#endif
+
 
 // 
 // wlan framing
@@ -404,6 +839,95 @@ extern const float complex wlanframe_s1[64]; // time
 #define WLANFRAME_SCTYPE_PILOT  1
 #define WLANFRAME_SCTYPE_DATA   2
 
+// DATA subcarrier indices in order of transmission
+extern const unsigned char wlanframe_data_subcarriers[48];
+
+// pilot polarity sequence (1 denotes inverted pilots), indexed by OFDM
+// symbol number starting with SIGNAL, cyclic with period 127
+#define WLANFRAME_PILOT_PERIOD  (127)
+extern const unsigned char wlanframe_pilot_polarity[WLANFRAME_PILOT_PERIOD];
+
+//
+// filter dot product
+//
+
+// compute dot product of real filter with complex input; each tap is
+// duplicated so that the product runs over plain floats
+//  _h          :   filter, duplicated taps [size: 2*_n x 1]
+//  _x          :   input samples [size: _n x 1]
+//  _n          :   number of taps (even)
+static inline float complex wlan_dotprod_crcf(float *         _h,
+                                              float complex * _x,
+                                              unsigned int    _n)
+{
+    float * x = (float*) _x;
+    unsigned int i;
+#ifdef __SSE__
+    // four floats (two complex samples) at a time
+    __m128 acc = _mm_setzero_ps();
+    for (i=0; i<2*_n; i+=4)
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(&_h[i]), _mm_loadu_ps(&x[i])));
+    float v[4];
+    _mm_storeu_ps(v, acc);
+    return (v[0] + v[2]) + _Complex_I*(v[1] + v[3]);
+#else
+    float y0 = 0.0f, y1 = 0.0f, y2 = 0.0f, y3 = 0.0f;
+    for (i=0; i<2*_n; i+=4) {
+        y0 += _h[i+0] * x[i+0];
+        y1 += _h[i+1] * x[i+1];
+        y2 += _h[i+2] * x[i+2];
+        y3 += _h[i+3] * x[i+3];
+    }
+    return (y0 + y2) + _Complex_I*(y1 + y3);
+#endif
+}
+
+//
+// polyphase rational resampler
+//
+
+typedef struct wlan_resamp_s * wlan_resamp;
+
+// create rational resampler object, resampling by _P/_Q
+//  _P          :   interpolation factor, _P > 0
+//  _Q          :   decimation factor, _Q > 0
+//  _m          :   filter semi-length (input samples), _m > 0
+wlan_resamp wlan_resamp_create(unsigned int _P,
+                               unsigned int _Q,
+                               unsigned int _m);
+
+// destroy rational resampler object
+void wlan_resamp_destroy(wlan_resamp _q);
+
+// reset rational resampler object internal state
+void wlan_resamp_reset(wlan_resamp _q);
+
+// set frequency by which the input is mixed down as it enters the
+// filter, in cycles per input sample; zero disables mixing
+//  _q          :   resampler object
+//  _f          :   mixing frequency, -0.5 <= _f <= 0.5
+void wlan_resamp_set_frequency(wlan_resamp _q,
+                               float       _f);
+
+// get number of output samples produced by next _n input samples
+unsigned int wlan_resamp_get_num_output(wlan_resamp  _q,
+                                        unsigned int _n);
+
+// execute rational resampler on input block
+//  _q          :   resampler object
+//  _x          :   input samples [size: _nx x 1]
+//  _nx         :   number of input samples
+//  _y          :   output samples [size: wlan_resamp_get_num_output(_q,_nx) x 1]
+//  _ny         :   number of output samples written
+void wlan_resamp_execute(wlan_resamp     _q,
+                         float complex * _x,
+                         unsigned int    _nx,
+                         float complex * _y,
+                         unsigned int *  _ny);
+
+// zeroth-order modified Bessel function of the first kind
+float wlan_resamp_besseli0(float _x);
+
 //
 // wi-fi frame generator (internal methods)
 //
@@ -411,7 +935,10 @@ extern const float complex wlanframe_s1[64]; // time
 // compute symbol: add/update pilots, add nulls and compute transform
 //  * input stored in 'X' (internal ifft input)
 //  * output stored in 'x' (internal ifft output)
-void wlanframegen_compute_symbol(wlanframegen _q);
+//  _q          :   framing generator object
+//  _n          :   OFDM symbol index (0 for SIGNAL)
+void wlanframegen_compute_symbol(wlanframegen _q,
+                                 unsigned int _n);
 
 // generate symbol (add cyclic prefix/postfix, overlap)
 //  _x          :   input time-domain symbol [size: 64 x 1]
@@ -426,6 +953,54 @@ void wlanframegen_gensymbol(float complex * _x,
                             unsigned int    _p,
                             float complex * _symbol);
 
+// load DATA symbol onto subcarriers, adding pilots and applying gain
+//  _q          :   framing generator object
+//  _n          :   DATA symbol index
+//  _X          :   frequency-domain output (NULL subcarriers untouched) [size: 64 x 1]
+void wlanframegen_load_data_symbol(wlanframegen    _q,
+                                   unsigned int    _n,
+                                   float complex * _X);
+
+// generate multiple DATA symbols, writing prefixed, windowed samples
+// directly to output buffer
+//  _q          :   framing generator object
+//  _n          :   index of first DATA symbol
+//  _num        :   number of DATA symbols to generate
+//  _buffer     :   output sample buffer [size: 80*_num x 1]
+void wlanframegen_gensymbols_data(wlanframegen    _q,
+                                  unsigned int    _n,
+                                  unsigned int    _num,
+                                  float complex * _buffer);
+
+// write OFDM symbol before interpolation, returning '1' when frame is
+// complete
+//  _q          :   framing generator object
+//  _buffer     :   output sample buffer [size: 80 x 1]
+int wlanframegen_writesymbol_base(wlanframegen    _q,
+                                  float complex * _buffer);
+
+// write entire frame before interpolation
+//  _q          :   framing generator object
+//  _buffer     :   output sample buffer [size: 80*(6+nsym) x 1]
+void wlanframegen_write_frame_base(wlanframegen    _q,
+                                   float complex * _buffer);
+
+// copy pre-computed preamble symbol(s) to buffer, updating post-fix
+//  _q          :   framing generator object
+//  _k          :   index of first preamble symbol (0:S0a, 1:S0b, 2:S1a, 3:S1b)
+//  _num        :   number of symbols to copy
+//  _buffer     :   output sample buffer [size: 80*_num x 1]
+void wlanframegen_copy_preamble(wlanframegen    _q,
+                                unsigned int    _k,
+                                unsigned int    _num,
+                                float complex * _buffer);
+
+// pack, encode, and interleave SIGNAL field
+void wlanframegen_encode_signal(wlanframegen _q);
+
+// generate SIGNAL symbol (bypassing cache)
+void wlanframegen_gensymbol_signal(wlanframegen _q, float complex * _buffer);
+
 void wlanframegen_writesymbol_S0a(wlanframegen _q, float complex * _buffer);
 void wlanframegen_writesymbol_S0b(wlanframegen _q, float complex * _buffer);
 void wlanframegen_writesymbol_S1a(wlanframegen _q, float complex * _buffer);
@@ -434,6 +1009,14 @@ void wlanframegen_writesymbol_signal(wlanframegen _q, float complex * _buffer);
 void wlanframegen_writesymbol_data(wlanframegen _q, float complex * _buffer);
 void wlanframegen_writesymbol_null(wlanframegen _q, float complex * _buffer);
 
+//
+// wi-fi frame generation pool (internal methods)
+//
+
+// worker thread: claim jobs in order and generate frames
+//  _arg        :   worker object
+void * wlanframegen_pool_worker(void * _arg);
+
 //
 // wi-fi frame synchronizer (internal methods)
 //
@@ -446,6 +1029,24 @@ void wlanframesync_execute_rxlong1(wlanframesync _q);
 void wlanframesync_execute_rxsignal(wlanframesync _q);
 void wlanframesync_execute_rxdata(wlanframesync _q);
 
+// capture DATA field samples for the decoding pool, returning the
+// number of samples consumed
+//  _q      :   frame synchronizer object
+//  _x      :   input samples [size: _n x 1]
+//  _n      :   number of input samples
+unsigned int wlanframesync_execute_rxspan(wlanframesync   _q,
+                                          float complex * _x,
+                                          unsigned int    _n);
+
+// execute framing synchronizer on 20 MHz baseband samples, after the
+// front-end (if any)
+//  _q      :   frame synchronizer object
+//  _buffer :   input samples [size: _n x 1]
+//  _n      :   number of input samples
+void wlanframesync_execute_baseband(wlanframesync   _q,
+                                    float complex * _buffer,
+                                    unsigned int    _n);
+
 // estimate short sequence gain
 //  _q      :   wlanframesync object
 //  _x      :   input array (time), [size: M x 1]
@@ -483,11 +1084,490 @@ float wlanframesync_estimate_cfo_S1(float complex * _G1a,
 // estimate equalizer gain from internal S1 gains using polynomial
 void wlanframesync_estimate_eqgain_poly(wlanframesync _q);
 
-// recover symbol, correcting for gain, pilot phase, etc.
-void wlanframesync_rxsymbol(wlanframesync _q);
+// recover symbol, correcting for gain, pilot phase, etc., returning the
+// pilot phase difference relative to the previous symbol
+//  _X          :   frequency-domain symbol, corrected in place [size: 64 x 1]
+//  _R          :   complex channel correction [size: 64 x 1]
+//  _n          :   OFDM symbol index (0 for SIGNAL)
+//  _phi_prime  :   stored pilot phase, updated on return
+float wlanframesync_rxsymbol(float complex *       _X,
+                             const float complex * _R,
+                             unsigned int          _n,
+                             float *               _phi_prime);
 
 // decode SIGNAL field
 void wlanframesync_decode_signal(wlanframesync _q);
 
+//
+// wi-fi frame synchronizer DATA field receiver (internal object)
+//
+
+typedef struct wlanframesync_rxdata_s * wlanframesync_rxdata;
+
+// create DATA field receiver
+wlanframesync_rxdata wlanframesync_rxdata_create();
+
+// destroy DATA field receiver
+void wlanframesync_rxdata_destroy(wlanframesync_rxdata _q);
+
+// initialize DATA field receiver for a new frame
+//  _q          :   DATA field receiver
+//  _rate       :   primitive data rate
+//  _seed       :   data scrambler seed
+//  _length     :   original data length (bytes)
+//  _rssi       :   received signal strength indicator
+//  _R          :   complex channel correction [size: 64 x 1]
+//  _phi_prime  :   pilot phase of SIGNAL field
+//  _nu         :   carrier frequency offset at start of DATA field
+//  _theta      :   carrier phase at start of DATA field
+void wlanframesync_rxdata_init(wlanframesync_rxdata  _q,
+                               unsigned int          _rate,
+                               unsigned int          _seed,
+                               unsigned int          _length,
+                               unsigned int          _rssi,
+                               const float complex * _R,
+                               float                 _phi_prime,
+                               float                 _nu,
+                               float                 _theta);
+
+// receive DATA symbol, returning 1 once every symbol has been received
+//  _q      :   DATA field receiver
+//  _x      :   symbol samples, cyclic prefix first [size: 80 x 1]
+int wlanframesync_rxdata_execute(wlanframesync_rxdata _q,
+                                 float complex *      _x);
+
+// receive transformed DATA symbol, after carrier offset correction,
+// returning 1 once every symbol has been received
+//  _q      :   DATA field receiver
+//  _X      :   frequency-domain symbol, corrected in place [size: 64 x 1]
+//  _dphi   :   pilot phase difference relative to previous symbol (output)
+int wlanframesync_rxdata_execute_freq(wlanframesync_rxdata _q,
+                                      float complex *      _X,
+                                      float *              _dphi);
+
+// decode received DATA field, returning the payload (valid until the
+// receiver is next initialized)
+//  _q          :   DATA field receiver
+//  _rxvector   :   received vector (output)
+unsigned char * wlanframesync_rxdata_decode(wlanframesync_rxdata     _q,
+                                            struct wlan_rxvector_s * _rxvector);
+
+//
+// wi-fi frame decoding pool (internal object)
+//
+
+typedef struct wlanframesync_pool_s * wlanframesync_pool;
+
+// captured frame slot
+struct wlanframesync_pool_frame_s {
+    // frame parameters (from SIGNAL field)
+    unsigned int rate;              // primitive data rate
+    unsigned int seed;              // data scrambler seed
+    unsigned int length;            // original data length (bytes)
+    unsigned int rssi;              // received signal strength indicator
+
+    // estimates at start of DATA field
+    float complex R[64];            // complex channel correction
+    float phi_prime;                // pilot phase of SIGNAL field
+    float nu;                       // carrier frequency offset
+    float theta;                    // carrier phase
+
+    // DATA field samples, symbol-aligned, carrier offset not corrected
+    float complex * span;           // samples
+    unsigned int span_len;          // number of samples in DATA field
+    unsigned int span_alloc;        // number of samples allocated
+    unsigned int num_samples;       // number of samples captured
+
+    // decoded frame
+    unsigned char payload[4095];    // decoded payload
+    struct wlan_rxvector_s rxvector;// received vector
+    int done;                       // decoded but not yet delivered (lock)
+};
+
+// create frame decoding pool
+//  _callback       :   user-defined callback function
+//  _userdata       :   user-defined data structure
+//  _num_threads    :   number of worker threads (0: externally scheduled)
+//  _num_slots      :   number of frames in flight, _num_slots > 0
+wlanframesync_pool wlanframesync_pool_create(wlanframesync_callback _callback,
+                                             void *                 _userdata,
+                                             unsigned int           _num_threads,
+                                             unsigned int           _num_slots);
+
+// destroy frame decoding pool, delivering every submitted frame first
+void wlanframesync_pool_destroy(wlanframesync_pool _q);
+
+// frame submission notification for externally scheduled pool
+typedef void (*wlanframesync_pool_notify)(void * _arg);
+
+// set notification for externally scheduled pool, invoked from the
+// synchronizer's thread each time a frame is submitted
+//  _q          :   frame decoding pool
+//  _notify     :   notification function
+//  _arg        :   notification argument
+void wlanframesync_pool_set_notify(wlanframesync_pool        _q,
+                                   wlanframesync_pool_notify _notify,
+                                   void *                    _arg);
+
+// acquire next frame slot for capture, blocking while all slots are in
+// use; the slot is owned by the synchronizer until submitted or
+// cancelled
+struct wlanframesync_pool_frame_s * wlanframesync_pool_acquire(wlanframesync_pool _q);
+
+// release acquired frame slot to workers
+void wlanframesync_pool_submit(wlanframesync_pool _q);
+
+// return acquired frame slot without submitting it
+void wlanframesync_pool_cancel(wlanframesync_pool _q);
+
+// decode and deliver next submitted frame, if any, returning 1 if a
+// frame was decoded
+//  _q      :   frame decoding pool
+//  _rx     :   DATA field receiver owned by calling thread
+int wlanframesync_pool_decode(wlanframesync_pool   _q,
+                              wlanframesync_rxdata _rx);
+
+// get number of frames submitted but not yet delivered
+unsigned int wlanframesync_pool_get_backlog(wlanframesync_pool _q);
+
+// block until every submitted frame has been delivered
+void wlanframesync_pool_flush(wlanframesync_pool _q);
+
+// worker thread: claim frames in order, decode and deliver them
+//  _arg        :   worker object
+void * wlanframesync_pool_worker(void * _arg);
+
+// claim next submitted frame, decode it and deliver it along with any
+// later frames already decoded; a pending-frame count must have been
+// consumed by the caller
+void wlanframesync_pool_process(wlanframesync_pool   _q,
+                                wlanframesync_rxdata _rx);
+
+// hand DATA fields to a decoding pool, which is then owned (and
+// destroyed) by the synchronizer
+void wlanframesync_set_pool(wlanframesync      _q,
+                            wlanframesync_pool _pool);
+
+// start synchronizer on a frame detected externally: the object is
+// reset, its input buffer filled, and reception continues with the
+// first 'short' sequence as though it had detected the frame itself
+//  _q      :   frame synchronizer object
+//  _x      :   last 80 input samples [size: 80 x 1]
+//  _g0     :   nominal gain estimate
+//  _timer  :   sample timer for first 'short' sequence
+void wlanframesync_prime(wlanframesync   _q,
+                         float complex * _x,
+                         float           _g0,
+                         unsigned int    _timer);
+
+// is synchronizer seeking a frame (not receiving one)?
+int wlanframesync_is_seeking(wlanframesync _q);
+
+// notification of a frame detected but not decoded; the frame's start,
+// signal strength and carrier offset may be queried from within
+//  _userdata   :   synchronizer's user-defined data object
+typedef void (*wlanframesync_reject_callback)(void * _userdata);
+
+// set notification of frames detected but not decoded (SIGNAL field
+// not valid), invoked with the synchronizer's user data
+void wlanframesync_set_reject_callback(wlanframesync                 _q,
+                                       wlanframesync_reject_callback _reject);
+
+// set index of next input sample, before the front-end if any (see
+// wlanframesync_get_frame_start_input()); baseband samples continue
+// from the corresponding index
+void wlanframesync_set_sample_index(wlanframesync     _q,
+                                    unsigned long int _index);
+
+// get index of first input sample of most recent frame, before the
+// front-end if any, counting from wlanframesync_set_sample_index()
+unsigned long int wlanframesync_get_frame_start_input(wlanframesync _q);
+
+// get front-end resampling factors (1/1 if none)
+//  _q      :   frame synchronizer object
+//  _P      :   interpolation factor (output)
+//  _Q      :   decimation factor (output)
+void wlanframesync_get_frontend(wlanframesync  _q,
+                                unsigned int * _P,
+                                unsigned int * _Q);
+
+//
+// multi-antenna frame synchronizer (internal methods)
+//
+
+// transform 64 samples of each antenna's input buffer
+//  _q      :   multi-antenna frame synchronizer object
+//  _offset :   index of first sample in input buffer
+void wlanframesync_mrc_transform(wlanframesync_mrc _q,
+                                 unsigned int      _offset);
+
+// estimate 'short' and 'long' sequence gains of each antenna from
+// transformed input, returning metrics accumulated over antennas
+//  _q      :   multi-antenna frame synchronizer object
+//  _G      :   gains [size: _num_antennas x 64]
+float complex wlanframesync_mrc_S0_metrics(wlanframesync_mrc _q,
+                                           float complex *   _G);
+float complex wlanframesync_mrc_S1_metrics(wlanframesync_mrc _q,
+                                           float complex *   _G);
+
+// estimate combining weights from 'long' sequence gains
+void wlanframesync_mrc_estimate_weights(wlanframesync_mrc _q);
+
+// combine transformed symbol of each antenna
+void wlanframesync_mrc_combine(wlanframesync_mrc _q);
+
+// frame synchronizer states
+void wlanframesync_mrc_execute_seekplcp(wlanframesync_mrc _q);
+void wlanframesync_mrc_execute_rxshort(wlanframesync_mrc _q,
+                                       float complex *   _G);
+void wlanframesync_mrc_execute_rxlong0(wlanframesync_mrc _q);
+void wlanframesync_mrc_execute_rxlong1(wlanframesync_mrc _q);
+void wlanframesync_mrc_execute_rxsignal(wlanframesync_mrc _q);
+void wlanframesync_mrc_execute_rxdata(wlanframesync_mrc _q);
+
+//
+// wide frame synchronizer (internal methods)
+//
+
+// number of lanes processed together by the detection kernels
+#define WLANFRAMESYNC_WIDE_LANES    (8)
+
+// compute frame detection metrics across lanes, as in
+// wlanframesync_execute_seekplcp(); the 64-point transform is replaced
+// by folding the window to the 16-sample period of the 'short'
+// sequence, leaving only the 12 occupied subcarriers to compute
+//  _x          :   input, lane-interleaved; real and imaginary parts
+//                  of sample t at rows 2t and 2t+1 [size: 128 x _stride]
+//  _stride     :   row length, a multiple of WLANFRAMESYNC_WIDE_LANES
+//  _w          :   transform weights for each subcarrier, including
+//                  the 'short' sequence and gain [size: 12 x 16 x 2]
+//  _s          :   metric real and imaginary parts, and gain estimate
+//                  [size: 3 x _stride]
+void wlanframesync_wide_seek_generic(const float * _x,
+                                     unsigned int  _stride,
+                                     const float * _w,
+                                     float *       _s);
+#if LIQUID_WLAN_HAVE_AVX2
+void wlanframesync_wide_seek_avx2(const float * _x,
+                                  unsigned int  _stride,
+                                  const float * _w,
+                                  float *       _s);
+#endif
+
+//
+// I/Q capture file reader (internal methods)
+//
+
+#define WLANCAPTURE_BLOCK_SIZE  (1<<20) // block size (bytes)
+#define WLANCAPTURE_READAHEAD   (4)     // number of blocks to prefetch
+#define WLANCAPTURE_META_LEN    (16384) // maximum metadata length (bytes)
+
+// offline decoding: default segment length, overlap between segments
+// (longest frame, 109680 samples for 4095 bytes at 6 Mbits/s, plus
+// WLANCAPTURE_DEDUP), and distance within which frames are duplicates
+// (less than the shortest frame, 480 samples); overlap and distance are
+// in 20 MHz baseband samples, scaled by the front-end if any
+#define WLANCAPTURE_SEGMENT_LEN (1<<22)
+#define WLANCAPTURE_OVERLAP     (110592)
+#define WLANCAPTURE_DEDUP       (320)
+
+// frame index file: header followed by one entry per detected frame,
+// in order of frame start (host byte order)
+#define WLANCAPTURE_INDEX_VERSION   (1)
+struct wlancapture_index_header_s {
+    char     magic[4];                  // "LWIX"
+    uint32_t version;                   // WLANCAPTURE_INDEX_VERSION
+    uint64_t num_samples;               // number of samples in capture
+};
+struct wlancapture_index_entry_s {
+    uint64_t sample;                    // sample index of frame start
+    float    rssi;                      // received signal strength [dB]
+    float    cfo;                       // carrier offset [radians/sample]
+    uint16_t length;                    // payload length (0 if rejected)
+    uint8_t  rate;                      // data rate (0 if rejected)
+    uint8_t  status;                    // e.g. LIQUID_WLAN_CAPTURE_FRAME_DECODED
+    uint32_t reserved;
+};
+
+// prefetch range of samples, e.g. a frame's window for random access
+//  _q      :   capture file reader
+//  _start  :   first sample
+//  _end    :   end of range, _start <= _end <= number of samples
+void wlancapture_prefetch(wlancapture       _q,
+                          unsigned long int _start,
+                          unsigned long int _end);
+
+// get samples within mapping, in capture's own format
+//  _q      :   capture file reader
+//  _sample :   sample index, _sample < number of samples
+const void * wlancapture_get_samples(wlancapture       _q,
+                                     unsigned long int _sample);
+
+// advise kernel of block access
+//  _q      :   capture file reader
+//  _block  :   block index (ignored beyond end of capture)
+//  _needed :   prefetch (1) or release (0) block
+void wlancapture_advise(wlancapture       _q,
+                        unsigned long int _block,
+                        int               _needed);
+
+// get sample format from file name extension
+int wlancapture_format_from_name(const char * _filename);
+
+// run samples through frame synchronizer in capture's own format
+//  _q      :   capture file reader
+//  _fs     :   frame synchronizer
+//  _block  :   samples within mapping
+//  _n      :   number of samples
+void wlancapture_execute_block(wlancapture   _q,
+                               wlanframesync _fs,
+                               const void *  _block,
+                               unsigned int  _n);
+
+// run range of samples through frame synchronizer, independent of
+// reading position (safe to call from several threads at once)
+//  _q      :   capture file reader
+//  _fs     :   frame synchronizer
+//  _start  :   first sample
+//  _end    :   end of range, _start <= _end <= number of samples
+void wlancapture_execute_range(wlancapture       _q,
+                               wlanframesync     _fs,
+                               unsigned long int _start,
+                               unsigned long int _end);
+
+// read SigMF metadata next to capture, if any, setting sample rate and
+// returning sample format (LIQUID_WLAN_CAPTURE_AUTO if not found)
+int wlancapture_read_sidecar(wlancapture  _q,
+                             const char * _filename);
+
+// offline decoding worker thread: claim segments in order and decode
+// them
+//  _arg        :   worker object
+void * wlancapture_decode_worker(void * _arg);
+
+// offline decoding frame synchronizer callback: keep frames starting
+// within worker's segment
+int wlancapture_decode_callback(unsigned char *        _payload,
+                                struct wlan_rxvector_s _rxvector,
+                                void *                 _userdata);
+
+// offline decoding notification of frame detected but not decoded
+void wlancapture_decode_reject(void * _userdata);
+
+struct wlancapture_worker_s;
+struct wlancapture_frame_s;
+
+// offline decoding: keep frame in worker's segment if it starts there
+//  _w          :   worker object
+//  _payload    :   received payload (NULL if not decoded)
+//  _rxvector   :   received vector
+//  _status     :   frame status, e.g. LIQUID_WLAN_CAPTURE_FRAME_DECODED
+void wlancapture_decode_keep(struct wlancapture_worker_s * _w,
+                             unsigned char *               _payload,
+                             struct wlan_rxvector_s        _rxvector,
+                             int                           _status);
+
+// offline decoding: deliver frame to callback (if decoded) and index,
+// returning 1 if the frame was decoded
+//  _frame      :   detected frame
+//  _payload    :   frame payload
+//  _fid        :   frame index file (NULL if none)
+//  _callback   :   user-defined callback function
+//  _userdata   :   user-defined data structure
+int wlancapture_decode_deliver(struct wlancapture_frame_s * _frame,
+                               unsigned char *              _payload,
+                               FILE *                       _fid,
+                               wlancapture_callback         _callback,
+                               void *                       _userdata);
+
+// get frame index file name (NULL if none)
+const char * wlancapture_get_index(wlancapture _q);
+
+// can capture be decoded offline? either a synchronizer configuration
+// is set (e.g. a front-end), or the sample rate is 20 MHz or unknown
+int wlancapture_is_decodable(wlancapture _q);
+
+// create frame synchronizer for offline decoding, applying the
+// configuration set with wlancapture_set_config()
+//  _q          :   capture file reader
+//  _callback   :   frame synchronizer callback
+//  _userdata   :   user-defined data structure
+wlanframesync wlancapture_create_framesync(wlancapture            _q,
+                                           wlanframesync_callback _callback,
+                                           void *                 _userdata);
+
+// create frame index file and write its header
+//  _filename       :   index file name
+//  _num_samples    :   number of samples in capture
+FILE * wlancapture_index_create(const char *      _filename,
+                                unsigned long int _num_samples);
+
+struct wlancapture_index_s;
+
+// frame index re-decoding: is most recent frame the indexed one
+// (starting within its tolerance)?
+int wlancapture_index_match(struct wlancapture_index_s * _idx);
+
+// frame index re-decoding frame synchronizer callback: forward frame
+// starting at indexed position
+int wlancapture_index_callback(unsigned char *        _payload,
+                               struct wlan_rxvector_s _rxvector,
+                               void *                 _userdata);
+
+// frame index re-decoding notification of frame not decoded: stop if
+// it is the indexed frame
+void wlancapture_index_reject(void * _userdata);
+
+// find value of JSON field, returning pointer to its first character
+// (NULL if not found)
+//  _json   :   JSON text
+//  _key    :   field name, including quotes
+char * wlancapture_find_value(char *       _json,
+                              const char * _key);
+
+//
+// multi-channel receiver (internal methods)
+//
+
+struct wlanrx_task_s;
+struct wlanrx_worker_s;
+
+// queue task on worker's deque and wake an idle worker
+//  _q          :   multi-channel receiver
+//  _worker     :   worker index
+//  _type       :   task type
+//  _channel    :   channel index
+void wlanrx_push_task(wlanrx       _q,
+                      unsigned int _worker,
+                      unsigned int _type,
+                      unsigned int _channel);
+
+// take task from worker's own deque (bottom) or steal one from another
+// worker's deque (top), returning 1 if a task was found
+//  _w      :   worker
+//  _task   :   task (output)
+int wlanrx_take_task(struct wlanrx_worker_s * _w,
+                     struct wlanrx_task_s *   _task);
+
+// detection task: run channel's synchronizer on a chunk of buffered
+// samples, re-queueing the task while samples remain
+//  _w          :   worker
+//  _channel    :   channel index
+void wlanrx_detect(struct wlanrx_worker_s * _w,
+                   unsigned int             _channel);
+
+// worker thread: run own tasks, steal tasks, or wait for tasks
+//  _arg        :   worker object
+void * wlanrx_worker(void * _arg);
+
+// frame submitted by channel's synchronizer: queue decoding task
+//  _arg        :   channel object
+void wlanrx_channel_notify(void * _arg);
+
+// frame delivered by channel's synchronizer: invoke callback
+int wlanrx_channel_callback(unsigned char *        _payload,
+                            struct wlan_rxvector_s _rxvector,
+                            void *                 _userdata);
+
 #endif // __LIQUID_WLAN_INTERNAL_H__
 
@@ -43,12 +43,24 @@ struct wlan_interleaver_tab_s {
     unsigned char mask1;    // output (interleaved) bit mask
 };
 
+// puncturing matrices (see wlan_fec.c)
+unsigned char pmatrix_r12[2]  = {1, 1};
+unsigned char pmatrix_r23[12] = {
+    1, 1, 1, 1, 1, 1,
+    1, 0, 1, 0, 1, 0};
+unsigned char pmatrix_r34[18] = {
+    1, 1, 0, 1, 1, 0, 1, 1, 0,
+    1, 0, 1, 1, 0, 1, 1, 0, 1};
+
 int main(int argc, char*argv[])
 {
     // option(s)
     unsigned int rate  = 6;     // primitive rate
     unsigned int ncbps = 48;    // number of coded bits per OFDM symbol
     unsigned int nbpsc = 1;     // number of bits per subcarrier (modulation depth)
+    unsigned int ndbps = 24;    // number of data bits per OFDM symbol
+    unsigned char * pmatrix = pmatrix_r12;  // puncturing matrix
+    unsigned int P     = 1;     // puncturing matrix period
     
     // get options
     int dopt;
@@ -59,14 +71,14 @@ int main(int argc, char*argv[])
             return 0;
         case 'r':
             switch ( atoi(optarg) ) {
-            case 6:  rate = 6;  ncbps = 48;  nbpsc = 1; break;
-            case 9:  rate = 9;  ncbps = 48;  nbpsc = 1; break;
-            case 12: rate = 12; ncbps = 96;  nbpsc = 2; break;
-            case 18: rate = 18; ncbps = 96;  nbpsc = 2; break;
-            case 24: rate = 24; ncbps = 192; nbpsc = 4; break;
-            case 36: rate = 36; ncbps = 192; nbpsc = 4; break;
-            case 48: rate = 48; ncbps = 288; nbpsc = 6; break;
-            case 54: rate = 54; ncbps = 288; nbpsc = 6; break;
+            case 6:  rate = 6;  ncbps = 48;  nbpsc = 1; ndbps = 24;  pmatrix = pmatrix_r12; P = 1; break;
+            case 9:  rate = 9;  ncbps = 48;  nbpsc = 1; ndbps = 36;  pmatrix = pmatrix_r34; P = 9; break;
+            case 12: rate = 12; ncbps = 96;  nbpsc = 2; ndbps = 48;  pmatrix = pmatrix_r12; P = 1; break;
+            case 18: rate = 18; ncbps = 96;  nbpsc = 2; ndbps = 72;  pmatrix = pmatrix_r34; P = 9; break;
+            case 24: rate = 24; ncbps = 192; nbpsc = 4; ndbps = 96;  pmatrix = pmatrix_r12; P = 1; break;
+            case 36: rate = 36; ncbps = 192; nbpsc = 4; ndbps = 144; pmatrix = pmatrix_r34; P = 9; break;
+            case 48: rate = 48; ncbps = 288; nbpsc = 6; ndbps = 192; pmatrix = pmatrix_r23; P = 6; break;
+            case 54: rate = 54; ncbps = 288; nbpsc = 6; ndbps = 216; pmatrix = pmatrix_r34; P = 9; break;
             default:
                 fprintf(stderr,"error: %s, invalid rate '%s'\n", argv[0], optarg);
                 exit(1);
@@ -80,6 +92,9 @@ int main(int argc, char*argv[])
     // create structured interleaver table
     struct wlan_interleaver_tab_s intlv[ncbps];
 
+    // interleaved bit index of each coded bit
+    unsigned int jtab[ncbps];
+
     // generate table
     unsigned int k; // original
     unsigned int i;
@@ -96,6 +111,8 @@ int main(int argc, char*argv[])
         i = (ncbps/16)*(k % 16) + (k/16);
         j = s*(i/s) + (i + ncbps - ((16*i)/ncbps) ) % s;
         
+        jtab[k] = j;
+
         d0 = div(k, 8);
         d1 = div(j, 8);
 
@@ -112,7 +129,7 @@ int main(int argc, char*argv[])
     printf("#include \"liquid-wlan.internal.h\"\n");
     printf("\n");
     printf("// structured interleaver table for rate %u M bits/s\n", rate);
-    printf("struct wlan_interleaver_tab_s wlan_intlv_R%u[%u] = {\n", rate, ncbps);
+    printf("const struct wlan_interleaver_tab_s wlan_intlv_R%u[%u] = {\n", rate, ncbps);
     for (i=0; i<ncbps; i++) {
         printf("    {%3u, %3u, 0x%.2x, 0x%.2x},\n",
             intlv[i].p0,
@@ -122,6 +139,26 @@ int main(int argc, char*argv[])
     }
     printf("};\n");
 
+    // generate soft de-interleaver index table: de-punctured encoder
+    // output order, with erasures pointing one past the symbol
+    unsigned short soft[2*ndbps];
+    unsigned int n = 0;
+    for (i=0; i<ndbps; i++) {
+        for (j=0; j<2; j++)
+            soft[2*i+j] = pmatrix[j*P + (i%P)] ? jtab[n++] : ncbps;
+    }
+
+    // print soft table
+    printf("\n");
+    printf("// soft de-interleaver index table for rate %u M bits/s (%u denotes erasure)\n", rate, ncbps);
+    printf("const unsigned short wlan_intlv_soft_R%u[%u] = {\n", rate, 2*ndbps);
+    for (i=0; i<2*ndbps; i++) {
+        printf("%s%3u,", (i%12)==0 ? "    " : " ", soft[i]);
+        if ( ((i+1)%12)==0 || i==2*ndbps-1 )
+            printf("\n");
+    }
+    printf("};\n");
+
     return 0;
 }
 
@@ -32,17 +32,40 @@
 // include header with forward declarations
 #include "liquid-wlan.internal.h"
 
+/* The implementation is selected once per process, so every instance
+ * is handled by the implementation that created it
+ */
+#if LIQUID_WLAN_HAVE_SSE2
+#   define VITERBI27_SSE2 (wlan_cpu_get()->viterbi27 == LIQUID_WLAN_CPU_SSE2)
+#else
+#   define VITERBI27_SSE2 (0)
+#endif
+
 /* Create a new instance of a Viterbi decoder */
 void *wlan_create_viterbi27(int len){
+#if LIQUID_WLAN_HAVE_SSE2
+    if(VITERBI27_SSE2)
+        return wlan_create_viterbi27_sse2(len);
+#endif
     return wlan_create_viterbi27_port(len);
 }
 
-void wlan_set_viterbi27_polynomial(int polys[2]){
-    wlan_set_viterbi27_polynomial_port(polys);
+void wlan_set_viterbi27_polynomial(void *p,int polys[2]){
+#if LIQUID_WLAN_HAVE_SSE2
+    if(VITERBI27_SSE2){
+        wlan_set_viterbi27_polynomial_sse2(p,polys);
+        return;
+    }
+#endif
+    wlan_set_viterbi27_polynomial_port(p,polys);
 }
 
 /* initialize Viterbi decoder for start of new frame */
 int wlan_init_viterbi27(void *p,int starting_state){
+#if LIQUID_WLAN_HAVE_SSE2
+    if(VITERBI27_SSE2)
+        return wlan_init_viterbi27_sse2(p,starting_state);
+#endif
     return wlan_init_viterbi27_port(p,starting_state);
 }
 
@@ -53,11 +76,21 @@ int wlan_chainback_viterbi27(
     unsigned int nbits, /* Number of data bits */
     unsigned int endstate){ /* Terminal encoder state */
 
+#if LIQUID_WLAN_HAVE_SSE2
+    if(VITERBI27_SSE2)
+        return wlan_chainback_viterbi27_sse2(p,data,nbits,endstate);
+#endif
     return wlan_chainback_viterbi27_port(p,data,nbits,endstate);
 }
 
 /* Delete instance of a Viterbi decoder */
 void wlan_delete_viterbi27(void *p){
+#if LIQUID_WLAN_HAVE_SSE2
+    if(VITERBI27_SSE2){
+        wlan_delete_viterbi27_sse2(p);
+        return;
+    }
+#endif
     wlan_delete_viterbi27_port(p);
 }
 
@@ -69,6 +102,12 @@ int wlan_update_viterbi27_blk(void *p,unsigned char syms[],int nbits){
     if(p == NULL)
         return -1;
 
+#if LIQUID_WLAN_HAVE_SSE2
+    if(VITERBI27_SSE2){
+        wlan_update_viterbi27_blk_sse2(p,syms,nbits);
+        return 0;
+    }
+#endif
     wlan_update_viterbi27_blk_port(p,syms,nbits);
     return 0;
 }
@@ -35,8 +35,16 @@
 
 typedef union { unsigned int w[64]; } metric_t;
 typedef union { unsigned long w[2];} decision_t;
-static union branchtab27 { unsigned char c[32]; } Branchtab27[2] __attribute__ ((aligned(16)));
-static int Init = 0;
+typedef union branchtab27 { unsigned char c[32]; } branchtab27_t;
+
+/* Branch table for default polynomials V27POLYA, V27POLYB; instances
+ * hold their own copy so that no state is shared between decoders
+ */
+static const branchtab27_t Branchtab27_default[2] __attribute__ ((aligned(16))) = {
+  {{  0,  0,255,255,255,255,  0,  0,  0,  0,255,255,255,255,  0,  0,
+    255,255,  0,  0,  0,  0,255,255,255,255,  0,  0,  0,  0,255,255}},
+  {{  0,255,255,  0,255,  0,  0,255,  0,255,255,  0,255,  0,  0,255,
+      0,255,255,  0,255,  0,  0,255,  0,255,255,  0,255,  0,  0,255}}};
 
 /* State info for instance of Viterbi decoder
  * Don't change this without also changing references in [mmx|sse|sse2]bfly29.s!
@@ -47,6 +55,7 @@ struct v27 {
   decision_t *dp;          /* Pointer to current decision */
   metric_t *old_metrics,*new_metrics; /* Pointers to path metrics, swapped on every bit */
   decision_t *decisions;   /* Beginning of decisions for block */
+  branchtab27_t Branchtab27[2]; /* Branch metric table for this instance */
 };
 
 /* Initialize Viterbi decoder for start of new frame */
@@ -66,26 +75,24 @@ int wlan_init_viterbi27_port(void *p,int starting_state){
   return 0;
 }
 
-void wlan_set_viterbi27_polynomial_port(int polys[2]){
+/* Set polynomials for this instance of Viterbi decoder */
+void wlan_set_viterbi27_polynomial_port(void *p,int polys[2]){
+  struct v27 *vp = p;
   int state;
 
   for(state=0;state < 32;state++){
-    Branchtab27[0].c[state] = (polys[0] < 0) ^ parity((2*state) & abs(polys[0])) ? 255 : 0;
-    Branchtab27[1].c[state] = (polys[1] < 0) ^ parity((2*state) & abs(polys[1])) ? 255 : 0;
+    vp->Branchtab27[0].c[state] = (polys[0] < 0) ^ parity((2*state) & abs(polys[0])) ? 255 : 0;
+    vp->Branchtab27[1].c[state] = (polys[1] < 0) ^ parity((2*state) & abs(polys[1])) ? 255 : 0;
   }
-  Init++;
 }
 
 /* Create a new instance of a Viterbi decoder */
 void *wlan_create_viterbi27_port(int len){
   struct v27 *vp;
 
-  if(!Init){
-    int polys[2] = { V27POLYA, V27POLYB };
-    wlan_set_viterbi27_polynomial_port(polys);
-  }
   if((vp = malloc(sizeof(struct v27))) == NULL)
      return NULL;
+  memcpy(vp->Branchtab27, Branchtab27_default, sizeof(vp->Branchtab27));
   if((vp->decisions = malloc((len+6)*sizeof(decision_t))) == NULL){
     free(vp);
     return NULL;
@@ -140,7 +147,7 @@ void wlan_delete_viterbi27_port(void *p){
 /* C-language butterfly */
 #define BFLY(i) {\
 unsigned int metric,m0,m1,decision;\
-    metric = (Branchtab27[0].c[i] ^ sym0) + (Branchtab27[1].c[i] ^ sym1);\
+    metric = (vp->Branchtab27[0].c[i] ^ sym0) + (vp->Branchtab27[1].c[i] ^ sym1);\
     m0 = vp->old_metrics->w[i] + metric;\
     m1 = vp->old_metrics->w[i+32] + (510 - metric);\
     decision = (signed int)(m0-m1) > 0;\
@@ -0,0 +1,237 @@
+/*
+ * Copyright Feb 2004, Phil Karn, KA9Q
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* 
+ * K=7 r=1/2 Viterbi decoder with Intel SSE2 instructions
+ * Original source code released under LGPLv2.1
+ * Some modifications made from original for portability.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <memory.h>
+#include <limits.h>
+
+// include header with forward declarations
+#include "liquid-wlan.internal.h"
+
+#if LIQUID_WLAN_HAVE_SSE2
+
+#include <emmintrin.h>
+
+typedef union { unsigned char c[64]; __m128i v[4]; } metric_t;
+typedef union { unsigned char c[8]; unsigned short s[4]; } decision_t;
+typedef union branchtab27 { unsigned char c[32]; __m128i v[2]; } branchtab27_t;
+
+/* Branch table for default polynomials V27POLYA, V27POLYB; instances
+ * hold their own copy so that no state is shared between decoders
+ */
+static const unsigned char Branchtab27_default[2][32] = {
+  {  0,  0,255,255,255,255,  0,  0,  0,  0,255,255,255,255,  0,  0,
+    255,255,  0,  0,  0,  0,255,255,255,255,  0,  0,  0,  0,255,255},
+  {  0,255,255,  0,255,  0,  0,255,  0,255,255,  0,255,  0,  0,255,
+     0,255,255,  0,255,  0,  0,255,  0,255,255,  0,255,  0,  0,255}};
+
+/* State info for instance of Viterbi decoder; 8-bit path metrics are
+ * saturated and renormalized as needed
+ */
+struct v27 {
+  metric_t metrics1; /* path metric buffer 1 */
+  metric_t metrics2; /* path metric buffer 2 */
+  branchtab27_t Branchtab27[2]; /* Branch metric table for this instance */
+  decision_t *dp;          /* Pointer to current decision */
+  metric_t *old_metrics,*new_metrics; /* Pointers to path metrics, swapped on every bit */
+  decision_t *decisions;   /* Beginning of decisions for block */
+  void *alloc;             /* Unaligned allocation */
+};
+
+/* Initialize Viterbi decoder for start of new frame */
+int wlan_init_viterbi27_sse2(void *p,int starting_state){
+  struct v27 *vp = p;
+  int i;
+
+  if(p == NULL)
+    return -1;
+  for(i=0;i<64;i++)
+    vp->metrics1.c[i] = 63;
+
+  vp->old_metrics = &vp->metrics1;
+  vp->new_metrics = &vp->metrics2;
+  vp->dp = vp->decisions;
+  vp->old_metrics->c[starting_state & 63] = 0; /* Bias known start state */
+  return 0;
+}
+
+/* Set polynomials for this instance of Viterbi decoder */
+void wlan_set_viterbi27_polynomial_sse2(void *p,int polys[2]){
+  struct v27 *vp = p;
+  int state;
+
+  for(state=0;state < 32;state++){
+    vp->Branchtab27[0].c[state] = (polys[0] < 0) ^ parity((2*state) & abs(polys[0])) ? 255 : 0;
+    vp->Branchtab27[1].c[state] = (polys[1] < 0) ^ parity((2*state) & abs(polys[1])) ? 255 : 0;
+  }
+}
+
+/* Create a new instance of a Viterbi decoder */
+void *wlan_create_viterbi27_sse2(int len){
+  void *p;
+  struct v27 *vp;
+
+  /* Vector members must be 16-byte aligned */
+  if((p = malloc(sizeof(struct v27) + 15)) == NULL)
+    return NULL;
+  vp = (struct v27 *)(((unsigned long)p + 15) & ~15UL);
+  vp->alloc = p;
+  memcpy(vp->Branchtab27[0].c, Branchtab27_default[0], 32);
+  memcpy(vp->Branchtab27[1].c, Branchtab27_default[1], 32);
+  if((vp->decisions = malloc((len+6)*sizeof(decision_t))) == NULL){
+    free(p);
+    return NULL;
+  }
+  wlan_init_viterbi27_sse2(vp,0);
+
+  return vp;
+}
+
+/* Viterbi chainback */
+int wlan_chainback_viterbi27_sse2(
+      void *p,
+      unsigned char *data, /* Decoded output data */
+      unsigned int nbits, /* Number of data bits */
+      unsigned int endstate){ /* Terminal encoder state */
+  struct v27 *vp = p;
+  decision_t *d;
+
+  if(p == NULL)
+    return -1;
+  d = vp->decisions;
+  /* Make room beyond the end of the encoder register so we can
+   * accumulate a full byte of decoded data
+   */
+  endstate %= 64;
+  endstate <<= 2;
+
+  /* The store into data[] only needs to be done every 8 bits.
+   * But this avoids a conditional branch, and the writes will
+   * combine in the cache anyway
+   */
+  d += 6; /* Look past tail */
+  while(nbits-- != 0){
+    int k;
+
+    k = (d[nbits].c[(endstate>>2)/8] >> ((endstate>>2)%8)) & 1;
+    data[nbits>>3] = endstate = (endstate >> 1) | (k << 7);
+  }
+  return 0;
+}
+
+/* Delete instance of a Viterbi decoder */
+void wlan_delete_viterbi27_sse2(void *p){
+  struct v27 *vp = p;
+
+  if(vp != NULL){
+    free(vp->decisions);
+    free(vp->alloc);
+  }
+}
+
+/* Update decoder with a block of demodulated symbols
+ * Note that nbits is the number of decoded data bits, not the number
+ * of symbols!
+ */
+LIQUID_WLAN_TARGET_SSE2
+int wlan_update_viterbi27_blk_sse2(void *p,unsigned char *syms,int nbits){
+  struct v27 *vp = p;
+  decision_t *d;
+
+  if(p == NULL)
+    return -1;
+  d = (decision_t *)vp->dp;
+  while(nbits--){
+    __m128i sym0v,sym1v;
+    void *tmp;
+    int i;
+
+    /* Splat the 0th symbol across sym0v, the 1st symbol across sym1v, etc */
+    sym0v = _mm_set1_epi8(syms[0]);
+    sym1v = _mm_set1_epi8(syms[1]);
+    syms += 2;
+
+    for(i=0;i<2;i++){
+      __m128i decision0,decision1,metric,m_metric,m0,m1,m2,m3,survivor0,survivor1;
+
+      /* Form branch metrics */
+      metric = _mm_avg_epu8(_mm_xor_si128(vp->Branchtab27[0].v[i],sym0v),_mm_xor_si128(vp->Branchtab27[1].v[i],sym1v));
+      /* There's no packed bytes right shift in SSE2, so we use the word version and mask
+       * (I'm *really* starting to like Altivec...)
+       */
+      metric = _mm_srli_epi16(metric,3);
+      metric = _mm_and_si128(metric,_mm_set1_epi8(31));
+      m_metric = _mm_sub_epi8(_mm_set1_epi8(31),metric);
+
+      /* Add branch metrics to path metrics */
+      m0 = _mm_adds_epu8(vp->old_metrics->v[i],metric);
+      m3 = _mm_adds_epu8(vp->old_metrics->v[2+i],metric);
+      m1 = _mm_adds_epu8(vp->old_metrics->v[2+i],m_metric);
+      m2 = _mm_adds_epu8(vp->old_metrics->v[i],m_metric);
+
+      /* Compare and select */
+      decision0 = _mm_cmpeq_epi8(_mm_max_epu8(m0,m1),m0);
+      decision1 = _mm_cmpeq_epi8(_mm_max_epu8(m2,m3),m2);
+      survivor0 = _mm_or_si128(_mm_and_si128(decision0,m1),_mm_andnot_si128(decision0,m0));
+      survivor1 = _mm_or_si128(_mm_and_si128(decision1,m3),_mm_andnot_si128(decision1,m2));
+
+      /* Pack each set of decisions into 16 bits */
+      d->s[2*i] = _mm_movemask_epi8(_mm_unpacklo_epi8(decision0,decision1));
+      d->s[2*i+1] = _mm_movemask_epi8(_mm_unpackhi_epi8(decision0,decision1));
+
+      /* Store surviving metrics */
+      vp->new_metrics->v[2*i] = _mm_unpacklo_epi8(survivor0,survivor1);
+      vp->new_metrics->v[2*i+1] = _mm_unpackhi_epi8(survivor0,survivor1);
+    }
+    /* See if we need to renormalize */
+    if(vp->new_metrics->c[0] >= 105){
+      __m128i adjustv;
+
+      adjustv = vp->new_metrics->v[0];
+      for(i=1;i<4;i++)
+        adjustv = _mm_min_epu8(adjustv,vp->new_metrics->v[i]);
+
+      adjustv = _mm_min_epu8(adjustv,_mm_srli_si128(adjustv,8));
+      adjustv = _mm_min_epu8(adjustv,_mm_srli_si128(adjustv,4));
+      adjustv = _mm_min_epu8(adjustv,_mm_srli_si128(adjustv,2));
+      adjustv = _mm_min_epu8(adjustv,_mm_srli_si128(adjustv,1));
+      adjustv = _mm_set1_epi8((char)_mm_cvtsi128_si32(adjustv));
+      for(i=0;i<4;i++)
+        vp->new_metrics->v[i] = _mm_subs_epu8(vp->new_metrics->v[i],adjustv);
+    }
+    d++;
+    /* Swap pointers to old and new metrics */
+    tmp = vp->old_metrics;
+    vp->old_metrics = vp->new_metrics;
+    vp->new_metrics = tmp;
+  }
+  vp->dp = d;
+  return 0;
+}
+
+#endif
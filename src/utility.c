@@ -20,9 +20,14 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 
 #include "liquid-wlan.internal.h"
 
+#if LIQUID_WLAN_HAVE_AVX2
+#   include <immintrin.h>
+#endif
+
 // reverse byte table
 unsigned const char liquid_wlan_reverse_byte[256] = {
     0x00, 0x80, 0x40, 0xc0, 0x20, 0xa0, 0x60, 0xe0,
@@ -118,6 +123,35 @@ void liquid_wlan_repack_bytes(unsigned char * _sym_in,
                 _sym_out_len, _sym_out_bps);
         exit(-1);
     }
+
+    // use dedicated kernels for byte to/from 1, 2, 4, and 6-bit symbols
+    int fast_in  = _sym_in_bps  == 1 || _sym_in_bps  == 2 || _sym_in_bps  == 4 || _sym_in_bps  == 6;
+    int fast_out = _sym_out_bps == 1 || _sym_out_bps == 2 || _sym_out_bps == 4 || _sym_out_bps == 6;
+    if (_sym_in_bps == 8 && fast_out) {
+        *_num_written = liquid_wlan_unpack_bytes(_sym_in, _sym_in_len, _sym_out, _sym_out_bps);
+    } else if (_sym_out_bps == 8 && fast_in) {
+        *_num_written = liquid_wlan_pack_bytes(_sym_in, _sym_in_len, _sym_out, _sym_in_bps);
+    } else {
+        liquid_wlan_repack_bytes_generic(_sym_in, _sym_in_bps, _sym_in_len,
+                                         _sym_out, _sym_out_bps, _sym_out_len,
+                                         _num_written);
+    }
+}
+
+// repack bytes with arbitrary symbol sizes, one bit at a time (see
+// liquid_wlan_repack_bytes)
+void liquid_wlan_repack_bytes_generic(unsigned char * _sym_in,
+                                      unsigned int    _sym_in_bps,
+                                      unsigned int    _sym_in_len,
+                                      unsigned char * _sym_out,
+                                      unsigned int    _sym_out_bps,
+                                      unsigned int    _sym_out_len,
+                                      unsigned int *  _num_written)
+{
+    // compute number of output symbols
+    div_t d = div(_sym_in_len*_sym_in_bps,_sym_out_bps);
+    unsigned int req__sym_out_len = d.quot;
+    req__sym_out_len += ( d.rem > 0 ) ? 1 : 0;
     
     unsigned int i;
     unsigned char s_in = 0;     // input symbol
@@ -169,3 +203,202 @@ void liquid_wlan_repack_bytes(unsigned char * _sym_in,
     *_num_written = i_out;
 }
 
+
+// bit mask with the lower _bps bits of every byte set
+#define LIQUID_WLAN_REPACK_MASK(_bps) (0x0101010101010101ULL * ((1ULL << (_bps)) - 1))
+
+// unpack bytes into 1, 2, 4, or 6-bit symbols, most-significant bit
+// first, returning number of symbols written
+//  _sym_in     :   input bytes [size: _sym_in_len x 1]
+//  _sym_in_len :   number of input bytes
+//  _sym_out    :   output symbols [size: ceil(8*_sym_in_len/_bps) x 1]
+//  _bps        :   bits per output symbol
+unsigned int liquid_wlan_unpack_bytes(unsigned char * _sym_in,
+                                      unsigned int    _sym_in_len,
+                                      unsigned char * _sym_out,
+                                      unsigned int    _bps)
+{
+    return wlan_cpu_get()->unpack_bytes(_sym_in, _sym_in_len, _sym_out, _bps);
+}
+
+// pack 1, 2, 4, or 6-bit symbols into bytes, most-significant bit
+// first, returning number of bytes written
+//  _sym_in     :   input symbols [size: _sym_in_len x 1]
+//  _sym_in_len :   number of input symbols
+//  _sym_out    :   output bytes [size: ceil(_bps*_sym_in_len/8) x 1]
+//  _bps        :   bits per input symbol
+unsigned int liquid_wlan_pack_bytes(unsigned char * _sym_in,
+                                    unsigned int    _sym_in_len,
+                                    unsigned char * _sym_out,
+                                    unsigned int    _bps)
+{
+    return wlan_cpu_get()->pack_bytes(_sym_in, _sym_in_len, _sym_out, _bps);
+}
+
+// unpack remaining bytes after full groups, padding last symbol with
+// zeros, returning total number of symbols written
+//  _sym_in     :   input bytes [size: _sym_in_len x 1]
+//  _sym_in_len :   number of input bytes
+//  _i          :   index of first remaining input byte
+//  _sym_out    :   output symbols
+//  _n          :   number of symbols already written
+//  _bps        :   bits per output symbol
+static unsigned int liquid_wlan_unpack_bytes_tail(unsigned char * _sym_in,
+                                                  unsigned int    _sym_in_len,
+                                                  unsigned int    _i,
+                                                  unsigned char * _sym_out,
+                                                  unsigned int    _n,
+                                                  unsigned int    _bps)
+{
+    uint64_t acc = 0;
+    unsigned int nbits = 0;
+    for (; _i<_sym_in_len; _i++) {
+        acc = (acc << 8) | _sym_in[_i];
+        nbits += 8;
+        while (nbits >= _bps) {
+            nbits -= _bps;
+            _sym_out[_n++] = (acc >> nbits) & ((1 << _bps) - 1);
+        }
+    }
+    if (nbits > 0)
+        _sym_out[_n++] = (acc << (_bps - nbits)) & ((1 << _bps) - 1);
+
+    return _n;
+}
+
+// pack remaining symbols after full groups, padding last byte with
+// zeros, returning total number of bytes written
+//  _sym_in     :   input symbols [size: _sym_in_len x 1]
+//  _sym_in_len :   number of input symbols
+//  _i          :   index of first remaining input symbol
+//  _sym_out    :   output bytes
+//  _n          :   number of bytes already written
+//  _bps        :   bits per input symbol
+static unsigned int liquid_wlan_pack_bytes_tail(unsigned char * _sym_in,
+                                                unsigned int    _sym_in_len,
+                                                unsigned int    _i,
+                                                unsigned char * _sym_out,
+                                                unsigned int    _n,
+                                                unsigned int    _bps)
+{
+    uint64_t acc = 0;
+    unsigned int nbits = 0;
+    for (; _i<_sym_in_len; _i++) {
+        acc = (acc << _bps) | (_sym_in[_i] & ((1 << _bps) - 1));
+        nbits += _bps;
+        if (nbits >= 8) {
+            nbits -= 8;
+            _sym_out[_n++] = (acc >> nbits) & 0xff;
+        }
+    }
+    if (nbits > 0)
+        _sym_out[_n++] = (acc << (8 - nbits)) & 0xff;
+
+    return _n;
+}
+
+// unpack bytes using shifts; every _bps input bytes hold exactly eight
+// output symbols (see liquid_wlan_unpack_bytes)
+unsigned int liquid_wlan_unpack_bytes_generic(unsigned char * _sym_in,
+                                              unsigned int    _sym_in_len,
+                                              unsigned char * _sym_out,
+                                              unsigned int    _bps)
+{
+    unsigned int i;
+    unsigned int j;
+    unsigned int n = 0;
+    unsigned char mask = (1 << _bps) - 1;
+
+    // full groups of _bps bytes into eight symbols
+    for (i=0; i+_bps <= _sym_in_len; i+=_bps) {
+        uint64_t x = 0;
+        for (j=0; j<_bps; j++)
+            x = (x << 8) | _sym_in[i+j];
+        for (j=0; j<8; j++)
+            _sym_out[n+j] = (x >> (_bps*(7-j))) & mask;
+        n += 8;
+    }
+
+    return liquid_wlan_unpack_bytes_tail(_sym_in, _sym_in_len, i, _sym_out, n, _bps);
+}
+
+// pack symbols using shifts; every eight input symbols fill exactly
+// _bps output bytes (see liquid_wlan_pack_bytes)
+unsigned int liquid_wlan_pack_bytes_generic(unsigned char * _sym_in,
+                                            unsigned int    _sym_in_len,
+                                            unsigned char * _sym_out,
+                                            unsigned int    _bps)
+{
+    unsigned int i;
+    unsigned int j;
+    unsigned int n = 0;
+    unsigned char mask = (1 << _bps) - 1;
+
+    // full groups of eight symbols into _bps bytes
+    for (i=0; i+8 <= _sym_in_len; i+=8) {
+        uint64_t x = 0;
+        for (j=0; j<8; j++)
+            x = (x << _bps) | (_sym_in[i+j] & mask);
+        for (j=0; j<_bps; j++)
+            _sym_out[n+j] = (x >> (8*(_bps-j-1))) & 0xff;
+        n += _bps;
+    }
+
+    return liquid_wlan_pack_bytes_tail(_sym_in, _sym_in_len, i, _sym_out, n, _bps);
+}
+
+#if LIQUID_WLAN_HAVE_AVX2
+// unpack bytes by depositing each group of _bps bytes into the lower
+// bits of eight bytes (see liquid_wlan_unpack_bytes)
+LIQUID_WLAN_TARGET_AVX2
+unsigned int liquid_wlan_unpack_bytes_bmi2(unsigned char * _sym_in,
+                                           unsigned int    _sym_in_len,
+                                           unsigned char * _sym_out,
+                                           unsigned int    _bps)
+{
+    unsigned int i;
+    unsigned int j;
+    unsigned int n = 0;
+
+    // full groups of _bps bytes into eight symbols, first symbol in
+    // most-significant byte
+    for (i=0; i+_bps <= _sym_in_len; i+=_bps) {
+        uint64_t x = 0;
+        for (j=0; j<_bps; j++)
+            x = (x << 8) | _sym_in[i+j];
+        uint64_t y = _pdep_u64(x, LIQUID_WLAN_REPACK_MASK(_bps));
+        for (j=0; j<8; j++)
+            _sym_out[n+j] = (y >> (56 - 8*j)) & 0xff;
+        n += 8;
+    }
+
+    return liquid_wlan_unpack_bytes_tail(_sym_in, _sym_in_len, i, _sym_out, n, _bps);
+}
+
+// pack symbols by extracting the lower _bps bits of each of eight
+// bytes (see liquid_wlan_pack_bytes)
+LIQUID_WLAN_TARGET_AVX2
+unsigned int liquid_wlan_pack_bytes_bmi2(unsigned char * _sym_in,
+                                         unsigned int    _sym_in_len,
+                                         unsigned char * _sym_out,
+                                         unsigned int    _bps)
+{
+    unsigned int i;
+    unsigned int j;
+    unsigned int n = 0;
+
+    // full groups of eight symbols into _bps bytes, first symbol in
+    // most-significant byte
+    for (i=0; i+8 <= _sym_in_len; i+=8) {
+        uint64_t y = 0;
+        for (j=0; j<8; j++)
+            y = (y << 8) | _sym_in[i+j];
+        uint64_t x = _pext_u64(y, LIQUID_WLAN_REPACK_MASK(_bps));
+        for (j=0; j<_bps; j++)
+            _sym_out[n+j] = (x >> (8*(_bps-j-1))) & 0xff;
+        n += _bps;
+    }
+
+    return liquid_wlan_pack_bytes_tail(_sym_in, _sym_in_len, i, _sym_out, n, _bps);
+}
+#endif
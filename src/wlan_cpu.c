@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlan_cpu.c
+//
+// Run-time CPU feature dispatch: the host is probed once on first use
+// and the fastest supported implementation of each hot kernel is
+// recorded in a read-only table.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "liquid-wlan.internal.h"
+
+#if defined(__i386__) || defined(__x86_64__)
+#   include <cpuid.h>
+#endif
+
+// kernel names, indexed by WLAN_CPU_KERNEL_*
+const char * const wlan_cpu_kernel_str[WLAN_CPU_NUM_KERNELS] = {
+    "viterbi27",
+    "fft",
+    "modem",
+    "interleaver",
+    "interleaver_soft",
+    "scrambler",
+    "repack",
+    "seek"};
+
+// feature level names, indexed by LIQUID_WLAN_CPU_*
+static const char * const wlan_cpu_level_str[3] = {
+    "generic",
+    "sse2",
+    "avx2"};
+
+// dispatch table, written once under wlan_cpu_once
+static struct wlan_cpu_s wlan_cpu_table;
+static pthread_once_t wlan_cpu_once = PTHREAD_ONCE_INIT;
+static const struct wlan_cpu_s * wlan_cpu_ptr = NULL;
+
+// probe host and apply environment override
+static void wlan_cpu_setup(void)
+{
+    unsigned int level_detected = wlan_cpu_detect();
+    unsigned int level = level_detected;
+    int pdep = wlan_cpu_detect_pdep();
+
+    const char * env = getenv("LIQUID_WLAN_CPU");
+    if (env != NULL)
+        wlan_cpu_override(env, &level, &pdep);
+
+    wlan_cpu_init(&wlan_cpu_table, level, pdep);
+    wlan_cpu_table.level_detected = level_detected;
+    __atomic_store_n(&wlan_cpu_ptr, &wlan_cpu_table, __ATOMIC_RELEASE);
+}
+
+// get kernel dispatch table, detecting host features and applying the
+// LIQUID_WLAN_CPU environment override on first use
+const struct wlan_cpu_s * wlan_cpu_get(void)
+{
+    const struct wlan_cpu_s * q = __atomic_load_n(&wlan_cpu_ptr, __ATOMIC_ACQUIRE);
+    if (q != NULL)
+        return q;
+
+    pthread_once(&wlan_cpu_once, wlan_cpu_setup);
+    return &wlan_cpu_table;
+}
+
+// detect highest feature level supported by host
+unsigned int wlan_cpu_detect(void)
+{
+#if HAVE_CPU_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2"))
+        return LIQUID_WLAN_CPU_AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return LIQUID_WLAN_CPU_SSE2;
+    return LIQUID_WLAN_CPU_GENERIC;
+#else
+    // limited to kernels enabled by compiler flags
+    if (LIQUID_WLAN_HAVE_AVX2)
+        return LIQUID_WLAN_CPU_AVX2;
+    if (LIQUID_WLAN_HAVE_SSE2)
+        return LIQUID_WLAN_CPU_SSE2;
+    return LIQUID_WLAN_CPU_GENERIC;
+#endif
+}
+
+// apply LIQUID_WLAN_CPU override, a comma-separated list in which a
+// level name lowers the level and "nopdep" disables the pext/pdep
+// kernels; unknown entries are ignored
+//  _s          :   override string, e.g. "avx2,nopdep"
+//  _level      :   feature level (LIQUID_WLAN_CPU_*), lowered in place
+//  _pdep       :   pext/pdep kernels enabled?, cleared in place
+void wlan_cpu_override(const char *   _s,
+                       unsigned int * _level,
+                       int *          _pdep)
+{
+    const char * p = _s;
+    while (*p != '\0') {
+        size_t n = strcspn(p, ",");
+        unsigned int i;
+        for (i=0; i<3; i++) {
+            if (strlen(wlan_cpu_level_str[i]) == n && strncmp(p, wlan_cpu_level_str[i], n) == 0)
+                break;
+        }
+        if (i < 3) {
+            if (i < *_level)
+                *_level = i;
+        } else if (n == 6 && strncmp(p, "nopdep", n) == 0) {
+            *_pdep = 0;
+        } else if (n > 0) {
+            fprintf(stderr,"warning: liquid-wlan, unknown LIQUID_WLAN_CPU entry '%.*s' ignored\n", (int)n, p);
+        }
+        p += n;
+        if (*p == ',')
+            p++;
+    }
+}
+
+// detect whether host executes pext/pdep quickly; AMD processors before
+// family 19h (Zen 3) implement them in microcode at a cost of hundreds
+// of cycles, slower than the table and shift kernels they replace
+int wlan_cpu_detect_pdep(void)
+{
+    if (wlan_cpu_detect() < LIQUID_WLAN_CPU_AVX2)
+        return 0;
+
+#if defined(__i386__) || defined(__x86_64__)
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx))
+        return 0;
+
+    // vendor string is stored in ebx, edx, ecx
+    char vendor[13];
+    memmove(&vendor[0], &ebx, 4);
+    memmove(&vendor[4], &edx, 4);
+    memmove(&vendor[8], &ecx, 4);
+    vendor[12] = '\0';
+    if (strcmp(vendor, "AuthenticAMD") != 0 && strcmp(vendor, "HygonGenuine") != 0)
+        return 1;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return 0;
+    unsigned int family = (eax >> 8) & 0x0f;
+    if (family == 0x0f)
+        family += (eax >> 20) & 0xff;
+    return family >= 0x19;
+#else
+    return 1;
+#endif
+}
+
+// fill dispatch table for feature level
+//  _q          :   dispatch table
+//  _level      :   feature level (LIQUID_WLAN_CPU_*)
+//  _pdep       :   use pext/pdep kernels at level LIQUID_WLAN_CPU_AVX2?
+void wlan_cpu_init(struct wlan_cpu_s * _q,
+                   unsigned int        _level,
+                   int                 _pdep)
+{
+    // validate input
+    if (_level > LIQUID_WLAN_CPU_AVX2) {
+        fprintf(stderr,"error: wlan_cpu_init(), invalid level\n");
+        exit(1);
+    }
+
+    _q->level          = _level;
+    _q->level_detected = _level;
+    _q->pdep           = 0;
+
+    // portable kernels
+    _q->viterbi27                 = LIQUID_WLAN_CPU_GENERIC;
+    _q->modulate_block            = wlan_modulate_block_generic;
+    _q->demodulate_block          = wlan_demodulate_block_generic;
+    _q->interleaver_encode_symbol = wlan_interleaver_encode_symbol_tab;
+    _q->interleaver_decode_symbol = wlan_interleaver_decode_symbol_tab;
+    _q->interleaver_gather_soft   = wlan_interleaver_gather_soft_generic;
+    _q->data_scramble_xor         = wlan_data_scramble_xor_generic;
+    _q->unpack_bytes              = liquid_wlan_unpack_bytes_generic;
+    _q->pack_bytes                = liquid_wlan_pack_bytes_generic;
+    _q->seek_metrics              = wlanframesync_wide_seek_generic;
+
+    _q->impl[WLAN_CPU_KERNEL_VITERBI27]        = "port";
+    _q->impl[WLAN_CPU_KERNEL_MODEM]            = "generic";
+    _q->impl[WLAN_CPU_KERNEL_INTERLEAVER]      = "tab";
+    _q->impl[WLAN_CPU_KERNEL_INTERLEAVER_SOFT] = "generic";
+    _q->impl[WLAN_CPU_KERNEL_SCRAMBLER]        = "generic";
+    _q->impl[WLAN_CPU_KERNEL_REPACK]           = "generic";
+    _q->impl[WLAN_CPU_KERNEL_SEEK]             = "generic";
+
+    // transform library dispatches internally
+#if HAVE_FFTW3_H
+    _q->impl[WLAN_CPU_KERNEL_FFT]              = "fftw3";
+#else
+    _q->impl[WLAN_CPU_KERNEL_FFT]              = "liquid";
+#endif
+
+#if LIQUID_WLAN_HAVE_SSE2
+    if (_level >= LIQUID_WLAN_CPU_SSE2) {
+        _q->viterbi27         = LIQUID_WLAN_CPU_SSE2;
+        _q->data_scramble_xor = wlan_data_scramble_xor_sse2;
+
+        _q->impl[WLAN_CPU_KERNEL_VITERBI27]        = "sse2";
+        _q->impl[WLAN_CPU_KERNEL_SCRAMBLER]        = "sse2";
+    }
+#endif
+
+#if LIQUID_WLAN_HAVE_AVX2
+    if (_level >= LIQUID_WLAN_CPU_AVX2) {
+        _q->modulate_block            = wlan_modulate_block_avx2;
+        _q->demodulate_block          = wlan_demodulate_block_avx2;
+        _q->interleaver_gather_soft   = wlan_interleaver_gather_soft_avx2;
+        _q->data_scramble_xor         = wlan_data_scramble_xor_avx2;
+        _q->seek_metrics              = wlanframesync_wide_seek_avx2;
+
+        _q->impl[WLAN_CPU_KERNEL_MODEM]            = "avx2";
+        _q->impl[WLAN_CPU_KERNEL_INTERLEAVER_SOFT] = "avx2";
+        _q->impl[WLAN_CPU_KERNEL_SCRAMBLER]        = "avx2";
+        _q->impl[WLAN_CPU_KERNEL_SEEK]             = "avx2";
+    }
+
+    // pext/pdep kernels, only where the host executes them quickly
+    if (_level >= LIQUID_WLAN_CPU_AVX2 && _pdep) {
+        _q->pdep                      = 1;
+        _q->interleaver_encode_symbol = wlan_interleaver_encode_symbol_word;
+        _q->interleaver_decode_symbol = wlan_interleaver_decode_symbol_word;
+        _q->unpack_bytes              = liquid_wlan_unpack_bytes_bmi2;
+        _q->pack_bytes                = liquid_wlan_pack_bytes_bmi2;
+
+        _q->impl[WLAN_CPU_KERNEL_INTERLEAVER]      = "bmi2";
+        _q->impl[WLAN_CPU_KERNEL_REPACK]           = "bmi2";
+    }
+#endif
+}
+
+// get feature level used by kernels
+unsigned int liquid_wlan_cpu_get_level(void)
+{
+    return wlan_cpu_get()->level;
+}
+
+// get name of implementation selected for kernel, or NULL if the
+// kernel is unknown
+const char * liquid_wlan_cpu_get_kernel(const char * _kernel)
+{
+    const struct wlan_cpu_s * q = wlan_cpu_get();
+    unsigned int i;
+    for (i=0; i<WLAN_CPU_NUM_KERNELS; i++) {
+        if (strcmp(_kernel, wlan_cpu_kernel_str[i]) == 0)
+            return q->impl[i];
+    }
+    return NULL;
+}
+
+// print feature levels and selected kernels
+void liquid_wlan_cpu_print(void)
+{
+    const struct wlan_cpu_s * q = wlan_cpu_get();
+    printf("liquid-wlan cpu:\n");
+    printf("    %-16s:   %s\n", "detected", wlan_cpu_level_str[q->level_detected]);
+    printf("    %-16s:   %s\n", "selected", wlan_cpu_level_str[q->level]);
+    printf("    %-16s:   %s\n", "pdep", q->pdep ? "enabled" : "disabled");
+    unsigned int i;
+    for (i=0; i<WLAN_CPU_NUM_KERNELS; i++)
+        printf("    %-16s:   %s\n", wlan_cpu_kernel_str[i], q->impl[i]);
+}
@@ -24,9 +24,17 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "liquid-wlan.internal.h"
 
+#if LIQUID_WLAN_HAVE_SSE2
+#   include <emmintrin.h>
+#endif
+#if LIQUID_WLAN_HAVE_AVX2
+#   include <immintrin.h>
+#endif
+
 // scramble data
 //  _msg_dec    :   original data message [size: _n x 1]
 //  _msg_enc    :   scrambled data message [size: _n x 1]
@@ -45,19 +53,98 @@ void wlan_data_scramble(unsigned char * _msg_dec,
     // create
     wlan_lfsr ms = wlan_lfsr_create(m, g, a);
 
+    // generate byte masks (shift 8 bits) for one period of the sequence
+    // at most, then extend periodically for unaligned vector loads
+    unsigned char ks[WLAN_DATA_SCRAMBLER_PERIOD+32];
+    unsigned int nks = _n < WLAN_DATA_SCRAMBLER_PERIOD ? _n : WLAN_DATA_SCRAMBLER_PERIOD;
+    unsigned int i;
+    for (i=0; i<nks; i++)
+        ks[i] = wlan_lfsr_generate_symbol(ms, 8);
+    if (nks == WLAN_DATA_SCRAMBLER_PERIOD)
+        memmove(&ks[WLAN_DATA_SCRAMBLER_PERIOD], ks, 32*sizeof(unsigned char));
+
+    // destroy wlan_lfsr object
+    wlan_lfsr_destroy(ms);
+
+    // apply mask
+    wlan_cpu_get()->data_scramble_xor(ks, _msg_dec, _n, _msg_enc);
+}
+
+// apply scrambler key stream to data one byte at a time
+//  _ks         :   key stream [size: WLAN_DATA_SCRAMBLER_PERIOD+32 x 1]
+//  _x          :   input data [size: _n x 1]
+//  _n          :   length of input/output (bytes)
+//  _y          :   output data [size: _n x 1]
+void wlan_data_scramble_xor_generic(const unsigned char * _ks,
+                                    unsigned char *       _x,
+                                    unsigned int          _n,
+                                    unsigned char *       _y)
+{
     unsigned int i;
-    unsigned char mask;
+    unsigned int k = 0;
     for (i=0; i<_n; i++) {
-        // generate byte mask (shift 8 bits)
-        mask = wlan_lfsr_generate_symbol(ms, 8);
+        _y[i] = _x[i] ^ _ks[k];
+        k = (k == WLAN_DATA_SCRAMBLER_PERIOD-1) ? 0 : k+1;
+    }
+}
 
-        // apply mask
-        _msg_enc[i] = _msg_dec[i] ^ mask;
+#if LIQUID_WLAN_HAVE_SSE2
+// apply scrambler key stream to data 16 bytes at a time
+//  _ks         :   key stream [size: WLAN_DATA_SCRAMBLER_PERIOD+32 x 1]
+//  _x          :   input data [size: _n x 1]
+//  _n          :   length of input/output (bytes)
+//  _y          :   output data [size: _n x 1]
+LIQUID_WLAN_TARGET_SSE2
+void wlan_data_scramble_xor_sse2(const unsigned char * _ks,
+                                 unsigned char *       _x,
+                                 unsigned int          _n,
+                                 unsigned char *       _y)
+{
+    // key stream offset k is always less than one period, so 16 bytes
+    // starting at k stay within the extended key stream
+    unsigned int i;
+    unsigned int k = 0;
+    for (i=0; i+16 <= _n; i+=16) {
+        __m128i v = _mm_loadu_si128((__m128i*)&_x[i]);
+        v = _mm_xor_si128(v, _mm_loadu_si128((__m128i*)&_ks[k]));
+        _mm_storeu_si128((__m128i*)&_y[i], v);
+        k += 16;
+        if (k >= WLAN_DATA_SCRAMBLER_PERIOD)
+            k -= WLAN_DATA_SCRAMBLER_PERIOD;
     }
 
-    // destroy wlan_lfsr object
-    wlan_lfsr_destroy(ms);
+    // remaining bytes, within the extended key stream
+    wlan_data_scramble_xor_generic(&_ks[k], &_x[i], _n-i, &_y[i]);
+}
+#endif
+
+#if LIQUID_WLAN_HAVE_AVX2
+// apply scrambler key stream to data 32 bytes at a time
+//  _ks         :   key stream [size: WLAN_DATA_SCRAMBLER_PERIOD+32 x 1]
+//  _x          :   input data [size: _n x 1]
+//  _n          :   length of input/output (bytes)
+//  _y          :   output data [size: _n x 1]
+LIQUID_WLAN_TARGET_AVX2
+void wlan_data_scramble_xor_avx2(const unsigned char * _ks,
+                                 unsigned char *       _x,
+                                 unsigned int          _n,
+                                 unsigned char *       _y)
+{
+    unsigned int i;
+    unsigned int k = 0;
+    for (i=0; i+32 <= _n; i+=32) {
+        __m256i v = _mm256_loadu_si256((__m256i*)&_x[i]);
+        v = _mm256_xor_si256(v, _mm256_loadu_si256((__m256i*)&_ks[k]));
+        _mm256_storeu_si256((__m256i*)&_y[i], v);
+        k += 32;
+        if (k >= WLAN_DATA_SCRAMBLER_PERIOD)
+            k -= WLAN_DATA_SCRAMBLER_PERIOD;
+    }
+
+    // remaining bytes, within the extended key stream
+    wlan_data_scramble_xor_generic(&_ks[k], &_x[i], _n-i, &_y[i]);
 }
+#endif
 
 // unscramble data
 //  _msg_enc    :   scrambled data message [size: _n x 1]
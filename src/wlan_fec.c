@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "liquid-wlan.internal.h"
 
@@ -178,7 +179,7 @@ void wlan_fec_decode(unsigned int    _fec_scheme,
     // compute number of encoded bits with erasure insertions, removing
     // the additional padding to fill last OFDM symbol
     unsigned int num_enc_bits = _dec_msg_len * 8 * R; // - npad;
-    unsigned char enc_bits[num_enc_bits];
+    unsigned char enc_bits[num_enc_bits + R*(K-1)];
 
     if (punctured) {
         // punctured code; add erasures at punctured indices
@@ -216,10 +217,38 @@ void wlan_fec_decode(unsigned int    _fec_scheme,
         }
     }
 
+    // the decoder runs K-1 steps past the message (tail bits are
+    // already inserted); feed it erasures rather than reading past the
+    // end of the buffer
+    memset(&enc_bits[num_enc_bits], LIQUID_WLAN_SOFTBIT_ERASURE, R*(K-1)*sizeof(unsigned char));
+
     // run Viterbi decoder
     void * vp = wlan_create_viterbi27(num_enc_bits);
     wlan_init_viterbi27(vp,0);
     wlan_update_viterbi27_blk(vp, enc_bits, 8*_dec_msg_len + K - 1);
-    wlan_chainback_viterbi27(vp, _msg_dec, num_enc_bits, 0);
+    wlan_chainback_viterbi27(vp, _msg_dec, 8*_dec_msg_len, 0);
+    wlan_delete_viterbi27(vp);
+}
+
+// decode de-punctured soft bits using convolutional code, terminating
+// in the zero state with the tail bits
+//  _nbits      :   number of data bits preceding tail
+//  _soft       :   de-punctured soft bits [size: 2*(_nbits+6) x 1]
+//  _msg_dec    :   decoded message [size: ceil(_nbits/8) x 1]
+void wlan_fec_decode_soft(unsigned int    _nbits,
+                          unsigned char * _soft,
+                          unsigned char * _msg_dec)
+{
+    // validate input
+    if (_nbits == 0) {
+        fprintf(stderr,"error: wlan_fec_decode_soft(), number of bits must be greater than zero\n");
+        exit(1);
+    }
+
+    // run Viterbi decoder through tail bits
+    void * vp = wlan_create_viterbi27(_nbits);
+    wlan_init_viterbi27(vp,0);
+    wlan_update_viterbi27_blk(vp, _soft, _nbits + 6);
+    wlan_chainback_viterbi27(vp, _msg_dec, _nbits, 0);
     wlan_delete_viterbi27(vp);
 }
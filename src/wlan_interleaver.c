@@ -25,11 +25,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 
 #include "liquid-wlan.internal.h"
 
+#if LIQUID_WLAN_HAVE_AVX2
+#   include <immintrin.h>
+#endif
+
 // indexable table of above structured auto-generated tables
-struct wlan_interleaver_tab_s * wlan_intlv_gentab[8] = {
+const struct wlan_interleaver_tab_s * const wlan_intlv_gentab[8] = {
     wlan_intlv_R6,
     wlan_intlv_R9,
     wlan_intlv_R12,
@@ -39,6 +44,17 @@ struct wlan_interleaver_tab_s * wlan_intlv_gentab[8] = {
     wlan_intlv_R48,
     wlan_intlv_R54};
 
+// indexable table of auto-generated soft de-interleaver tables
+const unsigned short * const wlan_intlv_soft_gentab[8] = {
+    wlan_intlv_soft_R6,
+    wlan_intlv_soft_R9,
+    wlan_intlv_soft_R12,
+    wlan_intlv_soft_R18,
+    wlan_intlv_soft_R24,
+    wlan_intlv_soft_R36,
+    wlan_intlv_soft_R48,
+    wlan_intlv_soft_R54};
+
 
 // intereleave one OFDM symbol
 //  _rate       :   primitive rate
@@ -54,11 +70,40 @@ void wlan_interleaver_encode_symbol(unsigned int    _rate,
         exit(1);
     }
 
+    wlan_cpu_get()->interleaver_encode_symbol(_rate, _msg_dec, _msg_enc);
+}
+
+// de-intereleave one OFDM symbol
+//  _rate       :   primitive rate
+//  _msg_enc    :   encoded message (interleaved)
+//  _msg_dec    :   decoded message (de-iterleaved)
+void wlan_interleaver_decode_symbol(unsigned int    _rate,
+                                    unsigned char * _msg_enc,
+                                    unsigned char * _msg_dec)
+{
+    // validate input
+    if (_rate > WLANFRAME_RATE_54) {
+        fprintf(stderr,"error: wlan_interleaver_decode_symbol(), invalid rate\n");
+        exit(1);
+    }
+
+    wlan_cpu_get()->interleaver_decode_symbol(_rate, _msg_enc, _msg_dec);
+}
+
+// intereleave one OFDM symbol one bit at a time using structured table
+//  _rate       :   primitive rate
+//  _msg_dec    :   decoded message (de-iterleaved)
+//  _msg_enc    :   encoded message (interleaved)
+void wlan_interleaver_encode_symbol_tab(unsigned int    _rate,
+                                        unsigned char * _msg_dec,
+                                        unsigned char * _msg_enc)
+{
+
     // number of coded bits per OFDM symbol
     unsigned int ncbps = wlanframe_ratetab[_rate].ncbps;
 
     // retrieve structured interleaver table
-    struct wlan_interleaver_tab_s * intlv = wlan_intlv_gentab[_rate];
+    const struct wlan_interleaver_tab_s * intlv = wlan_intlv_gentab[_rate];
 
     // clear output array
     memset(_msg_enc, 0x00, (ncbps/8)*sizeof(unsigned char));
@@ -77,25 +122,20 @@ void wlan_interleaver_encode_symbol(unsigned int    _rate,
     }
 }
 
-// de-intereleave one OFDM symbol
+// de-intereleave one OFDM symbol one bit at a time using structured table
 //  _rate       :   primitive rate
 //  _msg_enc    :   encoded message (interleaved)
 //  _msg_dec    :   decoded message (de-iterleaved)
-void wlan_interleaver_decode_symbol(unsigned int    _rate,
-                                    unsigned char * _msg_enc,
-                                    unsigned char * _msg_dec)
+void wlan_interleaver_decode_symbol_tab(unsigned int    _rate,
+                                        unsigned char * _msg_enc,
+                                        unsigned char * _msg_dec)
 {
-    // validate input
-    if (_rate > WLANFRAME_RATE_54) {
-        fprintf(stderr,"error: wlan_interleaver_decode_symbol(), invalid rate\n");
-        exit(1);
-    }
 
     // number of coded bits per OFDM symbol
     unsigned int ncbps = wlanframe_ratetab[_rate].ncbps;
 
     // retrieve structured interleaver table
-    struct wlan_interleaver_tab_s * intlv = wlan_intlv_gentab[_rate];
+    const struct wlan_interleaver_tab_s * intlv = wlan_intlv_gentab[_rate];
 
     // clear output array
     memset(_msg_dec, 0x00, (ncbps/8)*sizeof(unsigned char));
@@ -114,3 +154,182 @@ void wlan_interleaver_decode_symbol(unsigned int    _rate,
     }
 }
 
+// de-interleave one OFDM symbol of soft bits (one byte per bit),
+// inserting erasures at punctured indices
+//  _rate       :   primitive rate
+//  _soft_enc   :   interleaved soft bits [size: ncbps x 1]
+//  _soft_dec   :   de-punctured soft bits [size: 2*ndbps x 1]
+void wlan_interleaver_decode_symbol_soft(unsigned int    _rate,
+                                         unsigned char * _soft_enc,
+                                         unsigned char * _soft_dec)
+{
+    // validate input
+    if (_rate > WLANFRAME_RATE_54) {
+        fprintf(stderr,"error: wlan_interleaver_decode_symbol_soft(), invalid rate\n");
+        exit(1);
+    }
+
+    unsigned int ncbps = wlanframe_ratetab[_rate].ncbps;
+    unsigned int ndbps = wlanframe_ratetab[_rate].ndbps;
+    const unsigned short * idx = wlan_intlv_soft_gentab[_rate];
+
+    // copy symbol with erasure appended (index ncbps), padded so that
+    // 32-bit gathers stay within the buffer
+    unsigned char buf[288+4];
+    memmove(buf, _soft_enc, ncbps*sizeof(unsigned char));
+    buf[ncbps] = LIQUID_WLAN_SOFTBIT_ERASURE;
+
+    // 2*ndbps is always a multiple of eight
+    wlan_cpu_get()->interleaver_gather_soft(idx, buf, 2*ndbps, _soft_dec);
+}
+
+// gather soft bits by index one at a time
+//  _idx        :   gather indices [size: _n x 1]
+//  _buf        :   soft bits with erasure appended
+//  _n          :   number of output soft bits
+//  _soft_dec   :   output soft bits [size: _n x 1]
+void wlan_interleaver_gather_soft_generic(const unsigned short * _idx,
+                                          unsigned char *        _buf,
+                                          unsigned int           _n,
+                                          unsigned char *        _soft_dec)
+{
+    unsigned int i;
+    for (i=0; i<_n; i++)
+        _soft_dec[i] = _buf[_idx[i]];
+}
+
+#if LIQUID_WLAN_HAVE_AVX2
+// gather soft bits by index eight at a time, keeping the low byte of
+// each 32-bit lane
+//  _idx        :   gather indices [size: _n x 1]
+//  _buf        :   soft bits with erasure appended, padded by three bytes
+//  _n          :   number of output soft bits, multiple of eight
+//  _soft_dec   :   output soft bits [size: _n x 1]
+LIQUID_WLAN_TARGET_AVX2
+void wlan_interleaver_gather_soft_avx2(const unsigned short * _idx,
+                                       unsigned char *        _buf,
+                                       unsigned int           _n,
+                                       unsigned char *        _soft_dec)
+{
+    unsigned int i;
+    __m256i shuf = _mm256_setr_epi8( 0, 4, 8,12,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+                                     0, 4, 8,12,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1);
+    __m256i perm = _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0);
+    for (i=0; i<_n; i+=8) {
+        __m256i v = _mm256_cvtepu16_epi32(_mm_loadu_si128((__m128i*)&_idx[i]));
+        v = _mm256_i32gather_epi32((const int*)_buf, v, 1);
+        v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, shuf), perm);
+        _mm_storel_epi64((__m128i*)&_soft_dec[i], _mm256_castsi256_si128(v));
+    }
+}
+#endif
+
+#if LIQUID_WLAN_HAVE_AVX2
+// The interleaver permutation factors into a transpose and a rotation:
+// coded bit k = 16*q + r is first moved to i = C*r + q (C = ncbps/16),
+// then rotated within groups of s = max(nbpsc/2,1) bits by r mod s.
+// Bits in column r are spaced 16 apart in the input and are contiguous
+// and in order in the output, so each column is gathered from 64-bit
+// words with a single pext/pdep mask, four bits per word.
+
+// rotate each group of _s bits within column block by one position
+// towards the most-significant bit
+static inline uint32_t wlan_interleaver_rotate(uint32_t     _x,
+                                               unsigned int _s)
+{
+    if (_s == 2)
+        return ((_x << 1) & 0xaaaaa) | ((_x >> 1) & 0x55555);
+
+    // _s == 3: column block is 18 bits
+    return ((_x << 1) & 0x36db6) | ((_x >> 2) & 0x09249);
+}
+
+// intereleave one OFDM symbol using 64-bit words
+//  _rate       :   primitive rate
+//  _msg_dec    :   decoded message (de-iterleaved)
+//  _msg_enc    :   encoded message (interleaved)
+LIQUID_WLAN_TARGET_AVX2
+void wlan_interleaver_encode_symbol_word(unsigned int    _rate,
+                                         unsigned char * _msg_dec,
+                                         unsigned char * _msg_enc)
+{
+    unsigned int ncbps  = wlanframe_ratetab[_rate].ncbps;
+    unsigned int nbpsc  = wlanframe_ratetab[_rate].nbpsc;
+    unsigned int s      = nbpsc < 4 ? 1 : nbpsc/2;
+    unsigned int C      = ncbps / 16;
+    unsigned int nwords = (ncbps + 63) / 64;
+
+    // load coded bits into big-endian words, padding with zeros
+    uint64_t w[5] = {0, 0, 0, 0, 0};
+    unsigned int i;
+    for (i=0; i<ncbps/8; i++)
+        w[i/8] |= (uint64_t)_msg_dec[i] << (56 - 8*(i%8));
+
+    // gather columns and write sequentially to output
+    uint64_t acc = 0;
+    unsigned int nbits = 0;
+    unsigned int n = 0;
+    unsigned int r;
+    for (r=0; r<16; r++) {
+        uint64_t mask = 0x8000800080008000ULL >> r;
+        uint32_t x = 0;
+        for (i=0; i<nwords; i++)
+            x = (x << 4) | (uint32_t)_pext_u64(w[i], mask);
+        x >>= 4*nwords - C;
+
+        for (i=0; i<r%s; i++)
+            x = wlan_interleaver_rotate(x, s);
+
+        acc = (acc << C) | x;
+        nbits += C;
+        while (nbits >= 8) {
+            nbits -= 8;
+            _msg_enc[n++] = (acc >> nbits) & 0xff;
+        }
+    }
+}
+
+// de-intereleave one OFDM symbol using 64-bit words
+//  _rate       :   primitive rate
+//  _msg_enc    :   encoded message (interleaved)
+//  _msg_dec    :   decoded message (de-iterleaved)
+LIQUID_WLAN_TARGET_AVX2
+void wlan_interleaver_decode_symbol_word(unsigned int    _rate,
+                                         unsigned char * _msg_enc,
+                                         unsigned char * _msg_dec)
+{
+    unsigned int ncbps  = wlanframe_ratetab[_rate].ncbps;
+    unsigned int nbpsc  = wlanframe_ratetab[_rate].nbpsc;
+    unsigned int s      = nbpsc < 4 ? 1 : nbpsc/2;
+    unsigned int C      = ncbps / 16;
+    unsigned int nwords = (ncbps + 63) / 64;
+
+    // read columns sequentially from input and scatter
+    uint64_t w[5] = {0, 0, 0, 0, 0};
+    uint64_t acc = 0;
+    unsigned int nbits = 0;
+    unsigned int n = 0;
+    unsigned int r;
+    unsigned int i;
+    for (r=0; r<16; r++) {
+        while (nbits < C) {
+            acc = (acc << 8) | _msg_enc[n++];
+            nbits += 8;
+        }
+        nbits -= C;
+        uint32_t x = (acc >> nbits) & ((1U << C) - 1);
+
+        for (i=0; i<(s - r%s)%s; i++)
+            x = wlan_interleaver_rotate(x, s);
+
+        uint64_t mask = 0x8000800080008000ULL >> r;
+        x <<= 4*nwords - C;
+        for (i=0; i<nwords; i++)
+            w[i] |= _pdep_u64((x >> (4*(nwords-i-1))) & 0xf, mask);
+    }
+
+    // store big-endian words
+    for (i=0; i<ncbps/8; i++)
+        _msg_dec[i] = (w[i/8] >> (56 - 8*(i%8))) & 0xff;
+}
+#endif
@@ -84,6 +84,44 @@ unsigned int wlan_lfsr_advance(wlan_lfsr _ms)
     return _ms->b;      // return result
 }
 
+// advance wlan_lfsr by _n steps in O(m^2 log _n) operations; the
+// shift register update is linear over GF(2), so the state after _n
+// steps is the initial state multiplied by the _n-th power of the
+// companion matrix, computed by repeated squaring
+//  _ms     :   m-sequence object
+//  _n      :   number of steps
+void wlan_lfsr_jump(wlan_lfsr    _ms,
+                    unsigned int _n)
+{
+    if (_n == 0)
+        return;
+
+    // companion matrix columns: single step applied to each basis vector
+    unsigned int A[32];
+    unsigned int T[32];
+    unsigned int i;
+    for (i=0; i<_ms->m; i++)
+        A[i] = wlan_lfsr_step(1U << i, _ms->g, _ms->n);
+
+    unsigned int v = _ms->v;
+    while (_n) {
+        // apply current power of matrix to state
+        if (_n & 1)
+            v = wlan_lfsr_matvec(A, _ms->m, v);
+
+        // square matrix
+        for (i=0; i<_ms->m; i++)
+            T[i] = wlan_lfsr_matvec(A, _ms->m, A[i]);
+        memmove(A, T, _ms->m*sizeof(unsigned int));
+
+        _n >>= 1;
+    }
+
+    // last bit pushed onto register is the output bit
+    _ms->v = v;
+    _ms->b = v & 1;
+}
+
 // generate pseudo-random symbol from shift register
 //  _ms     :   m-sequence object
 //  _bps    :   bits per symbol of output
@@ -105,3 +143,32 @@ void wlan_lfsr_reset(wlan_lfsr _ms)
     _ms->v = _ms->a;
 }
 
+//
+// internal methods
+//
+
+// advance shift register state by one step
+//  _v      :   shift register state
+//  _g      :   generator polynomial (most significant bit removed)
+//  _n      :   register mask, (2^m)-1
+unsigned int wlan_lfsr_step(unsigned int _v,
+                            unsigned int _g,
+                            unsigned int _n)
+{
+    return ((_v << 1) | liquid_wlan_bdotprod(_v, _g)) & _n;
+}
+
+// multiply GF(2) matrix by vector
+//  _A      :   matrix columns [size: _m x 1]
+//  _m      :   matrix dimension
+//  _v      :   input vector
+unsigned int wlan_lfsr_matvec(unsigned int * _A,
+                              unsigned int   _m,
+                              unsigned int   _v)
+{
+    unsigned int i;
+    unsigned int r = 0;
+    for (i=0; i<_m; i++)
+        r ^= ((_v >> i) & 1) ? _A[i] : 0;
+    return r;
+}
@@ -29,6 +29,10 @@
 
 #include "liquid-wlan.internal.h"
 
+#if LIQUID_WLAN_HAVE_AVX2
+#   include <immintrin.h>
+#endif
+
 //
 // modulation
 //
@@ -175,10 +179,245 @@ unsigned char wlan_demodulate_qam64(float complex _sample)
     return (sym_i << 3) | sym_q;
 }
 
+//
+// block modulation/demodulation
+//
+
+// modulate block of symbols; every scheme is a table look-up
+//  _scheme     :   modulation scheme (e.g. WLAN_MODEM_QAM16)
+//  _sym        :   input symbols [size: _n x 1]
+//  _n          :   number of symbols
+//  _x          :   output samples [size: _n x 1]
+void wlan_modulate_block(unsigned int    _scheme,
+                         unsigned char * _sym,
+                         unsigned int    _n,
+                         float complex * _x)
+{
+    const float complex * table;
+    unsigned int mask;
+    switch (_scheme) {
+    case WLAN_MODEM_BPSK:  table = wlan_modem_bpsk;  mask = 0x00; break;
+    case WLAN_MODEM_QPSK:  table = wlan_modem_qpsk;  mask = 0x03; break;
+    case WLAN_MODEM_QAM16: table = wlan_modem_qam16; mask = 0x0f; break;
+    case WLAN_MODEM_QAM64: table = wlan_modem_qam64; mask = 0x3f; break;
+    default:
+        fprintf(stderr,"error: wlan_modulate_block(), invalid scheme\n");
+        exit(1);
+    }
+
+    // BPSK maps any non-zero symbol to +1
+    unsigned int i;
+    if (_scheme == WLAN_MODEM_BPSK) {
+        for (i=0; i<_n; i++)
+            _x[i] = table[_sym[i] != 0];
+        return;
+    }
+
+    wlan_cpu_get()->modulate_block(table, mask, _sym, _n, _x);
+}
+
+// modulate block of symbols by table look-up, one at a time
+//  _table      :   modulation table
+//  _mask       :   symbol mask
+//  _sym        :   input symbols [size: _n x 1]
+//  _n          :   number of symbols
+//  _x          :   output samples [size: _n x 1]
+void wlan_modulate_block_generic(const float complex * _table,
+                                 unsigned int          _mask,
+                                 unsigned char *       _sym,
+                                 unsigned int          _n,
+                                 float complex *       _x)
+{
+    unsigned int i;
+    for (i=0; i<_n; i++)
+        _x[i] = _table[_sym[i] & _mask];
+}
+
+#if LIQUID_WLAN_HAVE_AVX2
+// modulate block of symbols by table look-up, gathering four complex
+// samples (as 64-bit values) at a time
+//  _table      :   modulation table
+//  _mask       :   symbol mask
+//  _sym        :   input symbols [size: _n x 1]
+//  _n          :   number of symbols
+//  _x          :   output samples [size: _n x 1]
+LIQUID_WLAN_TARGET_AVX2
+void wlan_modulate_block_avx2(const float complex * _table,
+                              unsigned int          _mask,
+                              unsigned char *       _sym,
+                              unsigned int          _n,
+                              float complex *       _x)
+{
+    unsigned int i;
+    __m128i m = _mm_set1_epi32(_mask);
+    for (i=0; i+4 <= _n; i+=4) {
+        __m128i idx = _mm_and_si128(_mm_setr_epi32(_sym[i], _sym[i+1], _sym[i+2], _sym[i+3]), m);
+        __m256d v = _mm256_i32gather_pd((const double*)_table, idx, 8);
+        _mm256_storeu_pd((double*)&_x[i], v);
+    }
+
+    // remaining symbols
+    for (; i<_n; i++)
+        _x[i] = _table[_sym[i] & _mask];
+}
+#endif
+
+// demodulate one dimension of square constellation without branches,
+// returning gray-decoded bits
+//  _v          :   in-phase or quadrature component
+//  _t          :   decision thresholds, largest first [size: _nbits-1 x 1]
+//  _nbits      :   bits per dimension
+static inline unsigned int wlan_demodulate_pam(float         _v,
+                                               const float * _t,
+                                               unsigned int  _nbits)
+{
+    unsigned int s = 0;
+    unsigned int k;
+    for (k=0; k<_nbits; k++) {
+        unsigned int b = _v > 0.0f;
+        s = (s << 1) | b;
+        if (k < _nbits-1)
+            _v -= b ? _t[k] : -_t[k];
+    }
+    return s ^ (s >> 1);
+}
+
+#if LIQUID_WLAN_HAVE_AVX2
+// demodulate one dimension of four complex samples (eight lanes),
+// returning gray-decoded bits in each 32-bit lane
+//  _v          :   interleaved in-phase and quadrature components
+//  _t          :   decision thresholds, largest first [size: _nbits-1 x 1]
+//  _nbits      :   bits per dimension
+LIQUID_WLAN_TARGET_AVX2
+static inline __m256i wlan_demodulate_pam_avx2(__m256        _v,
+                                               const float * _t,
+                                               unsigned int  _nbits)
+{
+    __m256i s = _mm256_setzero_si256();
+    __m256  z = _mm256_setzero_ps();
+    unsigned int k;
+    for (k=0; k<_nbits; k++) {
+        __m256 mask = _mm256_cmp_ps(_v, z, _CMP_GT_OQ);
+        s = _mm256_or_si256(_mm256_slli_epi32(s, 1),
+                            _mm256_srli_epi32(_mm256_castps_si256(mask), 31));
+        if (k < _nbits-1) {
+            __m256 t = _mm256_set1_ps(_t[k]);
+            _v = _mm256_sub_ps(_v, _mm256_blendv_ps(_mm256_sub_ps(z, t), t, mask));
+        }
+    }
+    return _mm256_xor_si256(s, _mm256_srli_epi32(s, 1));
+}
+#endif
+
+// demodulate block of samples (hard decision); results are identical
+// to wlan_demodulate()
+//  _scheme     :   modulation scheme (e.g. WLAN_MODEM_QAM16)
+//  _x          :   input samples [size: _n x 1]
+//  _n          :   number of samples
+//  _sym        :   output symbols [size: _n x 1]
+void wlan_demodulate_block(unsigned int    _scheme,
+                           float complex * _x,
+                           unsigned int    _n,
+                           unsigned char * _sym)
+{
+    // decision thresholds for each scheme
+    static const float t16[1] = {0.6324555f};
+    static const float t64[2] = {0.6172134f, 0.3086067f};
+
+    const float * t;
+    unsigned int nbits;
+    switch (_scheme) {
+    case WLAN_MODEM_BPSK:  t = NULL; nbits = 1; break;
+    case WLAN_MODEM_QPSK:  t = NULL; nbits = 1; break;
+    case WLAN_MODEM_QAM16: t = t16;  nbits = 2; break;
+    case WLAN_MODEM_QAM64: t = t64;  nbits = 3; break;
+    default:
+        fprintf(stderr,"error: wlan_demodulate_block(), invalid scheme\n");
+        exit(1);
+    }
+
+    // BPSK uses in-phase component only
+    unsigned int i;
+    if (_scheme == WLAN_MODEM_BPSK) {
+        for (i=0; i<_n; i++)
+            _sym[i] = crealf(_x[i]) > 0.0f;
+        return;
+    }
+
+    wlan_cpu_get()->demodulate_block(t, nbits, _x, _n, _sym);
+}
+
+// demodulate block of samples one at a time
+//  _t          :   decision thresholds, largest first [size: _nbits-1 x 1]
+//  _nbits      :   bits per dimension
+//  _x          :   input samples [size: _n x 1]
+//  _n          :   number of samples
+//  _sym        :   output symbols [size: _n x 1]
+void wlan_demodulate_block_generic(const float *   _t,
+                                   unsigned int    _nbits,
+                                   float complex * _x,
+                                   unsigned int    _n,
+                                   unsigned char * _sym)
+{
+    unsigned int i;
+    for (i=0; i<_n; i++) {
+        unsigned int sym_i = wlan_demodulate_pam(crealf(_x[i]), _t, _nbits);
+        unsigned int sym_q = wlan_demodulate_pam(cimagf(_x[i]), _t, _nbits);
+        _sym[i] = (sym_i << _nbits) | sym_q;
+    }
+}
+
+#if LIQUID_WLAN_HAVE_AVX2
+// demodulate block of samples four at a time: even lanes hold in-phase
+// bits and odd lanes hold quadrature bits
+//  _t          :   decision thresholds, largest first [size: _nbits-1 x 1]
+//  _nbits      :   bits per dimension
+//  _x          :   input samples [size: _n x 1]
+//  _n          :   number of samples
+//  _sym        :   output symbols [size: _n x 1]
+LIQUID_WLAN_TARGET_AVX2
+void wlan_demodulate_block_avx2(const float *   _t,
+                                unsigned int    _nbits,
+                                float complex * _x,
+                                unsigned int    _n,
+                                unsigned char * _sym)
+{
+    unsigned int i;
+    for (i=0; i+4 <= _n; i+=4) {
+        __m256i s = wlan_demodulate_pam_avx2(_mm256_loadu_ps((float*)&_x[i]), _t, _nbits);
+        unsigned int v[8];
+        _mm256_storeu_si256((__m256i*)v, s);
+        _sym[i+0] = (v[0] << _nbits) | v[1];
+        _sym[i+1] = (v[2] << _nbits) | v[3];
+        _sym[i+2] = (v[4] << _nbits) | v[5];
+        _sym[i+3] = (v[6] << _nbits) | v[7];
+    }
+
+    // remaining samples
+    for (; i<_n; i++) {
+        unsigned int sym_i = wlan_demodulate_pam(crealf(_x[i]), _t, _nbits);
+        unsigned int sym_q = wlan_demodulate_pam(cimagf(_x[i]), _t, _nbits);
+        _sym[i] = (sym_i << _nbits) | sym_q;
+    }
+}
+#endif
+
 // 
 // modulation tables
 //
 
+// BPSK modulation table
+const float complex wlan_modem_bpsk[2] = {
+     -1.0f,                                 //   0
+      1.0f};                                //   1
+
+// QPSK modulation table
+const float complex wlan_modem_qpsk[4] = {
+     -M_SQRT1_2 +  -M_SQRT1_2*_Complex_I,   //   0
+     -M_SQRT1_2 +   M_SQRT1_2*_Complex_I,   //   1
+      M_SQRT1_2 +  -M_SQRT1_2*_Complex_I,   //   2
+      M_SQRT1_2 +   M_SQRT1_2*_Complex_I};  //   3
+
 // 16-QAM modulation table
 const float complex wlan_modem_qam16[16] = {
      -0.94868326 +  -0.94868326*_Complex_I, //   0
@@ -58,26 +58,20 @@ unsigned int wlan_packet_compute_enc_msg_len(unsigned int _rate,
     div_t d = div(16 + 8*_length + 6, ndbps);
     unsigned int nsym = d.quot + (d.rem == 0 ? 0 : 1);
 
-    // compute number of bits in the DATA field
-    unsigned int ndata = nsym * ndbps;
-
-#if 0
-    // compute number of pad bits
-    unsigned int npad = ndata - (16 + 8*_length + 6);
-#endif
-
-    // compute decoded message length (number of data bytes)
-    // NOTE : because ndbps is _always_ divisible by 8, so must ndata be
-    unsigned int dec_msg_len = ndata / 8;
-
-    // compute encoded message length (number of data bytes)
-    unsigned int enc_msg_len = (dec_msg_len * ncbps) / ndbps;
+    // compute encoded message length (number of data bytes); ncbps is
+    // always divisible by 8, even when ndbps is not (rate 9)
+    unsigned int enc_msg_len = (nsym * ncbps) / 8;
 
     // return length of encoded message (bytes)
     return enc_msg_len;
 }
 
 // assemble data (prepend SERVICE bits, etc.), scramble, encode, interleave
+//  _rate       :   primitive rate
+//  _seed       :   data scrambler seed
+//  _length     :   original data length (bytes)
+//  _msg_dec    :   original data [size: _length x 1]
+//  _msg_enc    :   encoded data [size: wlan_packet_compute_enc_msg_len() x 1]
 void wlan_packet_encode(unsigned int    _rate,
                         unsigned int    _seed,
                         unsigned int    _length,
@@ -90,117 +84,15 @@ void wlan_packet_encode(unsigned int    _rate,
         exit(1);
     }
 
-    // strip parameters
-    unsigned int length = _length;                          // original data length (bytes)
-    unsigned int ndbps  = wlanframe_ratetab[_rate].ndbps;   // number of data bits per OFDM symbol
-    unsigned int ncbps  = wlanframe_ratetab[_rate].ncbps;   // number of coded bits per OFDM symbol
-//  unsigned int nbpsc  = wlanframe_ratetab[_rate].nbpsc;   // number of bits per subcarrier (modulation depth)
-    unsigned int seed   = _seed;                            // 0x5d; // data scrambler seed
-
-    // forward error-correction scheme
-    unsigned int fec_scheme = wlanframe_ratetab[_rate].fec_scheme;
-
-    // compute number of OFDM symbols
-    div_t d = div(16 + 8*length + 6, ndbps);
-    unsigned int nsym = d.quot + (d.rem == 0 ? 0 : 1);
-
-    // compute number of bits in the DATA field
-    unsigned int ndata = nsym * ndbps;
-
-#if DEBUG_PACKET_CODEC
-    // compute number of pad bits
-    unsigned int npad = ndata - (16 + 8*length + 6);
-#endif
-
-    // compute decoded message length (number of data bytes)
-    // NOTE : because ndbps is _always_ divisible by 8, so must ndata be
-    unsigned int dec_msg_len = ndata / 8;
-
-    // compute encoded message length (number of data bytes)
-    unsigned int enc_msg_len = (dec_msg_len * ncbps) / ndbps;
-
-    // print status
-#if DEBUG_PACKET_CODEC
-    printf("    nsym        :   %3u symbols\n", nsym);
-    printf("    ndata       :   %3u bits\n", ndata);
-    printf("    npad        :   %3u bits\n", npad);
-    printf("    dec msg len :   %3u bytes\n", dec_msg_len);
-    printf("    enc msg len :   %3u bytes\n", enc_msg_len);
-#endif
-
-    unsigned char msg_org[dec_msg_len];         // original message
-    unsigned char msg_scrambled[dec_msg_len];   // scrambled message
-    unsigned char msg_enc[enc_msg_len];         // encoded message
-    unsigned char msg_int[enc_msg_len];         // interleaved message
-
-    unsigned int i;
-
-    // 
-    // assemble raw data message (prepend SERVICE bits, reverse bytes,
-    // add padding)
-    //
-    msg_org[0] = 0x00;
-    msg_org[1] = 0x00;
-    for (i=0; i<length; i++)
-        msg_org[i+2] = liquid_wlan_reverse_byte[_msg_dec[i]];
-    for (i=length+2; i<dec_msg_len; i++)
-        msg_org[i] = 0x00;
-
-#if DEBUG_PACKET_CODEC
-    // print original message
-    printf("original data (verify with Table G.13/G.14):\n");
-    liquid_print_byte_array(msg_org, dec_msg_len);
-#endif
-
-    // 
-    // scramble data
-    //
-    wlan_data_scramble(msg_org, msg_scrambled, dec_msg_len, seed);
-
-    // zero tail bits (basically just revert scrambling these bits). For the
-    // example given in Annex G, this amounts to the 6 bits after the SERVICE
-    // and data bits (indices 816..821).
-    msg_scrambled[length+2] &= 0x03;
-
-#if DEBUG_PACKET_CODEC
-    // print scrambled message
-    printf("scrambled data (verify with Table G.16/G.17):\n");
-    liquid_print_byte_array(msg_scrambled, dec_msg_len);
-#endif
-
-    // 
-    // encode data
-    //
-    wlan_fec_encode(fec_scheme, dec_msg_len, msg_scrambled, msg_enc);
-    // NOTE: tail bits are already inserted into 'decoded' message
-
-#if DEBUG_PACKET_CODEC
-    // print encoded message
-    printf("encoded data (verify with Table G.18):\n");
-    liquid_print_byte_array(msg_enc, enc_msg_len);
-#endif
-
-    // 
-    // interleave symbols
-    //
-   
-    for (i=0; i<nsym; i++)
-        wlan_interleaver_encode_symbol(_rate, &msg_enc[(i*ncbps)/8], &msg_int[(i*ncbps)/8]);
-
-#if DEBUG_PACKET_CODEC
-    // print interleaved message
-    printf("interleaved data (verify with Table G.21):\n");
-    liquid_print_byte_array(msg_int, enc_msg_len);
-#endif
-    
-    // copy result to output
-    memmove(_msg_enc, msg_int, enc_msg_len*sizeof(unsigned char));
-
-    return;
+    wlan_packet_codec[_rate].encode(_seed, _length, _msg_dec, _msg_enc);
 }
 
 // de-interleave, decode, de-scramble, extract data (SERVICE bits, etc.)
-// TODO : return seed...
+//  _rate       :   primitive rate
+//  _seed       :   data scrambler seed
+//  _length     :   original data length (bytes)
+//  _msg_enc    :   encoded data [size: wlan_packet_compute_enc_msg_len() x 1]
+//  _msg_dec    :   decoded data [size: _length x 1]
 void wlan_packet_decode(unsigned int    _rate,
                         unsigned int    _seed,
                         unsigned int    _length,
@@ -213,111 +105,224 @@ void wlan_packet_decode(unsigned int    _rate,
         exit(1);
     }
 
-    // strip parameters
-    unsigned int length = _length;                          // original data length (bytes)
-    unsigned int ndbps  = wlanframe_ratetab[_rate].ndbps;   // number of data bits per OFDM symbol
-    unsigned int ncbps  = wlanframe_ratetab[_rate].ncbps;   // number of coded bits per OFDM symbol
-//  unsigned int nbpsc  = wlanframe_ratetab[_rate].nbpsc;   // number of bits per subcarrier (modulation depth)
-    unsigned int seed   = _seed;                            // 0x5d; // data scrambler seed
-
-    // forward error-correction scheme
-    unsigned int fec_scheme = wlanframe_ratetab[_rate].fec_scheme;
-
-    // compute number of OFDM symbols
-    div_t d = div(16 + 8*length + 6, ndbps);
-    unsigned int nsym = d.quot + (d.rem == 0 ? 0 : 1);
-
-    // compute number of bits in the DATA field
-    unsigned int ndata = nsym * ndbps;
-
-#if DEBUG_PACKET_CODEC
-    // compute number of pad bits
-    unsigned int npad = ndata - (16 + 8*length + 6);
-#endif
-
-    // compute decoded message length (number of data bytes)
-    // NOTE : because ndbps is _always_ divisible by 8, so must ndata be
-    unsigned int dec_msg_len = ndata / 8;
-
-    // compute encoded message length (number of data bytes)
-    unsigned int enc_msg_len = (dec_msg_len * ncbps) / ndbps;
-
-#if DEBUG_PACKET_CODEC
-    // print status
-    printf("    nsym        :   %3u symbols\n", nsym);
-    printf("    ndata       :   %3u bits\n", ndata);
-    printf("    npad        :   %3u bits\n", npad);
-    printf("    dec msg len :   %3u bytes\n", dec_msg_len);
-    printf("    enc msg len :   %3u bytes\n", enc_msg_len);
-#endif
-
-    unsigned char msg_deint[enc_msg_len];       // de-interleaved message
-    unsigned char msg_dec[dec_msg_len];         // decoded message
-    unsigned char msg_unscrambled[dec_msg_len]; // unscrambled message
-    unsigned char msg_rx[length];               // recovered message (compare to msg_data)
-    
-    unsigned int i;
-
+    wlan_packet_codec[_rate].decode(_seed, _length, _msg_enc, _msg_dec);
+}
 
-    //
-    // de-interleave symbols
-    //
+// de-interleave soft bits, decode, de-scramble, extract data
+//  _rate       :   primitive rate
+//  _seed       :   data scrambler seed
+//  _length     :   original data length (bytes)
+//  _soft_enc   :   interleaved soft bits [size: nsym*ncbps x 1]
+//  _msg_dec    :   decoded data [size: _length x 1]
+void wlan_packet_decode_soft(unsigned int    _rate,
+                             unsigned int    _seed,
+                             unsigned int    _length,
+                             unsigned char * _soft_enc,
+                             unsigned char * _msg_dec)
+{
+    // validate input
+    if (_rate > 7) {
+        fprintf(stderr,"error: wlan_packet_decode_soft(), invalid rate\n");
+        exit(1);
+    }
 
-    for (i=0; i<nsym; i++)
-        wlan_interleaver_decode_symbol(_rate, &_msg_enc[(i*ncbps)/8], &msg_deint[(i*ncbps)/8]);
+    wlan_packet_codec[_rate].decode_soft(_seed, _length, _soft_enc, _msg_dec);
+}
 
-#if DEBUG_PACKET_CODEC
-    // print de-interleaved message
-    printf("de-interleaved data (verify with Table G.18):\n");
-    liquid_print_byte_array(msg_deint, enc_msg_len);
-#endif
+//
+// rate-specialized codecs
+//
 
-    //
-    // decode message
-    //
+// Each codec below is a thin wrapper around an always-inlined body
+// invoked with constant rate parameters, so that symbol counts divide
+// by constants and the puncturing loops unroll completely.
+#define WLAN_PACKET_INLINE static inline __attribute__((always_inline))
+
+// encode one OFDM symbol of data bits with the r1/2 K=7 code and a
+// fixed puncturing pattern; puncturing restarts on every symbol
+//  _ndbps      :   number of data bits per symbol, multiple of _P
+//  _P          :   puncturing period
+//  _mask0      :   puncturing mask for first polynomial
+//  _mask1      :   puncturing mask for second polynomial
+//  _msg_dec    :   data bits, most-significant bit first
+//  _k          :   index of first data bit in symbol
+//  _sr         :   convolutional shift register (input/output)
+//  _msg_enc    :   coded bits [size: ncbps/8 x 1]
+WLAN_PACKET_INLINE void wlan_packet_fec_encode_symbol(const unsigned int _ndbps,
+                                                      const unsigned int _P,
+                                                      const unsigned int _mask0,
+                                                      const unsigned int _mask1,
+                                                      unsigned char *    _msg_dec,
+                                                      unsigned int       _k,
+                                                      unsigned int *     _sr,
+                                                      unsigned char *    _msg_enc)
+{
+    unsigned int sr    = *_sr;
+    unsigned int acc   = 0;     // output bit accumulator
+    unsigned int nbits = 0;     // number of bits in accumulator
+    unsigned int n     = 0;     // output byte index
+    unsigned int i;
+    unsigned int j;
+    for (i=0; i<_ndbps; i+=_P) {
+        // one puncturing period
+        for (j=0; j<_P; j++) {
+            unsigned int k = _k + i + j;
+            sr = ((sr << 1) | ((_msg_dec[k/8] >> (7-(k%8))) & 0x01)) & 0x7f;
+            if ((_mask0 >> j) & 1) {
+                acc = (acc << 1) | parity(sr & V27POLYA);
+                nbits++;
+            }
+            if ((_mask1 >> j) & 1) {
+                acc = (acc << 1) | parity(sr & V27POLYB);
+                nbits++;
+            }
+        }
+
+        // push full output bytes
+        while (nbits >= 8) {
+            nbits -= 8;
+            _msg_enc[n++] = (acc >> nbits) & 0xff;
+        }
+    }
+    *_sr = sr;
+}
 
-    wlan_fec_decode(fec_scheme, dec_msg_len, msg_deint, msg_dec);
+// assemble data, scramble, encode and interleave (see wlan_packet_encode)
+WLAN_PACKET_INLINE void wlan_packet_encode_rate(const unsigned int _rate,
+                                                const unsigned int _ndbps,
+                                                const unsigned int _ncbps,
+                                                const unsigned int _P,
+                                                const unsigned int _mask0,
+                                                const unsigned int _mask1,
+                                                unsigned int       _seed,
+                                                unsigned int       _length,
+                                                unsigned char *    _msg_dec,
+                                                unsigned char *    _msg_enc)
+{
+    const struct wlan_cpu_s * cpu = wlan_cpu_get();
 
-#if DEBUG_PACKET_CODEC
-    // print decoded message
-    // NOTE : clip padding and tail bits
-    printf("decoded data (verify with Table G.16/G.17):\n");
-    //liquid_print_byte_array(msg_dec, dec_msg_len);
-    liquid_print_byte_array(msg_dec, length+2);
-#endif
+    // number of OFDM symbols and data bytes, rounding up for rate 9
+    unsigned int nsym        = (16 + 8*_length + 6 + _ndbps - 1) / _ndbps;
+    unsigned int dec_msg_len = (nsym*_ndbps + 7) / 8;
 
+    // assemble raw data message (prepend SERVICE bits, reverse bytes,
+    // add padding)
+    unsigned char msg_org[dec_msg_len];
+    unsigned int i;
+    msg_org[0] = 0x00;
+    msg_org[1] = 0x00;
+    for (i=0; i<_length; i++)
+        msg_org[i+2] = liquid_wlan_reverse_byte[_msg_dec[i]];
+    for (i=_length+2; i<dec_msg_len; i++)
+        msg_org[i] = 0x00;
 
-    //
-    // unscramble data
-    //
+    // scramble data in place and zero tail bits
+    wlan_data_scramble(msg_org, msg_org, dec_msg_len, _seed);
+    msg_org[_length+2] &= 0x03;
 
-    // TODO : strip scrambling seed from header?
-    wlan_data_scramble(msg_dec, msg_unscrambled, dec_msg_len, seed);
+    // encode and interleave one symbol at a time
+    unsigned char msg_enc[288/8];
+    unsigned int sr = 0;
+    for (i=0; i<nsym; i++) {
+        wlan_packet_fec_encode_symbol(_ndbps, _P, _mask0, _mask1, msg_org, i*_ndbps, &sr, msg_enc);
+        cpu->interleaver_encode_symbol(_rate, msg_enc, &_msg_enc[i*(_ncbps/8)]);
+    }
+}
 
-#if DEBUG_PACKET_CODEC
-    // print unscrambled message
-    // NOTE : clip padding bits
-    printf("unscrambled data (verify with Table G.13/G.14):\n");
-    //liquid_print_byte_array(msg_unscrambled, dec_msg_len);
-    liquid_print_byte_array(msg_unscrambled, length+2);
-#endif
+// de-interleave hard or soft bits, decode, de-scramble and extract data
+// (see wlan_packet_decode, wlan_packet_decode_soft)
+WLAN_PACKET_INLINE void wlan_packet_decode_rate(const unsigned int _rate,
+                                                const unsigned int _ndbps,
+                                                const unsigned int _ncbps,
+                                                const int          _soft,
+                                                unsigned int       _seed,
+                                                unsigned int       _length,
+                                                unsigned char *    _msg_enc,
+                                                unsigned char *    _msg_dec)
+{
+    // number of OFDM symbols
+    unsigned int nsym = (16 + 8*_length + 6 + _ndbps - 1) / _ndbps;
 
-    //
-    // recover original data sequence
-    //
+    // de-interleave symbols, inserting erasures; hard bits are first
+    // expanded to soft bits
+    unsigned char soft_dec[2*nsym*_ndbps];
+    unsigned char soft_enc[288];
+    unsigned int i;
+    unsigned int j;
+    for (i=0; i<nsym; i++) {
+        if (_soft) {
+            wlan_interleaver_decode_symbol_soft(_rate, &_msg_enc[i*_ncbps], &soft_dec[2*i*_ndbps]);
+            continue;
+        }
+        unsigned char * msg = &_msg_enc[i*(_ncbps/8)];
+        for (j=0; j<_ncbps; j++)
+            soft_enc[j] = (msg[j/8] >> (7-(j%8))) & 0x01 ? LIQUID_WLAN_SOFTBIT_1 : LIQUID_WLAN_SOFTBIT_0;
+        wlan_interleaver_decode_symbol_soft(_rate, soft_enc, &soft_dec[2*i*_ndbps]);
+    }
 
-    // strip SERVICE bits/padding, and reverse bytes
-    for (i=0; i<length; i++)
-        msg_rx[i] = liquid_wlan_reverse_byte[ msg_unscrambled[i+2] ];
+    // decode SERVICE and data bits, terminating with tail; padding
+    // bits are not decoded
+    unsigned char msg_dec[_length+2];
+    wlan_fec_decode_soft(16 + 8*_length, soft_dec, msg_dec);
 
-#if DEBUG_PACKET_CODEC
-    // print recovered message
-    printf("recovered data (verify with Table G.1):\n");
-    liquid_print_byte_array(msg_rx, length);
-#endif
+    // unscramble data in place
+    wlan_data_scramble(msg_dec, msg_dec, _length+2, _seed);
 
-    // copy to output
-    memmove(_msg_dec, msg_rx, length*sizeof(unsigned char));
+    // strip SERVICE bits and reverse bytes
+    for (i=0; i<_length; i++)
+        _msg_dec[i] = liquid_wlan_reverse_byte[ msg_dec[i+2] ];
+}
 
-    return;
+// define encoder and hard/soft decoders for one rate
+//  R           :   rate in Mbits/s (e.g. 36)
+//  NDBPS       :   number of data bits per OFDM symbol
+//  NCBPS       :   number of coded bits per OFDM symbol
+//  P           :   puncturing period
+//  M           :   puncturing mask suffix (e.g. V27P34)
+#define WLAN_PACKET_CODEC_DEFINE(R,NDBPS,NCBPS,P,M)                         \
+static void wlan_packet_encode_R##R(unsigned int    _seed,                  \
+                                    unsigned int    _length,                \
+                                    unsigned char * _msg_dec,               \
+                                    unsigned char * _msg_enc)               \
+{                                                                           \
+    wlan_packet_encode_rate(WLANFRAME_RATE_##R, NDBPS, NCBPS, P,            \
+                            WLANCONV_##M##_MASK0, WLANCONV_##M##_MASK1,     \
+                            _seed, _length, _msg_dec, _msg_enc);            \
+}                                                                           \
+static void wlan_packet_decode_R##R(unsigned int    _seed,                  \
+                                    unsigned int    _length,                \
+                                    unsigned char * _msg_enc,               \
+                                    unsigned char * _msg_dec)               \
+{                                                                           \
+    wlan_packet_decode_rate(WLANFRAME_RATE_##R, NDBPS, NCBPS, 0,            \
+                            _seed, _length, _msg_enc, _msg_dec);            \
+}                                                                           \
+static void wlan_packet_decode_soft_R##R(unsigned int    _seed,             \
+                                         unsigned int    _length,           \
+                                         unsigned char * _soft_enc,         \
+                                         unsigned char * _msg_dec)          \
+{                                                                           \
+    wlan_packet_decode_rate(WLANFRAME_RATE_##R, NDBPS, NCBPS, 1,            \
+                            _seed, _length, _soft_enc, _msg_dec);           \
 }
+
+//                       rate ndbps ncbps  P  puncturing
+WLAN_PACKET_CODEC_DEFINE(6,    24,   48,   1, V27P12)
+WLAN_PACKET_CODEC_DEFINE(9,    36,   48,   9, V27P34)
+WLAN_PACKET_CODEC_DEFINE(12,   48,   96,   1, V27P12)
+WLAN_PACKET_CODEC_DEFINE(18,   72,   96,   9, V27P34)
+WLAN_PACKET_CODEC_DEFINE(24,   96,  192,   1, V27P12)
+WLAN_PACKET_CODEC_DEFINE(36,  144,  192,   9, V27P34)
+WLAN_PACKET_CODEC_DEFINE(48,  192,  288,   6, V27P23)
+WLAN_PACKET_CODEC_DEFINE(54,  216,  288,   9, V27P34)
+
+// rate-specialized codecs, indexed by rate
+const struct wlan_packet_codec_s wlan_packet_codec[8] = {
+    {wlan_packet_encode_R6,  wlan_packet_decode_R6,  wlan_packet_decode_soft_R6 },
+    {wlan_packet_encode_R9,  wlan_packet_decode_R9,  wlan_packet_decode_soft_R9 },
+    {wlan_packet_encode_R12, wlan_packet_decode_R12, wlan_packet_decode_soft_R12},
+    {wlan_packet_encode_R18, wlan_packet_decode_R18, wlan_packet_decode_soft_R18},
+    {wlan_packet_encode_R24, wlan_packet_decode_R24, wlan_packet_decode_soft_R24},
+    {wlan_packet_encode_R36, wlan_packet_decode_R36, wlan_packet_decode_soft_R36},
+    {wlan_packet_encode_R48, wlan_packet_decode_R48, wlan_packet_decode_soft_R48},
+    {wlan_packet_encode_R54, wlan_packet_decode_R54, wlan_packet_decode_soft_R54}};
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// polyphase rational resampler
+//
+// Resamples by _P/_Q: the input is conceptually up-sampled by _P,
+// filtered with a windowed-sinc prototype, and down-sampled by _Q. Only
+// the polyphase branch required for each output sample is computed.
+//
+// The input can optionally be mixed down as it is copied into the
+// filter buffer, so that a digital down-converter costs no additional
+// pass over the samples.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "liquid-wlan.internal.h"
+
+#define DEBUG_WLAN_RESAMP   0
+
+struct wlan_resamp_s {
+    unsigned int P;             // interpolation factor
+    unsigned int Q;             // decimation factor
+    unsigned int m;             // filter semi-length (input samples)
+    unsigned int L;             // number of taps per polyphase branch
+
+    // polyphase filter bank; each tap is duplicated so that the dot
+    // product with interleaved complex samples runs over plain floats
+    float * h;                  // [size: P x 2L]
+
+    // input buffer: L-1 samples of history followed by new input
+    float complex * buffer;     // [size: L-1 + buffer_len]
+    unsigned int buffer_len;    // maximum number of new input samples
+    unsigned int t;             // up-sampled time of next output
+
+    // input mixing
+    int mix_enabled;            // mix input down?
+    float complex mix;          // mixing phasor
+    float complex mix_step;     // mixing phasor step per input sample
+};
+
+// zeroth-order modified Bessel function of the first kind
+float wlan_resamp_besseli0(float _x)
+{
+    float t = 0.25f*_x*_x;
+    float y = 1.0f;
+    float v = 1.0f;
+    unsigned int k;
+    for (k=1; k<32; k++) {
+        v *= t / (float)(k*k);
+        y += v;
+    }
+    return y;
+}
+
+// create rational resampler object
+//  _P          :   interpolation factor, _P > 0
+//  _Q          :   decimation factor, _Q > 0
+//  _m          :   filter semi-length (input samples), _m > 0
+wlan_resamp wlan_resamp_create(unsigned int _P,
+                               unsigned int _Q,
+                               unsigned int _m)
+{
+    // validate input
+    if (_P == 0 || _Q == 0) {
+        fprintf(stderr,"error: wlan_resamp_create(), resampling factors must be greater than zero\n");
+        exit(1);
+    } else if (_m == 0) {
+        fprintf(stderr,"error: wlan_resamp_create(), filter semi-length must be greater than zero\n");
+        exit(1);
+    }
+
+    wlan_resamp q = (wlan_resamp) malloc(sizeof(struct wlan_resamp_s));
+    q->P = _P;
+    q->Q = _Q;
+    q->m = _m;
+
+    // number of taps per branch; the branch length in floats (4m) is
+    // always a multiple of four
+    q->L = 2*q->m;
+
+    // design prototype: windowed sinc with cut-off at the lower of the
+    // input and output Nyquist rates, Kaiser window (beta = 7)
+    unsigned int M = q->P > q->Q ? q->P : q->Q;
+    float fc = 0.5f / (float)M;
+    float beta = 7.0f;
+    unsigned int h_len = q->P * q->L;
+    float h[h_len];
+    unsigned int i;
+    for (i=0; i<h_len; i++) {
+        float t = (float)i - (float)(q->m*q->P);
+        float r = t / (float)(q->m*q->P);
+        float w = fabsf(r) < 1.0f ? wlan_resamp_besseli0(beta*sqrtf(1.0f - r*r)) / wlan_resamp_besseli0(beta) : 0.0f;
+        float s = t == 0.0f ? 1.0f : sinf(2.0f*M_PI*fc*t) / (2.0f*M_PI*fc*t);
+        h[i] = 2.0f * fc * s * w * (float)(q->P);
+    }
+
+    // split into polyphase branches, time-reversing each so that the
+    // filter runs forward over the input buffer
+    //   y(n*P + p) = sum_j h[p + j*P] x[n - j]
+    q->h = (float*) malloc(q->P*2*q->L*sizeof(float));
+    unsigned int p, j;
+    for (p=0; p<q->P; p++) {
+        for (j=0; j<q->L; j++) {
+            float v = h[p + j*q->P];
+            q->h[p*2*q->L + 2*(q->L-j-1) + 0] = v;
+            q->h[p*2*q->L + 2*(q->L-j-1) + 1] = v;
+        }
+    }
+
+    // mixing disabled by default
+    q->mix_enabled = 0;
+    q->mix_step    = 1.0f;
+
+    // allocate buffer
+    q->buffer_len = 0;
+    q->buffer = (float complex*) malloc((q->L-1)*sizeof(float complex));
+
+    // reset object
+    wlan_resamp_reset(q);
+
+    return q;
+}
+
+// destroy rational resampler object
+void wlan_resamp_destroy(wlan_resamp _q)
+{
+    free(_q->h);
+    free(_q->buffer);
+    free(_q);
+}
+
+// reset rational resampler object internal state
+void wlan_resamp_reset(wlan_resamp _q)
+{
+    memset(_q->buffer, 0x00, (_q->L-1)*sizeof(float complex));
+    _q->t = 0;
+    _q->mix = 1.0f;
+}
+
+// set frequency by which the input is mixed down as it enters the
+// filter, in cycles per input sample; zero disables mixing
+//  _q          :   resampler object
+//  _f          :   mixing frequency, -0.5 <= _f <= 0.5
+void wlan_resamp_set_frequency(wlan_resamp _q,
+                               float       _f)
+{
+    // validate input
+    if (_f < -0.5f || _f > 0.5f) {
+        fprintf(stderr,"error: wlan_resamp_set_frequency(), frequency must be in [-0.5,0.5]\n");
+        exit(1);
+    }
+
+    _q->mix_enabled = _f != 0.0f;
+    _q->mix_step    = cexpf(-_Complex_I*2.0f*M_PI*_f);
+}
+
+// get number of output samples produced by next _n input samples
+unsigned int wlan_resamp_get_num_output(wlan_resamp  _q,
+                                        unsigned int _n)
+{
+    unsigned int T = _n*_q->P;
+    return _q->t >= T ? 0 : (T - _q->t + _q->Q - 1) / _q->Q;
+}
+
+// execute rational resampler on input block
+//  _q          :   resampler object
+//  _x          :   input samples [size: _nx x 1]
+//  _nx         :   number of input samples
+//  _y          :   output samples [size: wlan_resamp_get_num_output(_q,_nx) x 1]
+//  _ny         :   number of output samples written
+void wlan_resamp_execute(wlan_resamp     _q,
+                         float complex * _x,
+                         unsigned int    _nx,
+                         float complex * _y,
+                         unsigned int *  _ny)
+{
+    // grow buffer as necessary and append input after history
+    if (_nx > _q->buffer_len) {
+        _q->buffer_len = _nx;
+        _q->buffer = (float complex*) realloc(_q->buffer, (_q->L-1+_q->buffer_len)*sizeof(float complex));
+    }
+    if (_q->mix_enabled) {
+        float complex * b = &_q->buffer[_q->L-1];
+        unsigned int i;
+        for (i=0; i<_nx; i++) {
+            b[i] = _x[i] * _q->mix;
+            _q->mix *= _q->mix_step;
+        }
+        // normalize phasor to prevent its magnitude from drifting
+        _q->mix /= cabsf(_q->mix);
+    } else {
+        memmove(&_q->buffer[_q->L-1], _x, _nx*sizeof(float complex));
+    }
+
+    // compute outputs; output at up-sampled time t uses input n = t/P
+    // (window ends at buffer index n+L-1) and branch p = t%P
+    unsigned int T = _nx*_q->P;
+    unsigned int ny = 0;
+    while (_q->t < T) {
+        unsigned int n = _q->t / _q->P;
+        unsigned int p = _q->t % _q->P;
+        _y[ny++] = wlan_dotprod_crcf(&_q->h[p*2*_q->L], &_q->buffer[n], _q->L);
+        _q->t += _q->Q;
+    }
+    _q->t -= T;
+
+    // retain history
+    memmove(_q->buffer, &_q->buffer[_nx], (_q->L-1)*sizeof(float complex));
+    *_ny = ny;
+}
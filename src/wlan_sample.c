@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// sample format conversion
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#ifdef __SSE2__
+#   include <emmintrin.h>
+#endif
+
+#include "liquid-wlan.internal.h"
+
+// convert complex float samples to interleaved int16 I/Q, scaling,
+// rounding to nearest and saturating
+//  _x          :   input samples [size: _n x 1]
+//  _n          :   number of samples
+//  _scale      :   scaling factor
+//  _y          :   output I/Q pairs [size: 2*_n x 1]
+void liquid_wlan_cf_to_sc16(float complex * _x,
+                            unsigned int    _n,
+                            float           _scale,
+                            int16_t *       _y)
+{
+    float * x = (float*) _x;
+    unsigned int i = 0;
+
+#ifdef __SSE2__
+    // eight floats (four complex samples) at a time; clipping before
+    // conversion keeps out-of-range values from wrapping to INT_MIN
+    __m128 s  = _mm_set1_ps(_scale);
+    __m128 hi = _mm_set1_ps( 32767.0f);
+    __m128 lo = _mm_set1_ps(-32768.0f);
+    for (; i+8 <= 2*_n; i+=8) {
+        __m128 v0 = _mm_mul_ps(_mm_loadu_ps(&x[i  ]), s);
+        __m128 v1 = _mm_mul_ps(_mm_loadu_ps(&x[i+4]), s);
+        v0 = _mm_max_ps(_mm_min_ps(v0, hi), lo);
+        v1 = _mm_max_ps(_mm_min_ps(v1, hi), lo);
+        __m128i w = _mm_packs_epi32(_mm_cvtps_epi32(v0), _mm_cvtps_epi32(v1));
+        _mm_storeu_si128((__m128i*)&_y[i], w);
+    }
+#endif
+
+    // remaining samples
+    for (; i<2*_n; i++) {
+        float v = x[i] * _scale;
+        v = v >  32767.0f ?  32767.0f : v;
+        v = v < -32768.0f ? -32768.0f : v;
+        _y[i] = (int16_t) lrintf(v);
+    }
+}
+
+// convert interleaved int16 I/Q to complex float samples
+//  _x          :   input I/Q pairs [size: 2*_n x 1]
+//  _n          :   number of samples
+//  _scale      :   scaling factor
+//  _y          :   output samples [size: _n x 1]
+void liquid_wlan_sc16_to_cf(int16_t *       _x,
+                            unsigned int    _n,
+                            float           _scale,
+                            float complex * _y)
+{
+    float * y = (float*) _y;
+    unsigned int i = 0;
+
+#ifdef __SSE2__
+    // eight values (four complex samples) at a time: sign-extend to
+    // 32 bits by unpacking into the upper half and shifting down
+    __m128 s = _mm_set1_ps(_scale);
+    for (; i+8 <= 2*_n; i+=8) {
+        __m128i w  = _mm_loadu_si128((__m128i*)&_x[i]);
+        __m128i w0 = _mm_srai_epi32(_mm_unpacklo_epi16(w, w), 16);
+        __m128i w1 = _mm_srai_epi32(_mm_unpackhi_epi16(w, w), 16);
+        _mm_storeu_ps(&y[i  ], _mm_mul_ps(_mm_cvtepi32_ps(w0), s));
+        _mm_storeu_ps(&y[i+4], _mm_mul_ps(_mm_cvtepi32_ps(w1), s));
+    }
+#endif
+
+    // remaining samples
+    for (; i<2*_n; i++)
+        y[i] = (float)_x[i] * _scale;
+}
+
+// convert interleaved int8 I/Q to complex float samples
+//  _x          :   input I/Q pairs [size: 2*_n x 1]
+//  _n          :   number of samples
+//  _scale      :   scaling factor
+//  _y          :   output samples [size: _n x 1]
+void liquid_wlan_sc8_to_cf(int8_t *        _x,
+                           unsigned int    _n,
+                           float           _scale,
+                           float complex * _y)
+{
+    float * y = (float*) _y;
+    unsigned int i;
+    for (i=0; i<2*_n; i++)
+        y[i] = (float)_x[i] * _scale;
+}
@@ -0,0 +1,496 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlancapture.c
+//
+// Memory-mapped I/Q capture file reader. The file is mapped read-only
+// and handed out in blocks, in the file's own sample format, directly
+// from the mapping: samples are converted (if at all) by the consumer
+// in cache-sized pieces, e.g. wlanframesync_execute_sc16(). Blocks are
+// aligned to WLANCAPTURE_BLOCK_SIZE bytes in the file; the kernel is
+// told the file is read sequentially, blocks ahead of the reader are
+// prefetched, and blocks behind it are released from the mapping so
+// that the resident set stays small however large the capture.
+//
+// The sample format (and rate) may be read from a SigMF metadata file
+// next to the capture (<name>.sigmf-meta, for <name>.sigmf-data or
+// <name>), or else inferred from the file extension.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "liquid-wlan.internal.h"
+
+#if HAVE_SYS_MMAN_H
+#   include <sys/mman.h>
+#endif
+
+struct wlancapture_s {
+    int fd;                         // file descriptor
+    unsigned char * map;            // file mapping (NULL if empty)
+    size_t map_len;                 // mapping length (bytes)
+    unsigned int flags;             // options
+
+    // format
+    int format;                     // sample format
+    unsigned int sample_size;       // bytes per sample
+    float sample_rate;              // sample rate (0 if unknown)
+
+    // reading
+    unsigned long int num_samples;  // number of samples in file
+    unsigned long int position;     // next sample to read
+    unsigned int block_len;         // samples per block
+
+    // offline decoding
+    wlancapture_config config;      // synchronizer configuration (NULL if none)
+    void * config_userdata;         // user data for configuration callback
+    char * index;                   // frame index file name (NULL if none)
+};
+
+// open capture file
+//  _filename   :   capture file name
+//  _format     :   sample format, e.g. LIQUID_WLAN_CAPTURE_SC16
+//  _flags      :   options, e.g. LIQUID_WLAN_CAPTURE_HUGE_PAGES
+wlancapture wlancapture_open(const char * _filename,
+                             int          _format,
+                             unsigned int _flags)
+{
+    // validate input
+    if (_format < LIQUID_WLAN_CAPTURE_AUTO || _format > LIQUID_WLAN_CAPTURE_SC8) {
+        fprintf(stderr,"error: wlancapture_open(), invalid sample format\n");
+        exit(1);
+    }
+#if !HAVE_SYS_MMAN_H
+    fprintf(stderr,"error: wlancapture_open(), memory-mapped files unsupported\n");
+    exit(1);
+#endif
+
+    wlancapture q = (wlancapture) malloc(sizeof(struct wlancapture_s));
+    q->flags       = _flags;
+    q->sample_rate = 0.0f;
+    q->config      = NULL;
+    q->config_userdata = NULL;
+    q->index       = NULL;
+
+    // read format from metadata and file name; explicit format wins
+    int format = wlancapture_read_sidecar(q, _filename);
+    if (format == LIQUID_WLAN_CAPTURE_AUTO)
+        format = wlancapture_format_from_name(_filename);
+    q->format = _format != LIQUID_WLAN_CAPTURE_AUTO ? _format : format;
+    switch (q->format) {
+    case LIQUID_WLAN_CAPTURE_CF32: q->sample_size = 2*sizeof(float);   break;
+    case LIQUID_WLAN_CAPTURE_SC16: q->sample_size = 2*sizeof(int16_t); break;
+    case LIQUID_WLAN_CAPTURE_SC8:  q->sample_size = 2*sizeof(int8_t);  break;
+    default:
+        fprintf(stderr,"error: wlancapture_open(), could not determine sample format of '%s'\n", _filename);
+        exit(1);
+    }
+    q->block_len = WLANCAPTURE_BLOCK_SIZE / q->sample_size;
+
+    // open and map file
+    struct stat st;
+    q->fd = open(_filename, O_RDONLY);
+    if (q->fd < 0 || fstat(q->fd, &st) != 0) {
+        fprintf(stderr,"error: wlancapture_open(), could not open '%s' for reading\n", _filename);
+        exit(1);
+    }
+    q->num_samples = (unsigned long int)st.st_size / q->sample_size;
+    q->map_len     = q->num_samples * q->sample_size;
+    q->map         = NULL;
+#if HAVE_SYS_MMAN_H
+    if (q->map_len > 0) {
+        void * map = mmap(NULL, q->map_len, PROT_READ, MAP_SHARED, q->fd, 0);
+        if (map == MAP_FAILED) {
+            fprintf(stderr,"error: wlancapture_open(), could not map '%s'\n", _filename);
+            exit(1);
+        }
+        q->map = (unsigned char*) map;
+    }
+#endif
+
+#if HAVE_MADVISE
+    if (q->map != NULL) {
+        madvise(q->map, q->map_len, MADV_SEQUENTIAL);
+#   ifdef MADV_HUGEPAGE
+        // only honored where the file system supports huge pages in the
+        // page cache (e.g. tmpfs); ignored otherwise
+        if (q->flags & LIQUID_WLAN_CAPTURE_HUGE_PAGES)
+            madvise(q->map, q->map_len, MADV_HUGEPAGE);
+#   endif
+    }
+#endif
+
+    // start reading at first sample
+    wlancapture_seek(q, 0);
+
+    return q;
+}
+
+// close capture file
+void wlancapture_close(wlancapture _q)
+{
+#if HAVE_SYS_MMAN_H
+    if (_q->map != NULL)
+        munmap(_q->map, _q->map_len);
+#endif
+    close(_q->fd);
+    free(_q->index);
+    free(_q);
+}
+
+// print capture file reader object internals
+void wlancapture_print(wlancapture _q)
+{
+    const char * formats[4] = {"auto", "cf32", "sc16", "sc8"};
+    printf("wlancapture:\n");
+    printf("    format      :   %s\n", formats[_q->format]);
+    printf("    sample rate :   %.6g\n", _q->sample_rate);
+    printf("    samples     :   %lu\n", _q->num_samples);
+    printf("    position    :   %lu\n", _q->position);
+}
+
+// get sample format, e.g. LIQUID_WLAN_CAPTURE_SC16
+int wlancapture_get_format(wlancapture _q)
+{
+    return _q->format;
+}
+
+// get sample rate from metadata, or zero if unknown
+float wlancapture_get_sample_rate(wlancapture _q)
+{
+    return _q->sample_rate;
+}
+
+// get number of samples in capture
+unsigned long int wlancapture_get_num_samples(wlancapture _q)
+{
+    return _q->num_samples;
+}
+
+// set configuration applied to each frame synchronizer created by
+// wlancapture_decode() and wlancapture_decode_index()
+//  _q          :   capture file reader
+//  _config     :   configuration callback (NULL: default synchronizer)
+//  _userdata   :   user-defined data structure passed to _config
+void wlancapture_set_config(wlancapture        _q,
+                            wlancapture_config _config,
+                            void *             _userdata)
+{
+    _q->config          = _config;
+    _q->config_userdata = _userdata;
+}
+
+// set frame index file written by subsequent calls to
+// wlancapture_decode()
+//  _q          :   capture file reader
+//  _filename   :   index file name (NULL: no index)
+void wlancapture_set_index(wlancapture  _q,
+                           const char * _filename)
+{
+    free(_q->index);
+    _q->index = NULL;
+    if (_filename != NULL) {
+        _q->index = (char*) malloc((strlen(_filename)+1)*sizeof(char));
+        strcpy(_q->index, _filename);
+    }
+}
+
+// set position of next sample to read
+//  _q      :   capture file reader
+//  _sample :   sample index, _sample <= number of samples
+void wlancapture_seek(wlancapture       _q,
+                      unsigned long int _sample)
+{
+    // validate input
+    if (_sample > _q->num_samples) {
+        fprintf(stderr,"error: wlancapture_seek(), position exceeds number of samples\n");
+        exit(1);
+    }
+    _q->position = _sample;
+
+    // prefetch blocks ahead of new position
+    unsigned long int b = _q->position / _q->block_len;
+    unsigned int i;
+    for (i=0; i<WLANCAPTURE_READAHEAD; i++)
+        wlancapture_advise(_q, b+i, 1);
+}
+
+// get next block of samples in the capture's own format, without
+// copying; blocks end on WLANCAPTURE_BLOCK_SIZE boundaries in the file
+// and the returned pointer is read-only
+//  _q      :   capture file reader
+//  _block  :   samples (output), e.g. interleaved int16 I/Q for sc16
+unsigned int wlancapture_read(wlancapture   _q,
+                              const void ** _block)
+{
+    if (_q->position >= _q->num_samples) {
+        *_block = NULL;
+        return 0;
+    }
+
+    // release previous block, prefetch ahead
+    unsigned long int b = _q->position / _q->block_len;
+    if (b > 0)
+        wlancapture_advise(_q, b-1, 0);
+    wlancapture_advise(_q, b+WLANCAPTURE_READAHEAD, 1);
+
+    // read to end of block
+    unsigned long int end = (b+1)*_q->block_len;
+    if (end > _q->num_samples)
+        end = _q->num_samples;
+    unsigned int n = (unsigned int)(end - _q->position);
+
+    *_block = &_q->map[_q->position * _q->sample_size];
+    _q->position = end;
+    return n;
+}
+
+// run next block of samples through frame synchronizer, converting
+// sample format as it is consumed, returning number of samples (zero
+// at end of capture)
+//  _q      :   capture file reader
+//  _fs     :   frame synchronizer
+unsigned int wlancapture_execute(wlancapture   _q,
+                                 wlanframesync _fs)
+{
+    const void * block;
+    unsigned int n = wlancapture_read(_q, &block);
+    if (n > 0)
+        wlancapture_execute_block(_q, _fs, block, n);
+    return n;
+}
+
+//
+// internal methods
+//
+
+// get frame index file name (NULL if none)
+const char * wlancapture_get_index(wlancapture _q)
+{
+    return _q->index;
+}
+
+// can capture be decoded offline? either a synchronizer configuration
+// is set (e.g. a front-end), or the sample rate is 20 MHz or unknown
+int wlancapture_is_decodable(wlancapture _q)
+{
+    return _q->config != NULL || _q->sample_rate == 0.0f || fabsf(_q->sample_rate - 20e6f) < 1.0f;
+}
+
+// create frame synchronizer for offline decoding, applying the
+// configuration set with wlancapture_set_config()
+//  _q          :   capture file reader
+//  _callback   :   frame synchronizer callback
+//  _userdata   :   user-defined data structure
+wlanframesync wlancapture_create_framesync(wlancapture            _q,
+                                           wlanframesync_callback _callback,
+                                           void *                 _userdata)
+{
+    wlanframesync fs = wlanframesync_create(_callback, _userdata);
+    if (_q->config != NULL)
+        _q->config(fs, _q->config_userdata);
+    return fs;
+}
+
+// run samples through frame synchronizer in capture's own format
+//  _q      :   capture file reader
+//  _fs     :   frame synchronizer
+//  _block  :   samples within mapping
+//  _n      :   number of samples
+void wlancapture_execute_block(wlancapture   _q,
+                               wlanframesync _fs,
+                               const void *  _block,
+                               unsigned int  _n)
+{
+    // synchronizer does not write to its input
+    switch (_q->format) {
+    case LIQUID_WLAN_CAPTURE_CF32:
+        wlanframesync_execute(_fs, (float complex*)_block, _n);
+        break;
+    case LIQUID_WLAN_CAPTURE_SC16:
+        wlanframesync_execute_sc16(_fs, (int16_t*)_block, _n);
+        break;
+    case LIQUID_WLAN_CAPTURE_SC8:
+        wlanframesync_execute_sc8(_fs, (int8_t*)_block, _n);
+        break;
+    default:;
+    }
+}
+
+// run range of samples through frame synchronizer, independent of
+// reading position (safe to call from several threads at once)
+//  _q      :   capture file reader
+//  _fs     :   frame synchronizer
+//  _start  :   first sample
+//  _end    :   end of range, _start <= _end <= number of samples
+void wlancapture_execute_range(wlancapture       _q,
+                               wlanframesync     _fs,
+                               unsigned long int _start,
+                               unsigned long int _end)
+{
+    // process block by block, prefetching ahead and releasing behind;
+    // a block released while another thread reads it is faulted back
+    // in from the page cache
+    unsigned long int n = _start;
+    unsigned long int b = n / _q->block_len;
+    unsigned int i;
+    for (i=0; i<WLANCAPTURE_READAHEAD; i++)
+        wlancapture_advise(_q, b+i, 1);
+    while (n < _end) {
+        b = n / _q->block_len;
+        unsigned long int end = (b+1)*_q->block_len < _end ? (b+1)*_q->block_len : _end;
+        if (n > _start)
+            wlancapture_advise(_q, b-1, 0);
+        wlancapture_advise(_q, b+WLANCAPTURE_READAHEAD, 1);
+        wlancapture_execute_block(_q, _fs, &_q->map[n*_q->sample_size], (unsigned int)(end - n));
+        n = end;
+    }
+}
+
+// prefetch range of samples, e.g. a frame's window for random access
+//  _q      :   capture file reader
+//  _start  :   first sample
+//  _end    :   end of range, _start <= _end <= number of samples
+void wlancapture_prefetch(wlancapture       _q,
+                          unsigned long int _start,
+                          unsigned long int _end)
+{
+#if HAVE_MADVISE
+    if (_q->map == NULL || _end <= _start)
+        return;
+
+    // advice must start on a page boundary
+    size_t page   = (size_t)sysconf(_SC_PAGESIZE);
+    size_t offset = (_start * _q->sample_size) & ~(page - 1);
+    madvise(_q->map + offset, _end * _q->sample_size - offset, MADV_WILLNEED);
+#endif
+}
+
+// get samples within mapping, in capture's own format
+//  _q      :   capture file reader
+//  _sample :   sample index, _sample < number of samples
+const void * wlancapture_get_samples(wlancapture       _q,
+                                     unsigned long int _sample)
+{
+    return &_q->map[_sample * _q->sample_size];
+}
+
+// advise kernel of block access
+//  _q      :   capture file reader
+//  _block  :   block index (ignored beyond end of capture)
+//  _needed :   prefetch (1) or release (0) block
+void wlancapture_advise(wlancapture       _q,
+                        unsigned long int _block,
+                        int               _needed)
+{
+#if HAVE_MADVISE
+    size_t offset = _block * WLANCAPTURE_BLOCK_SIZE;
+    if (_q->map == NULL || offset >= _q->map_len)
+        return;
+    size_t len = _q->map_len - offset < WLANCAPTURE_BLOCK_SIZE ? _q->map_len - offset : WLANCAPTURE_BLOCK_SIZE;
+
+    // file-backed pages dropped from the mapping stay in the page cache
+    // and are faulted back in if read again
+    madvise(_q->map + offset, len, _needed ? MADV_WILLNEED : MADV_DONTNEED);
+#endif
+}
+
+// get sample format from file name extension
+int wlancapture_format_from_name(const char * _filename)
+{
+    const char * ext = strrchr(_filename, '.');
+    if (ext == NULL)
+        return LIQUID_WLAN_CAPTURE_AUTO;
+    if (strcmp(ext, ".cf32") == 0 || strcmp(ext, ".fc32") == 0 || strcmp(ext, ".cfile") == 0)
+        return LIQUID_WLAN_CAPTURE_CF32;
+    if (strcmp(ext, ".sc16") == 0 || strcmp(ext, ".cs16") == 0)
+        return LIQUID_WLAN_CAPTURE_SC16;
+    if (strcmp(ext, ".sc8") == 0 || strcmp(ext, ".cs8") == 0)
+        return LIQUID_WLAN_CAPTURE_SC8;
+    return LIQUID_WLAN_CAPTURE_AUTO;
+}
+
+// read SigMF metadata next to capture, if any, setting sample rate and
+// returning sample format (LIQUID_WLAN_CAPTURE_AUTO if not found); only
+// the global "core:datatype" and "core:sample_rate" fields are read
+int wlancapture_read_sidecar(wlancapture  _q,
+                             const char * _filename)
+{
+    // metadata file name: replace ".sigmf-data" or append ".sigmf-meta"
+    size_t len = strlen(_filename);
+    char filename[len + 12];
+    strcpy(filename, _filename);
+    if (len > 11 && strcmp(&filename[len-11], ".sigmf-data") == 0)
+        filename[len-11] = '\0';
+    strcat(filename, ".sigmf-meta");
+
+    // read entire file
+    FILE * fid = fopen(filename, "r");
+    if (fid == NULL)
+        return LIQUID_WLAN_CAPTURE_AUTO;
+    char meta[WLANCAPTURE_META_LEN];
+    size_t n = fread(meta, 1, sizeof(meta)-1, fid);
+    meta[n] = '\0';
+    fclose(fid);
+
+    // sample rate
+    char * p = wlancapture_find_value(meta, "\"core:sample_rate\"");
+    if (p != NULL)
+        _q->sample_rate = strtof(p, NULL);
+
+    // data type: little-endian complex types only
+    p = wlancapture_find_value(meta, "\"core:datatype\"");
+    if (p == NULL || *p != '"')
+        return LIQUID_WLAN_CAPTURE_AUTO;
+    p++;
+    if (strncmp(p, "cf32_le\"", 8) == 0)
+        return LIQUID_WLAN_CAPTURE_CF32;
+    if (strncmp(p, "ci16_le\"", 8) == 0)
+        return LIQUID_WLAN_CAPTURE_SC16;
+    if (strncmp(p, "ci8\"", 4) == 0)
+        return LIQUID_WLAN_CAPTURE_SC8;
+
+    fprintf(stderr,"error: wlancapture_open(), unsupported data type in '%s'\n", filename);
+    exit(1);
+}
+
+// find value of JSON field, returning pointer to its first character
+// (NULL if not found)
+//  _json   :   JSON text
+//  _key    :   field name, including quotes
+char * wlancapture_find_value(char *       _json,
+                              const char * _key)
+{
+    char * p = strstr(_json, _key);
+    if (p == NULL || (p = strchr(p + strlen(_key), ':')) == NULL)
+        return NULL;
+    p++;
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+        p++;
+    return p;
+}
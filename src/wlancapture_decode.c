@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlancapture_decode.c
+//
+// Parallel offline decoding of a capture file. The capture is cut into
+// segments which worker threads decode independently, each with its
+// own frame synchronizer. Each segment is extended on both sides by
+// WLANCAPTURE_OVERLAP samples, more than the longest frame: a frame
+// starting within the segment is received in full, and the synchronizer
+// has settled by the time the segment starts. Frames are kept if they
+// start within WLANCAPTURE_DEDUP samples of the segment, so that a
+// frame near a boundary is found by at least one of its neighbours and
+// possibly both; frames are then delivered in order from the calling
+// thread, dropping any starting within WLANCAPTURE_DEDUP samples of the
+// frame before (distinct frames are further apart). With a front-end
+// (see wlancapture_set_config()), both distances are scaled to the
+// capture's sample rate.
+//
+// Frames detected but not decoded (SIGNAL field not valid) are tracked
+// as well, for the frame index (see wlancapture_set_index()); a frame
+// decoded in one segment takes precedence over a failed detection of
+// the same frame in its neighbour.
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "liquid-wlan.internal.h"
+
+// detected frame
+struct wlancapture_frame_s {
+    unsigned long int sample;           // sample index of frame start
+    struct wlan_rxvector_s rxvector;    // received vector
+    unsigned int offset;                // payload offset in segment
+    float rssi;                         // received signal strength [dB]
+    float cfo;                          // carrier offset [radians/sample]
+    int status;                         // e.g. LIQUID_WLAN_CAPTURE_FRAME_DECODED
+};
+
+// segment slot
+struct wlancapture_segment_s {
+    // frames found in segment
+    struct wlancapture_frame_s * frames;
+    unsigned int num_frames;
+    unsigned int frames_alloc;
+
+    // payloads of frames, concatenated
+    unsigned char * payload;
+    unsigned int payload_len;
+    unsigned int payload_alloc;
+
+    sem_t ready;                        // segment decoded
+};
+
+// worker thread
+struct wlancapture_worker_s {
+    pthread_t thread;                   // thread handle
+    wlanframesync fs;                   // frame synchronizer
+    struct wlancapture_decode_s * dec;  // parent decoding state
+
+    // segment being decoded
+    struct wlancapture_segment_s * segment;
+    unsigned long int lo;               // first frame start kept
+    unsigned long int hi;               // end of frame starts kept
+};
+
+// decoding state
+struct wlancapture_decode_s {
+    wlancapture capture;                // capture being decoded
+    unsigned long int segment_len;      // samples per segment
+    unsigned long int overlap;          // segment extension (capture samples)
+    unsigned long int dedup;            // duplicate distance (capture samples)
+    unsigned long int num_segments;     // number of segments
+    unsigned int num_slots;             // number of segments in flight
+    struct wlancapture_segment_s * slots;
+    unsigned long int claim;            // next segment to decode (workers, atomic)
+    sem_t slots_free;                   // number of free slots
+};
+
+// decode every frame in capture using worker threads, independent of
+// reading position; the callback is invoked from the calling thread in
+// order of frame start, returning the number of frames
+//  _q              :   capture file reader (20 MHz baseband)
+//  _num_threads    :   number of worker threads, _num_threads > 0
+//  _segment_len    :   samples per segment (0: default)
+//  _callback       :   user-defined callback function
+//  _userdata       :   user-defined data structure
+unsigned long int wlancapture_decode(wlancapture          _q,
+                                     unsigned int         _num_threads,
+                                     unsigned long int    _segment_len,
+                                     wlancapture_callback _callback,
+                                     void *               _userdata)
+{
+    // validate input
+    if (_num_threads == 0) {
+        fprintf(stderr,"error: wlancapture_decode(), number of threads must be greater than zero\n");
+        exit(1);
+    } else if (!wlancapture_is_decodable(_q)) {
+        fprintf(stderr,"error: wlancapture_decode(), sample rate %g is not 20 MS/s; set a front-end with wlancapture_set_config()\n",
+                wlancapture_get_sample_rate(_q));
+        exit(1);
+    }
+
+    struct wlancapture_decode_s dec;
+    dec.capture      = _q;
+    dec.segment_len  = _segment_len > 0 ? _segment_len : WLANCAPTURE_SEGMENT_LEN;
+    dec.num_segments = (wlancapture_get_num_samples(_q) + dec.segment_len - 1) / dec.segment_len;
+    dec.num_slots    = 2*_num_threads;
+    dec.claim        = 0;
+    sem_init(&dec.slots_free, 0, dec.num_slots);
+
+    unsigned int i;
+    dec.slots = (struct wlancapture_segment_s*) malloc(dec.num_slots*sizeof(struct wlancapture_segment_s));
+    for (i=0; i<dec.num_slots; i++) {
+        dec.slots[i].frames        = NULL;
+        dec.slots[i].frames_alloc  = 0;
+        dec.slots[i].payload       = NULL;
+        dec.slots[i].payload_alloc = 0;
+        sem_init(&dec.slots[i].ready, 0, 0);
+    }
+
+    // create frame synchronizers serially; transform planners are not
+    // necessarily thread-safe
+    struct wlancapture_worker_s workers[_num_threads];
+    for (i=0; i<_num_threads; i++) {
+        workers[i].fs  = wlancapture_create_framesync(_q, wlancapture_decode_callback, &workers[i]);
+        workers[i].dec = &dec;
+        wlanframesync_set_reject_callback(workers[i].fs, wlancapture_decode_reject);
+    }
+
+    // scale distances from 20 MHz baseband to capture samples
+    unsigned int P;
+    unsigned int Q;
+    wlanframesync_get_frontend(workers[0].fs, &P, &Q);
+    dec.overlap = ((unsigned long int)WLANCAPTURE_OVERLAP*Q + P - 1) / P;
+    dec.dedup   = ((unsigned long int)WLANCAPTURE_DEDUP*Q + P - 1) / P;
+    if (dec.segment_len < 4*dec.dedup) {
+        fprintf(stderr,"error: wlancapture_decode(), segment length must be at least %lu\n", 4*dec.dedup);
+        exit(1);
+    }
+
+    // create frame index, if requested
+    FILE * fid = wlancapture_get_index(_q) == NULL ? NULL :
+                 wlancapture_index_create(wlancapture_get_index(_q), wlancapture_get_num_samples(_q));
+
+    // start worker threads
+    for (i=0; i<_num_threads; i++) {
+        if (pthread_create(&workers[i].thread, NULL, wlancapture_decode_worker, &workers[i]) != 0) {
+            fprintf(stderr,"error: wlancapture_decode(), could not create thread\n");
+            exit(1);
+        }
+    }
+
+    // deliver frames segment by segment, dropping duplicates; each frame
+    // is held back until the next frame is known not to duplicate it,
+    // and its segment's slot is released one segment late so the held
+    // frame remains valid
+    unsigned long int n;
+    unsigned long int num_frames = 0;
+    struct wlancapture_frame_s * pending = NULL;    // frame held back
+    unsigned char * pending_payload = NULL;         // payload of held frame
+    unsigned long int pending_segment = 0;          // segment of held frame
+    for (n=0; n<dec.num_segments; n++) {
+        struct wlancapture_segment_s * segment = &dec.slots[n % dec.num_slots];
+        while (sem_wait(&segment->ready) != 0);
+
+        for (i=0; i<segment->num_frames; i++) {
+            struct wlancapture_frame_s * frame = &segment->frames[i];
+            if (pending != NULL && frame->sample < pending->sample + dec.dedup) {
+                // duplicate: keep decoded frame over failed detection
+                if (pending->status != LIQUID_WLAN_CAPTURE_FRAME_DECODED &&
+                    frame->status   == LIQUID_WLAN_CAPTURE_FRAME_DECODED)
+                {
+                    pending         = frame;
+                    pending_payload = &segment->payload[frame->offset];
+                    pending_segment = n;
+                }
+                continue;
+            }
+            if (pending != NULL)
+                num_frames += wlancapture_decode_deliver(pending, pending_payload, fid, _callback, _userdata);
+            pending         = frame;
+            pending_payload = &segment->payload[frame->offset];
+            pending_segment = n;
+        }
+
+        // frame held from an earlier segment can no longer be duplicated
+        if (pending != NULL && pending_segment < n) {
+            num_frames += wlancapture_decode_deliver(pending, pending_payload, fid, _callback, _userdata);
+            pending = NULL;
+        }
+
+        // release previous slot
+        if (n > 0)
+            sem_post(&dec.slots_free);
+    }
+    if (pending != NULL)
+        num_frames += wlancapture_decode_deliver(pending, pending_payload, fid, _callback, _userdata);
+    if (dec.num_segments > 0)
+        sem_post(&dec.slots_free);
+    if (fid != NULL)
+        fclose(fid);
+
+    // join worker threads, destroying frame synchronizers serially
+    for (i=0; i<_num_threads; i++)
+        pthread_join(workers[i].thread, NULL);
+    for (i=0; i<_num_threads; i++)
+        wlanframesync_destroy(workers[i].fs);
+
+    // free slots
+    for (i=0; i<dec.num_slots; i++) {
+        free(dec.slots[i].frames);
+        free(dec.slots[i].payload);
+        sem_destroy(&dec.slots[i].ready);
+    }
+    free(dec.slots);
+    sem_destroy(&dec.slots_free);
+
+    return num_frames;
+}
+
+//
+// internal methods
+//
+
+// worker thread: claim segments in order and decode them
+void * wlancapture_decode_worker(void * _arg)
+{
+    struct wlancapture_worker_s * w = (struct wlancapture_worker_s*) _arg;
+    struct wlancapture_decode_s * dec = w->dec;
+    unsigned long int num_samples = wlancapture_get_num_samples(dec->capture);
+
+    while (1) {
+        // wait for free slot, then claim segment; slots are released in
+        // order, so the claimed segment's slot is always free
+        while (sem_wait(&dec->slots_free) != 0);
+        unsigned long int n = __atomic_fetch_add(&dec->claim, 1, __ATOMIC_ACQ_REL);
+        if (n >= dec->num_segments) {
+            sem_post(&dec->slots_free);
+            break;
+        }
+        w->segment = &dec->slots[n % dec->num_slots];
+        w->segment->num_frames  = 0;
+        w->segment->payload_len = 0;
+
+        // frames kept, and samples decoded
+        unsigned long int start = n*dec->segment_len;
+        unsigned long int end   = start + dec->segment_len < num_samples ? start + dec->segment_len : num_samples;
+        w->lo = start > dec->dedup ? start - dec->dedup : 0;
+        w->hi = end + dec->dedup;
+        start = start > dec->overlap ? start - dec->overlap : 0;
+        end   = end + dec->overlap < num_samples ? end + dec->overlap : num_samples;
+
+        // decode segment, counting samples from start of capture
+        wlanframesync_reset(w->fs);
+        wlanframesync_set_sample_index(w->fs, start);
+        wlancapture_execute_range(dec->capture, w->fs, start, end);
+
+        // release segment to calling thread
+        sem_post(&w->segment->ready);
+    }
+
+    return NULL;
+}
+
+// deliver frame to callback (if decoded) and index, returning 1 if
+// the frame was decoded
+int wlancapture_decode_deliver(struct wlancapture_frame_s * _frame,
+                               unsigned char *              _payload,
+                               FILE *                       _fid,
+                               wlancapture_callback         _callback,
+                               void *                       _userdata)
+{
+    if (_fid != NULL) {
+        struct wlancapture_index_entry_s entry;
+        memset(&entry, 0x00, sizeof(entry));
+        entry.sample = _frame->sample;
+        entry.rssi   = _frame->rssi;
+        entry.cfo    = _frame->cfo;
+        entry.length = _frame->rxvector.LENGTH;
+        entry.rate   = _frame->rxvector.DATARATE;
+        entry.status = _frame->status;
+        if (fwrite(&entry, sizeof(entry), 1, _fid) != 1) {
+            fprintf(stderr,"error: wlancapture_decode(), could not write frame index\n");
+            exit(1);
+        }
+    }
+
+    if (_frame->status != LIQUID_WLAN_CAPTURE_FRAME_DECODED)
+        return 0;
+    if (_callback != NULL)
+        _callback(_frame->sample, _payload, _frame->rxvector, _userdata);
+    return 1;
+}
+
+// frame synchronizer callback: keep frames starting within segment
+int wlancapture_decode_callback(unsigned char *        _payload,
+                                struct wlan_rxvector_s _rxvector,
+                                void *                 _userdata)
+{
+    wlancapture_decode_keep((struct wlancapture_worker_s*) _userdata, _payload, _rxvector,
+                            LIQUID_WLAN_CAPTURE_FRAME_DECODED);
+    return 0;
+}
+
+// frame synchronizer notification of frame not decoded: keep failed
+// detection if it starts within segment
+void wlancapture_decode_reject(void * _userdata)
+{
+    struct wlan_rxvector_s rxvector;
+    memset(&rxvector, 0x00, sizeof(rxvector));
+    wlancapture_decode_keep((struct wlancapture_worker_s*) _userdata, NULL, rxvector,
+                            LIQUID_WLAN_CAPTURE_FRAME_REJECTED);
+}
+
+// keep frame in worker's segment if it starts within segment
+//  _w          :   worker object
+//  _payload    :   received payload (NULL if not decoded)
+//  _rxvector   :   received vector
+//  _status     :   frame status, e.g. LIQUID_WLAN_CAPTURE_FRAME_DECODED
+void wlancapture_decode_keep(struct wlancapture_worker_s * _w,
+                             unsigned char *               _payload,
+                             struct wlan_rxvector_s        _rxvector,
+                             int                           _status)
+{
+    struct wlancapture_segment_s * segment = _w->segment;
+    unsigned long int sample = wlanframesync_get_frame_start_input(_w->fs);
+    if (sample < _w->lo || sample >= _w->hi)
+        return;
+
+    // re-allocate arrays as needed
+    if (segment->num_frames == segment->frames_alloc) {
+        segment->frames_alloc = segment->frames_alloc ? 2*segment->frames_alloc : 16;
+        segment->frames = (struct wlancapture_frame_s*) realloc(segment->frames, segment->frames_alloc*sizeof(struct wlancapture_frame_s));
+    }
+    if (segment->payload_len + _rxvector.LENGTH > segment->payload_alloc) {
+        segment->payload_alloc = 2*(segment->payload_len + _rxvector.LENGTH);
+        segment->payload = (unsigned char*) realloc(segment->payload, segment->payload_alloc*sizeof(unsigned char));
+    }
+
+    // store frame
+    struct wlancapture_frame_s * frame = &segment->frames[segment->num_frames++];
+    frame->sample   = sample;
+    frame->rxvector = _rxvector;
+    frame->offset   = segment->payload_len;
+    frame->rssi     = wlanframesync_get_rssi(_w->fs);
+    frame->cfo      = wlanframesync_get_cfo(_w->fs);
+    frame->status   = _status;
+    if (_payload != NULL)
+        memmove(&segment->payload[segment->payload_len], _payload, _rxvector.LENGTH*sizeof(unsigned char));
+    segment->payload_len += _rxvector.LENGTH;
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlancapture_index.c
+//
+// Persistent frame index: wlancapture_decode() records where each frame
+// was detected, with its signal strength, carrier offset, length, rate
+// and whether its SIGNAL field was valid. A later pass, possibly with a
+// different synchronizer configuration (see wlancapture_set_config()),
+// re-decodes the frames listed in the index by synchronizing only a
+// window around each one, starting WLANCAPTURE_DEDUP samples ahead of
+// the frame so the short training sequence is seen in full. The window
+// ends one symbol past the frame for frames decoded before, and spans
+// the longest possible frame (WLANCAPTURE_OVERLAP) for frames whose
+// SIGNAL field was not valid; it is prefetched from the file as a whole
+// and cut short once the frame has been decoded or rejected again.
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "liquid-wlan.internal.h"
+
+// number of samples synchronized at a time while re-decoding a frame
+#define WLANCAPTURE_INDEX_BLOCK_LEN (4096)
+
+// index re-decoding
+struct wlancapture_index_s {
+    wlanframesync fs;                   // frame synchronizer
+    unsigned long int sample;           // indexed frame start
+    unsigned long int dedup;            // frame start tolerance (capture samples)
+    int found;                          // frame delivered?
+    int done;                           // frame delivered or rejected?
+    wlancapture_callback callback;      // user-defined callback function
+    void * userdata;                    // user-defined data structure
+};
+
+// re-decode frames listed in an index written by wlancapture_decode(),
+// returning the number of frames
+//  _q          :   capture file reader
+//  _filename   :   index file name
+//  _callback   :   user-defined callback function
+//  _userdata   :   user-defined data structure
+unsigned long int wlancapture_decode_index(wlancapture          _q,
+                                           const char *         _filename,
+                                           wlancapture_callback _callback,
+                                           void *               _userdata)
+{
+    // validate input
+    if (!wlancapture_is_decodable(_q)) {
+        fprintf(stderr,"error: wlancapture_decode_index(), sample rate %g is not 20 MS/s; set a front-end with wlancapture_set_config()\n",
+                wlancapture_get_sample_rate(_q));
+        exit(1);
+    }
+
+    FILE * fid = fopen(_filename, "rb");
+    if (fid == NULL) {
+        fprintf(stderr,"error: wlancapture_decode_index(), could not open '%s' for reading\n", _filename);
+        exit(1);
+    }
+
+    // validate header
+    struct wlancapture_index_header_s header;
+    if (fread(&header, sizeof(header), 1, fid) != 1 || memcmp(header.magic, "LWIX", 4) != 0) {
+        fprintf(stderr,"error: wlancapture_decode_index(), '%s' is not a frame index\n", _filename);
+        exit(1);
+    } else if (header.version != WLANCAPTURE_INDEX_VERSION) {
+        fprintf(stderr,"error: wlancapture_decode_index(), unsupported index version %u\n", header.version);
+        exit(1);
+    } else if (header.num_samples != wlancapture_get_num_samples(_q)) {
+        fprintf(stderr,"error: wlancapture_decode_index(), index does not match capture\n");
+        exit(1);
+    }
+
+    struct wlancapture_index_s idx;
+    idx.fs       = wlancapture_create_framesync(_q, wlancapture_index_callback, &idx);
+    idx.callback = _callback;
+    idx.userdata = _userdata;
+    wlanframesync_set_reject_callback(idx.fs, wlancapture_index_reject);
+
+    // scale distances from 20 MHz baseband to capture samples
+    unsigned int P;
+    unsigned int Q;
+    wlanframesync_get_frontend(idx.fs, &P, &Q);
+    idx.dedup = ((unsigned long int)WLANCAPTURE_DEDUP*Q + P - 1) / P;
+
+    unsigned long int num_samples = wlancapture_get_num_samples(_q);
+    unsigned long int num_frames  = 0;
+    struct wlancapture_index_entry_s entry;
+    while (fread(&entry, sizeof(entry), 1, fid) == 1) {
+        int decoded = entry.status == LIQUID_WLAN_CAPTURE_FRAME_DECODED;
+        if ((decoded && (entry.rate > 7 || entry.length == 0 || entry.length > 4095)) ||
+            entry.sample >= num_samples)
+        {
+            fprintf(stderr,"error: wlancapture_decode_index(), invalid index entry\n");
+            exit(1);
+        }
+
+        // window: preamble and SIGNAL (400 samples), data symbols, and
+        // one symbol to spare; longest frame if length is not known
+        unsigned long int len = WLANCAPTURE_OVERLAP;
+        if (decoded) {
+            unsigned int ndbps = wlanframe_ratetab[entry.rate].ndbps;
+            unsigned int nsym  = (16 + 8*entry.length + 6 + ndbps - 1) / ndbps;
+            len = 400 + 80*(nsym + 1);
+        }
+        len = (len*Q + P - 1) / P + idx.dedup;
+        unsigned long int start = entry.sample > idx.dedup ? entry.sample - idx.dedup : 0;
+        unsigned long int end   = entry.sample + len < num_samples ? entry.sample + len : num_samples;
+
+        // prefetch window once, then synchronize it in short pieces
+        // until frame is decoded or rejected
+        idx.sample = entry.sample;
+        idx.found  = 0;
+        idx.done   = 0;
+        wlanframesync_reset(idx.fs);
+        wlanframesync_set_sample_index(idx.fs, start);
+        wlancapture_prefetch(_q, start, end);
+        while (start < end && !idx.done) {
+            unsigned long int n = end - start < WLANCAPTURE_INDEX_BLOCK_LEN ? end - start : WLANCAPTURE_INDEX_BLOCK_LEN;
+            wlancapture_execute_block(_q, idx.fs, wlancapture_get_samples(_q, start), (unsigned int)n);
+            start += n;
+        }
+        num_frames += idx.found;
+    }
+
+    wlanframesync_destroy(idx.fs);
+    fclose(fid);
+    return num_frames;
+}
+
+//
+// internal methods
+//
+
+// create frame index file and write its header
+//  _filename       :   index file name
+//  _num_samples    :   number of samples in capture
+FILE * wlancapture_index_create(const char *      _filename,
+                                unsigned long int _num_samples)
+{
+    FILE * fid = fopen(_filename, "wb");
+    if (fid == NULL) {
+        fprintf(stderr,"error: wlancapture_index_create(), could not open '%s' for writing\n", _filename);
+        exit(1);
+    }
+
+    struct wlancapture_index_header_s header;
+    memset(&header, 0x00, sizeof(header));
+    memmove(header.magic, "LWIX", 4);
+    header.version     = WLANCAPTURE_INDEX_VERSION;
+    header.num_samples = _num_samples;
+    if (fwrite(&header, sizeof(header), 1, fid) != 1) {
+        fprintf(stderr,"error: wlancapture_index_create(), could not write '%s'\n", _filename);
+        exit(1);
+    }
+    return fid;
+}
+
+// is most recent frame the indexed one (starting within its tolerance)?
+int wlancapture_index_match(struct wlancapture_index_s * _idx)
+{
+    unsigned long int sample = wlanframesync_get_frame_start_input(_idx->fs);
+    return sample + _idx->dedup > _idx->sample && sample < _idx->sample + _idx->dedup;
+}
+
+// frame synchronizer callback: forward frame starting at indexed
+// position
+int wlancapture_index_callback(unsigned char *        _payload,
+                               struct wlan_rxvector_s _rxvector,
+                               void *                 _userdata)
+{
+    struct wlancapture_index_s * idx = (struct wlancapture_index_s*) _userdata;
+    if (idx->done || !wlancapture_index_match(idx))
+        return 0;
+
+    // report indexed position so passes agree
+    idx->found = 1;
+    idx->done  = 1;
+    if (idx->callback != NULL)
+        idx->callback(idx->sample, _payload, _rxvector, idx->userdata);
+    return 0;
+}
+
+// frame synchronizer notification of frame not decoded: stop if it is
+// the indexed frame
+void wlancapture_index_reject(void * _userdata)
+{
+    struct wlancapture_index_s * idx = (struct wlancapture_index_s*) _userdata;
+    if (wlancapture_index_match(idx))
+        idx->done = 1;
+}
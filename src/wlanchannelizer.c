@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanchannelizer.c
+//
+// Polyphase analysis filterbank: splits a wideband stream sampled at
+// M x 20 MHz into M critically-sampled 20 MHz channel streams. Channel
+// k is the input mixed down by k/M cycles/sample, low-pass filtered and
+// decimated by M:
+//
+//   y_k(n) = sum_i h(i) x(nM-i) exp(j 2 pi k i/M)
+//          = sum_p exp(j 2 pi k p/M) sum_l h(lM+p) x((n-l)M-p)
+//
+// so each of the M polyphase branches filters every M-th input sample
+// and a single M-point inverse transform forms all channels at once.
+// The cost per input sample is one tap per branch plus the transform,
+// independent of how many channels are decoded.
+//
+// The prototype cuts off at 10 MHz; an 802.11a channel occupies less
+// than 8.3 MHz, so the aliasing of the critically-sampled transition
+// band falls outside the occupied subcarriers.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "liquid-wlan.internal.h"
+
+// number of input samples converted at a time for integer input
+#define WLANCHANNELIZER_CONVERT_LEN     (1024)
+
+struct wlanchannelizer_s {
+    unsigned int M;             // number of channels
+    unsigned int m;             // filter semi-length (output samples)
+    unsigned int L;             // number of taps per polyphase branch
+    int offset;                 // channel centers offset by half a channel?
+
+    // polyphase filter bank, time-reversed with duplicated taps (see
+    // wlan_dotprod_crcf)
+    float * h;                  // [size: M x 2L]
+
+    // branch buffers: L-1 samples of history, then one sample for each
+    // new output, the last of which may be partially received
+    float complex * buffer;     // [size: M x stride]
+    unsigned int stride;        // branch buffer length, L + num_alloc
+    unsigned int num_alloc;     // maximum number of outputs per call
+    unsigned int c;             // input samples received for next output
+
+    // half-channel offset: exp(-j pi t/M)
+    float complex * mix;        // [size: 2M x 1]
+    unsigned int t;             // input time modulo 2M
+
+    // transform
+    FFT_PLAN ifft;              // inverse transform object
+    float complex * V;          // branch outputs
+    float complex * Y;          // channel outputs
+
+    // output streams, each [size: num_alloc x 1]
+    float complex * out;        // [size: M x num_alloc]
+
+    // consumers
+    wlanframesync * fs;         // synchronizer for each channel (or NULL)
+    wlanrx rx;                  // multi-channel receiver (or NULL)
+};
+
+// create channelizer
+//  _M      :   number of channels, _M > 0
+//  _m      :   filter semi-length (output samples), _m > 0
+//  _offset :   channel centers offset by half a channel?
+wlanchannelizer wlanchannelizer_create(unsigned int _M,
+                                       unsigned int _m,
+                                       int          _offset)
+{
+    // validate input
+    if (_M == 0) {
+        fprintf(stderr,"error: wlanchannelizer_create(), number of channels must be greater than zero\n");
+        exit(1);
+    } else if (_m == 0) {
+        fprintf(stderr,"error: wlanchannelizer_create(), filter semi-length must be greater than zero\n");
+        exit(1);
+    }
+
+    wlanchannelizer q = (wlanchannelizer) malloc(sizeof(struct wlanchannelizer_s));
+    q->M      = _M;
+    q->m      = _m;
+    q->L      = 2*q->m;
+    q->offset = _offset ? 1 : 0;
+
+    // design prototype: windowed sinc with cut-off at the output
+    // Nyquist rate, Kaiser window (beta = 7), unity gain at DC
+    float fc = 0.5f / (float)q->M;
+    float beta = 7.0f;
+    unsigned int h_len = q->M * q->L;
+    float h[h_len];
+    unsigned int i;
+    for (i=0; i<h_len; i++) {
+        float t = (float)i - (float)(q->m*q->M);
+        float r = t / (float)(q->m*q->M);
+        float w = fabsf(r) < 1.0f ? wlan_resamp_besseli0(beta*sqrtf(1.0f - r*r)) / wlan_resamp_besseli0(beta) : 0.0f;
+        float s = t == 0.0f ? 1.0f : sinf(2.0f*M_PI*fc*t) / (2.0f*M_PI*fc*t);
+        h[i] = 2.0f * fc * s * w;
+    }
+
+    // split into polyphase branches, time-reversing each so that the
+    // filter runs forward over the branch buffer
+    //   v_p(n) = sum_l h[p + l*M] x_p(n - l),  x_p(n) = x(nM - p)
+    q->h = (float*) malloc(q->M*2*q->L*sizeof(float));
+    unsigned int p, l;
+    for (p=0; p<q->M; p++) {
+        for (l=0; l<q->L; l++) {
+            float v = h[p + l*q->M];
+            q->h[p*2*q->L + 2*(q->L-l-1) + 0] = v;
+            q->h[p*2*q->L + 2*(q->L-l-1) + 1] = v;
+        }
+    }
+
+    // half-channel offset phasors
+    q->mix = (float complex*) malloc(2*q->M*sizeof(float complex));
+    for (i=0; i<2*q->M; i++)
+        q->mix[i] = cexpf(-_Complex_I*M_PI*(float)i/(float)q->M);
+
+    // create transform object
+    q->V = (float complex*) malloc(q->M*sizeof(float complex));
+    q->Y = (float complex*) malloc(q->M*sizeof(float complex));
+    q->ifft = FFT_CREATE_PLAN(q->M, q->V, q->Y, FFT_DIR_BACKWARD, FFT_METHOD);
+
+    // buffers are grown as needed
+    q->num_alloc = 0;
+    q->stride    = q->L;
+    q->buffer    = (float complex*) malloc(q->M*q->stride*sizeof(float complex));
+    q->out       = NULL;
+
+    // no consumers
+    q->fs = (wlanframesync*) malloc(q->M*sizeof(wlanframesync));
+    for (i=0; i<q->M; i++)
+        q->fs[i] = NULL;
+    q->rx = NULL;
+
+    // reset object
+    wlanchannelizer_reset(q);
+
+    return q;
+}
+
+// destroy channelizer (bound synchronizers are not destroyed)
+void wlanchannelizer_destroy(wlanchannelizer _q)
+{
+    free(_q->h);
+    free(_q->mix);
+    free(_q->V);
+    free(_q->Y);
+    FFT_DESTROY_PLAN(_q->ifft);
+    free(_q->buffer);
+    free(_q->out);
+    free(_q->fs);
+    free(_q);
+}
+
+// print channelizer object internals
+void wlanchannelizer_print(wlanchannelizer _q)
+{
+    printf("wlanchannelizer:\n");
+    printf("    channels    :   %u (input %u MHz)\n", _q->M, 20*_q->M);
+    printf("    filter      :   %u taps (%u per branch)\n", _q->M*_q->L, _q->L);
+    unsigned int k;
+    for (k=0; k<_q->M; k++) {
+        // channel center relative to the capture center, in MHz
+        float fk = (float)(2*k + _q->offset) * 10.0f;
+        if (2*k + _q->offset > _q->M)
+            fk -= 20.0f*(float)_q->M;
+        printf("    channel %-3u :   %+6.1f MHz%s\n", k, fk,
+                _q->fs[k] != NULL ? " (synchronizer)" : "");
+    }
+}
+
+// reset channelizer object internal state
+void wlanchannelizer_reset(wlanchannelizer _q)
+{
+    unsigned int p;
+    for (p=0; p<_q->M; p++)
+        memset(&_q->buffer[p*_q->stride], 0x00, _q->L*sizeof(float complex));
+    _q->c = 0;
+    _q->t = 0;
+}
+
+// bind frame synchronizer to channel
+//  _q          :   channelizer object
+//  _channel    :   channel index
+//  _fs         :   frame synchronizer (NULL to unbind)
+void wlanchannelizer_set_sync(wlanchannelizer _q,
+                              unsigned int    _channel,
+                              wlanframesync   _fs)
+{
+    if (_channel >= _q->M) {
+        fprintf(stderr,"error: wlanchannelizer_set_sync(), channel index (%u) out of range\n", _channel);
+        exit(1);
+    }
+    _q->fs[_channel] = _fs;
+}
+
+// feed every channel into the same channel of a multi-channel receiver
+//  _q          :   channelizer object
+//  _rx         :   multi-channel receiver with at least M channels (NULL to unbind)
+void wlanchannelizer_set_rx(wlanchannelizer _q,
+                            wlanrx          _rx)
+{
+    _q->rx = _rx;
+}
+
+// get number of output samples per channel produced by next _n input
+// samples
+unsigned int wlanchannelizer_get_num_output(wlanchannelizer _q,
+                                            unsigned int    _n)
+{
+    return (_q->c + _n) / _q->M;
+}
+
+// execute channelizer on input block
+//  _q          :   channelizer object
+//  _x          :   input samples [size: _n x 1]
+//  _n          :   number of input samples
+//  _y          :   output for each channel, or NULL to only feed bound
+//                  consumers [size: M x wlanchannelizer_get_num_output(_q,_n)]
+void wlanchannelizer_execute(wlanchannelizer         _q,
+                             liquid_float_complex *  _x,
+                             unsigned int            _n,
+                             liquid_float_complex ** _y)
+{
+    unsigned int M = _q->M;
+    unsigned int L = _q->L;
+    unsigned int num_output = wlanchannelizer_get_num_output(_q, _n);
+
+    // grow buffers as necessary, retaining history and partial output
+    if (num_output > _q->num_alloc) {
+        unsigned int stride = L + num_output;
+        float complex * buffer = (float complex*) malloc(M*stride*sizeof(float complex));
+        unsigned int p;
+        for (p=0; p<M; p++)
+            memmove(&buffer[p*stride], &_q->buffer[p*_q->stride], L*sizeof(float complex));
+        free(_q->buffer);
+        _q->buffer    = buffer;
+        _q->stride    = stride;
+        _q->num_alloc = num_output;
+        _q->out = (float complex*) realloc(_q->out, M*_q->num_alloc*sizeof(float complex));
+    }
+
+    // commutate input into branches: the M samples of output n are
+    // x(nM-M+1) ... x(nM), received by branches M-1 ... 0
+    unsigned int i;
+    unsigned int n = 0;
+    float complex * b = &_q->buffer[L-1];
+    for (i=0; i<_n; i++) {
+        float complex v = _x[i];
+        if (_q->offset) {
+            v *= _q->mix[_q->t];
+            _q->t = (_q->t + 1) % (2*M);
+        }
+        b[(M-1-_q->c)*_q->stride + n] = v;
+        if (++_q->c == M) {
+            _q->c = 0;
+            n++;
+        }
+    }
+
+    // filter branches and transform to form each output
+    unsigned int p, k;
+    for (n=0; n<num_output; n++) {
+        for (p=0; p<M; p++)
+            _q->V[p] = wlan_dotprod_crcf(&_q->h[p*2*L], &_q->buffer[p*_q->stride + n], L);
+        FFT_EXECUTE(_q->ifft);
+        for (k=0; k<M; k++)
+            _q->out[k*_q->num_alloc + n] = _q->Y[k];
+    }
+
+    // retain history and partial output
+    for (p=0; p<M; p++)
+        memmove(&_q->buffer[p*_q->stride], &_q->buffer[p*_q->stride + num_output], L*sizeof(float complex));
+
+    if (num_output == 0)
+        return;
+
+    // deliver channel streams
+    for (k=0; k<M; k++) {
+        float complex * y = &_q->out[k*_q->num_alloc];
+        if (_y != NULL)
+            memmove(_y[k], y, num_output*sizeof(float complex));
+        if (_q->fs[k] != NULL)
+            wlanframesync_execute(_q->fs[k], y, num_output);
+        if (_q->rx != NULL)
+            wlanrx_execute(_q->rx, k, y, num_output);
+    }
+}
+
+// execute channelizer on interleaved int16 I/Q input, scaled by 1/32768
+//  _q          :   channelizer object
+//  _x          :   input I/Q buffer [size: 2*_n x 1]
+//  _n          :   number of input samples
+//  _y          :   output for each channel, or NULL to only feed bound
+//                  consumers [size: M x wlanchannelizer_get_num_output(_q,_n)]
+void wlanchannelizer_execute_sc16(wlanchannelizer         _q,
+                                  int16_t *               _x,
+                                  unsigned int            _n,
+                                  liquid_float_complex ** _y)
+{
+    // convert in blocks small enough to remain in cache, advancing the
+    // output pointers after each block
+    float complex buffer[WLANCHANNELIZER_CONVERT_LEN];
+    float complex * y[_q->M];
+    unsigned int k;
+    if (_y != NULL) {
+        for (k=0; k<_q->M; k++)
+            y[k] = _y[k];
+    }
+    unsigned int n = 0;
+    while (n < _n) {
+        unsigned int b = _n - n < WLANCHANNELIZER_CONVERT_LEN ? _n - n : WLANCHANNELIZER_CONVERT_LEN;
+        unsigned int num_output = wlanchannelizer_get_num_output(_q, b);
+        liquid_wlan_sc16_to_cf(&_x[2*n], b, 1.0f/32768.0f, buffer);
+        wlanchannelizer_execute(_q, buffer, b, _y != NULL ? y : NULL);
+        if (_y != NULL) {
+            for (k=0; k<_q->M; k++)
+                y[k] += num_output;
+        }
+        n += b;
+    }
+}
@@ -45,6 +45,26 @@ int wlanframe_getsctype(unsigned int _id)
         return WLANFRAME_SCTYPE_DATA;
 }
 
+// DATA subcarrier indices in order of transmission
+const unsigned char wlanframe_data_subcarriers[48] = {
+    38, 39, 40, 41, 42, 44, 45, 46, 47, 48, 49, 50,
+    51, 52, 53, 54, 55, 56, 58, 59, 60, 61, 62, 63,
+     1,  2,  3,  4,  5,  6,  8,  9, 10, 11, 12, 13,
+    14, 15, 16, 17, 18, 19, 20, 22, 23, 24, 25, 26};
+
+// pilot polarity sequence (1 denotes inverted pilots), indexed by OFDM
+// symbol number starting with SIGNAL; output of the pilot scrambler
+// g = x^7 + x^4 + 1 with all ones initial state
+const unsigned char wlanframe_pilot_polarity[WLANFRAME_PILOT_PERIOD] = {
+    0, 0, 0, 0, 1, 1, 1, 0, 1, 1, 1, 1, 0, 0, 1, 0,
+    1, 1, 0, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0,
+    0, 0, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0, 1, 1, 1, 0,
+    1, 0, 1, 1, 0, 1, 1, 0, 0, 0, 0, 0, 1, 1, 0, 0,
+    1, 1, 0, 1, 0, 1, 0, 0, 1, 1, 1, 0, 0, 1, 1, 1,
+    1, 0, 1, 1, 0, 1, 0, 0, 0, 0, 1, 0, 1, 0, 1, 0,
+    1, 1, 1, 1, 1, 0, 1, 0, 0, 1, 0, 1, 0, 0, 0, 1,
+    1, 0, 1, 1, 1, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1};
+
 // PLCP short sequence (frequency domain)
 const float complex wlanframe_S0[64] = {
       0.000000+  0.000000*_Complex_I,   0.0f, 0.0f, 0.0f,
@@ -32,6 +32,24 @@
 
 #define DEBUG_WLANFRAMEGEN            0
 
+// number of DATA symbols computed with each batched transform
+#define WLANFRAMEGEN_BATCH_LEN        (16)
+
+// output interpolation filter semi-length (input samples)
+#define WLANFRAMEGEN_INTERP_M         (8)
+
+// number of SIGNAL symbol waveforms retained in cache
+#define WLANFRAMEGEN_SIGNAL_CACHE_LEN (8)
+
+// cached SIGNAL symbol waveform
+struct wlanframegen_signal_s {
+    int valid;                      // entry holds a valid waveform
+    unsigned int rate;              // primitive data rate (key)
+    unsigned int length;            // original data length (key)
+    unsigned long int timestamp;    // time of last use
+    float complex symbol[80];       // SIGNAL symbol waveform
+};
+
 struct wlanframegen_s {
     // options
     unsigned int rate;      // primitive data rate
@@ -39,15 +57,28 @@ struct wlanframegen_s {
     unsigned int seed;      // data scrambler seed
 
     float g;                // scaling factor (gain)
+    float sc16_scale;       // sc16 output scaling, including TXPWR_LEVEL gain
+
+    // output interpolation
+    unsigned int P;                 // interpolation factor
+    unsigned int Q;                 // decimation factor
+    unsigned int symbol_len;        // output samples per symbol, 80*P/Q
+    wlan_resamp resamp;             // resampler (NULL if P == Q)
+    float complex buffer_base[80];  // symbol before interpolation
 
     // transform object
     FFT_PLAN ifft;          // ifft object
     float complex * X;      // frequency-domain buffer
     float complex * x;      // time-domain buffer
 
-    // pilot sequence generator
-    wlan_lfsr ms_pilot;     // g = x^7 + x^4 + 1 = 1001 0001(bin) = 0x91(hex)
-    
+    // batched transform object (DATA symbols)
+#if HAVE_FFTW3_H
+    FFT_PLAN ifft_batch;    // batched ifft object
+    float complex * Xb;     // frequency-domain batch buffer [size: 64 x WLANFRAMEGEN_BATCH_LEN]
+    float complex * xb;     // time-domain batch buffer [size: 64 x WLANFRAMEGEN_BATCH_LEN]
+#endif
+    float complex * buffer_data;    // DATA symbol output buffer [size: 80 x WLANFRAMEGEN_BATCH_LEN]
+
     // DATA field modulation scheme
     unsigned int mod_scheme;
 
@@ -56,6 +87,19 @@ struct wlanframegen_s {
     float * rampup;                 // ramp up window (ramp down is time-reversed)
     float complex * postfix;        // overlapping symbol buffer
 
+    // waveform caches
+    float complex preamble[320];    // S0a, S0b, S1a, S1b symbols
+    struct wlanframegen_signal_s signal_cache[WLANFRAMEGEN_SIGNAL_CACHE_LEN];
+    unsigned long int signal_cache_timer;   // SIGNAL cache access counter
+    int payload_cache_enabled;      // DATA field waveform cache enabled?
+    int payload_cache_active;       // DATA field of current frame is cached?
+    int payload_cache_valid;        // DATA field waveform cache holds current frame?
+    unsigned int payload_cache_rate;        // cached primitive data rate
+    unsigned int payload_cache_seed;        // cached data scrambler seed
+    unsigned int payload_cache_length;      // cached data length (bytes)
+    unsigned char * payload_cache_msg;      // cached payload [size: payload_cache_length x 1]
+    float complex * payload_cache;  // cached DATA field [size: 80 x nsym]
+
     // lengths
     unsigned int ndbps;             // number of data bits per OFDM symbol
     unsigned int ncbps;             // number of coded bits per OFDM symbol
@@ -85,21 +129,73 @@ struct wlanframegen_s {
         WLANFRAMEGEN_STATE_NULL,    // write null (effectively ramp-down) symbol
     } state;
     int frame_assembled;            // frame assembled flag
+    int frame_complete;             // frame complete flag (sample writer)
     unsigned int data_symbol_counter;
+
+    // sample writer
+    float complex * buffer_symbol;  // partially-written symbol buffer [size: symbol_len x 1]
+    unsigned int buffer_index;      // read index into symbol buffer
 };
 
 // create WLAN framing generator object
 wlanframegen wlanframegen_create()
 {
+    return wlanframegen_create_interp(1, 1);
+}
+
+// create WLAN framing generator object with output interpolation,
+// resampling the 20 MHz baseband signal by _P/_Q
+//  _P          :   interpolation factor, _P > 0
+//  _Q          :   decimation factor, _Q > 0, 80*_P/_Q must be an integer
+wlanframegen wlanframegen_create_interp(unsigned int _P,
+                                       unsigned int _Q)
+{
+    // validate input
+    if (_P == 0 || _Q == 0) {
+        fprintf(stderr,"error: wlanframegen_create_interp(), resampling factors must be greater than zero\n");
+        exit(1);
+    } else if ((80*_P) % _Q) {
+        fprintf(stderr,"error: wlanframegen_create_interp(), symbol length 80*P/Q must be an integer\n");
+        exit(1);
+    }
+
     wlanframegen q = (wlanframegen) malloc(sizeof(struct wlanframegen_s));
 
+    // reduce resampling factors
+    unsigned int a = _P;
+    unsigned int b = _Q;
+    while (b) {
+        unsigned int t = a % b;
+        a = b;
+        b = t;
+    }
+    q->P = _P / a;
+    q->Q = _Q / a;
+
+    // create output interpolator
+    q->symbol_len = (80*q->P) / q->Q;
+    q->resamp = q->P == q->Q ? NULL : wlan_resamp_create(q->P, q->Q, WLANFRAMEGEN_INTERP_M);
+    q->buffer_symbol = (float complex*) malloc(q->symbol_len*sizeof(float complex));
+
     // allocate memory for transform objects
     q->X = (float complex*) malloc(64*sizeof(float complex));
     q->x = (float complex*) malloc(64*sizeof(float complex));
     q->ifft = FFT_CREATE_PLAN(64, q->X, q->x, FFT_DIR_BACKWARD, FFT_METHOD);
 
-    // create pilot sequence generator
-    q->ms_pilot = wlan_lfsr_create(7, 0x91, 0x7f);
+    // allocate memory for batched transform objects
+#if HAVE_FFTW3_H
+    int n = 64;
+    q->Xb = (float complex*) malloc(64*WLANFRAMEGEN_BATCH_LEN*sizeof(float complex));
+    q->xb = (float complex*) malloc(64*WLANFRAMEGEN_BATCH_LEN*sizeof(float complex));
+    q->ifft_batch = fftwf_plan_many_dft(1, &n, WLANFRAMEGEN_BATCH_LEN,
+                                        q->Xb, NULL, 1, 64,
+                                        q->xb, NULL, 1, 64,
+                                        FFT_DIR_BACKWARD, FFT_METHOD);
+
+    // NULL subcarriers are never written and remain zero
+    memset(q->Xb, 0x00, 64*WLANFRAMEGEN_BATCH_LEN*sizeof(float complex));
+#endif
+    q->buffer_data = (float complex*) malloc(80*WLANFRAMEGEN_BATCH_LEN*sizeof(float complex));
 
     // DATA field (payload) modulator
     q->mod_scheme = WLAN_MODEM_BPSK;
@@ -137,11 +233,30 @@ wlanframegen wlanframegen_create()
     q->msg_enc = (unsigned char*) malloc(q->enc_msg_len*sizeof(unsigned char));
 
     // compute scaling factor
-    q->g = 1.0f / 64.0f;
+    q->g = 1.0f / sqrtf(64.0f);
+    q->sc16_scale = WLANFRAMEGEN_SC16_SCALE;
+
+    // initialize waveform caches
+    for (i=0; i<WLANFRAMEGEN_SIGNAL_CACHE_LEN; i++)
+        q->signal_cache[i].valid = 0;
+    q->signal_cache_timer = 0;
+    q->payload_cache_enabled = 0;
+    q->payload_cache_active  = 0;
+    q->payload_cache_valid   = 0;
+    q->payload_cache_length  = 0;
+    q->payload_cache_msg     = NULL;
+    q->payload_cache         = NULL;
 
     // reset objects
     wlanframegen_reset(q);
 
+    // pre-compute preamble; it is the same for every frame
+    wlanframegen_writesymbol_S0a(q, &q->preamble[  0]);
+    wlanframegen_writesymbol_S0b(q, &q->preamble[ 80]);
+    wlanframegen_writesymbol_S1a(q, &q->preamble[160]);
+    wlanframegen_writesymbol_S1b(q, &q->preamble[240]);
+    wlanframegen_reset(q);
+
     return q;
 }
 
@@ -152,10 +267,20 @@ void wlanframegen_destroy(wlanframegen _q)
     free(_q->X);
     free(_q->x);
     FFT_DESTROY_PLAN(_q->ifft);
-    
-    // destroy pilot sequence generator
-    wlan_lfsr_destroy(_q->ms_pilot);
 
+    // free batched transform memory
+#if HAVE_FFTW3_H
+    free(_q->Xb);
+    free(_q->xb);
+    FFT_DESTROY_PLAN(_q->ifft_batch);
+#endif
+    free(_q->buffer_data);
+
+    // free output interpolator
+    if (_q->resamp != NULL)
+        wlan_resamp_destroy(_q->resamp);
+    free(_q->buffer_symbol);
+    
     // free transition window ramp array and postfix buffer
     free(_q->rampup);
     free(_q->postfix);
@@ -163,6 +288,10 @@ void wlanframegen_destroy(wlanframegen _q)
     // free memory for encoded message
     free(_q->msg_enc);
 
+    // free payload cache memory
+    free(_q->payload_cache_msg);
+    free(_q->payload_cache);
+
     // free main object memory
     free(_q);
 }
@@ -172,7 +301,11 @@ void wlanframegen_print(wlanframegen _q)
 {
     printf("wlanframegen:\n");
     if (_q->frame_assembled) {
+        // SIGNAL field is only encoded when its waveform is not cached
+        wlanframegen_encode_signal(_q);
+
         printf("    rate        :   %3u Mbits/s\n", wlanframe_ratetab[_q->rate].rate);
+        printf("    interp      :   %3u/%u (samples/symbol: %u)\n", _q->P, _q->Q, _q->symbol_len);
         printf("    payload     :   %3u bytes\n", _q->length);
         printf("    ndbps       :   %3u (data bits per OFDM symbol)\n", _q->ndbps);
         printf("    ncbps       :   %3u (coded bits per OFDM symbol)\n", _q->ncbps);
@@ -209,11 +342,14 @@ void wlanframegen_reset(wlanframegen _q)
 {
     // reset state/counters
     _q->frame_assembled = 0;
+    _q->frame_complete = 0;
     _q->state = WLANFRAMEGEN_STATE_S0A;
     _q->data_symbol_counter = 0;
+    _q->buffer_index = _q->symbol_len;
 
-    // reset pilot sequence generator
-    wlan_lfsr_reset(_q->ms_pilot);
+    // reset output interpolator
+    if (_q->resamp != NULL)
+        wlan_resamp_reset(_q->resamp);
 
     // clear internal postfix buffer
     unsigned int i;
@@ -259,23 +395,24 @@ void wlanframegen_assemble(wlanframegen           _q,
     }
 #endif
 
+    // reset state so that consecutive frames start from the preamble
+    wlanframegen_reset(_q);
+
     // set internal properties
     _q->rate   = _txvector.DATARATE;
     _q->length = _txvector.LENGTH;
     _q->seed   = 0x5d;  //(_txvector.SERVICE >> 9) & 0x7f;
-    // TODO : strip off TXPWR_LEVEL
-
-    _q->mod_scheme = wlanframe_ratetab[_q->rate].mod_scheme;
 
-    // pack SIGNAL field
-    unsigned int R = 0; // 'reserved' bit
-    wlan_signal_pack(_q->rate, R, _q->length, _q->signal_dec);
+    // sc16 output scaling: 3 dB steps below full scale for TXPWR_LEVEL
+    // 2-8 (0 is unspecified and treated as 1, levels above 8 as 8)
+    unsigned int txpwr = _txvector.TXPWR_LEVEL > 8 ? 7 :
+                         _txvector.TXPWR_LEVEL > 1 ? _txvector.TXPWR_LEVEL - 1 : 0;
+    _q->sc16_scale = WLANFRAMEGEN_SC16_SCALE * powf(10.0f, -0.15f*(float)txpwr);
 
-    // encode SIGNAL field
-    wlan_fec_signal_encode(_q->signal_dec, _q->signal_enc);
+    _q->mod_scheme = wlanframe_ratetab[_q->rate].mod_scheme;
 
-    // interleave SIGNAL field
-    wlan_interleaver_encode_symbol(WLANFRAME_RATE_6, _q->signal_enc, _q->signal_int);
+    // NOTE : SIGNAL field is encoded in wlanframegen_writesymbol_signal()
+    //        only when its waveform is not already cached
 
     // compute frame parameters
     _q->ndbps  = wlanframe_ratetab[_q->rate].ndbps; // number of data bits per OFDM symbol
@@ -307,12 +444,38 @@ void wlanframegen_assemble(wlanframegen           _q,
     // validate encoded message length
     //assert(_q->enc_msg_len == wlan_packet_compute_enc_msg_len(_q->rate, _q->length));
 
+    // check payload cache: repeated frames (e.g. beacons) re-use both the
+    // encoded message and the DATA field waveform
+    if (_q->payload_cache_enabled          &&
+        _q->payload_cache_valid            &&
+        _q->payload_cache_rate   == _q->rate   &&
+        _q->payload_cache_seed   == _q->seed   &&
+        _q->payload_cache_length == _q->length &&
+        memcmp(_q->payload_cache_msg, _payload, _q->length) == 0)
+    {
+        _q->payload_cache_active = 1;
+        _q->frame_assembled = 1;
+        return;
+    }
+    _q->payload_cache_active = _q->payload_cache_enabled;
+    _q->payload_cache_valid  = 0;
+
     // re-allocate buffer for encoded message
     _q->msg_enc = (unsigned char*) realloc(_q->msg_enc, _q->enc_msg_len*sizeof(unsigned char));
 
     // encode message
     wlan_packet_encode(_q->rate, _q->seed, _q->length, _payload, _q->msg_enc);
 
+    // save payload key; waveform is cached once DATA field is written
+    if (_q->payload_cache_enabled) {
+        _q->payload_cache_rate   = _q->rate;
+        _q->payload_cache_seed   = _q->seed;
+        _q->payload_cache_length = _q->length;
+        _q->payload_cache_msg = (unsigned char*) realloc(_q->payload_cache_msg, _q->length*sizeof(unsigned char));
+        _q->payload_cache     = (float complex*) realloc(_q->payload_cache, 80*_q->nsym*sizeof(float complex));
+        memmove(_q->payload_cache_msg, _payload, _q->length*sizeof(unsigned char));
+    }
+
     // flag frame as being assembled
     _q->frame_assembled = 1;
 }
@@ -320,7 +483,7 @@ void wlanframegen_assemble(wlanframegen           _q,
 
 // write OFDM symbol, returning '1' when frame is complete
 //  _q          :   framing generator object
-//  _buffer     :   output sample buffer [size: 80 x 1]
+//  _buffer     :   output sample buffer [size: 80*P/Q x 1]
 int wlanframegen_writesymbol(wlanframegen    _q,
                              float complex * _buffer)
 {
@@ -330,22 +493,202 @@ int wlanframegen_writesymbol(wlanframegen    _q,
         exit(1);
     }
 
-    //
+    if (_q->resamp == NULL)
+        return wlanframegen_writesymbol_base(_q, _buffer);
+
+    // write symbol and interpolate
+    int last_symbol = wlanframegen_writesymbol_base(_q, _q->buffer_base);
+    unsigned int num_written;
+    wlan_resamp_execute(_q->resamp, _q->buffer_base, 80, _buffer, &num_written);
+    assert(num_written == _q->symbol_len);
+    return last_symbol;
+}
+
+// get length of assembled frame (number of samples)
+unsigned int wlanframegen_getframelen(wlanframegen _q)
+{
+    // validate input
+    if (!_q->frame_assembled) {
+        fprintf(stderr,"error: wlanframegen_getframelen(), frame not assembled\n");
+        exit(1);
+    }
+
+    // S0a, S0b, S1a, S1b, SIGNAL, DATA and NULL symbols
+    return _q->symbol_len*(5 + _q->nsym + 1);
+}
+
+// write entire frame to buffer; must be invoked immediately after
+// assembling the frame
+//  _q          :   framing generator object
+//  _buffer     :   output sample buffer [size: wlanframegen_getframelen() x 1]
+void wlanframegen_write_frame(wlanframegen    _q,
+                              float complex * _buffer)
+{
+    // validate input
+    if (!_q->frame_assembled) {
+        fprintf(stderr,"error: wlanframegen_write_frame(), frame not assembled\n");
+        exit(1);
+    } else if (_q->state != WLANFRAMEGEN_STATE_S0A || _q->buffer_index != _q->symbol_len) {
+        fprintf(stderr,"error: wlanframegen_write_frame(), frame partially written\n");
+        exit(1);
+    }
+
+    if (_q->resamp == NULL) {
+        wlanframegen_write_frame_base(_q, _buffer);
+        return;
+    }
+
+    // interpolate one symbol at a time; DATA symbols are still generated
+    // in batches
+    unsigned int n = 0;
+    while (!wlanframegen_writesymbol(_q, &_buffer[n]))
+        n += _q->symbol_len;
+    _q->frame_complete = 1;
+}
+
+// write samples to buffer, resuming where the previous call left off
+// and returning '1' when frame is complete; samples beyond the end of
+// the frame are set to zero
+//  _q          :   framing generator object
+//  _buffer     :   output sample buffer [size: _n x 1]
+//  _n          :   number of samples to write
+int wlanframegen_write_samples(wlanframegen    _q,
+                               float complex * _buffer,
+                               unsigned int    _n)
+{
+    // validate input
+    if (!_q->frame_assembled) {
+        fprintf(stderr,"error: wlanframegen_write_samples(), frame not assembled\n");
+        exit(1);
+    }
+
+    unsigned int n = 0; // number of samples written
+    while (n < _n) {
+        if (_q->buffer_index < _q->symbol_len) {
+            // copy what remains of partially-written symbol
+            unsigned int k = _q->symbol_len - _q->buffer_index;
+            if (k > _n - n)
+                k = _n - n;
+            memmove(&_buffer[n], &_q->buffer_symbol[_q->buffer_index], k*sizeof(float complex));
+            _q->buffer_index += k;
+            n += k;
+        } else if (_q->frame_complete) {
+            // frame complete; pad with zeros
+            memset(&_buffer[n], 0x00, (_n - n)*sizeof(float complex));
+            n = _n;
+        } else if (_n - n >= _q->symbol_len) {
+            // write full symbol directly to output
+            _q->frame_complete = wlanframegen_writesymbol(_q, &_buffer[n]);
+            n += _q->symbol_len;
+        } else {
+            // write symbol to internal buffer
+            _q->frame_complete = wlanframegen_writesymbol(_q, _q->buffer_symbol);
+            _q->buffer_index = 0;
+        }
+    }
+
+    return _q->frame_complete && _q->buffer_index == _q->symbol_len;
+}
+
+// write OFDM symbol as interleaved int16 I/Q, applying the TXPWR_LEVEL
+// gain with rounding and saturation; returns '1' when frame is complete
+//  _q          :   framing generator object
+//  _buffer     :   output I/Q buffer [size: 2*80*P/Q x 1]
+int wlanframegen_writesymbol_sc16(wlanframegen _q,
+                                  int16_t *    _buffer)
+{
+    // write symbol to internal buffer and convert
+    int last_symbol = wlanframegen_writesymbol(_q, _q->buffer_symbol);
+    liquid_wlan_cf_to_sc16(_q->buffer_symbol, _q->symbol_len, _q->sc16_scale, _buffer);
+    return last_symbol;
+}
+
+// write entire frame as interleaved int16 I/Q
+//  _q          :   framing generator object
+//  _buffer     :   output I/Q buffer [size: 2*wlanframegen_getframelen() x 1]
+void wlanframegen_write_frame_sc16(wlanframegen _q,
+                                   int16_t *    _buffer)
+{
+    // validate input
+    if (!_q->frame_assembled) {
+        fprintf(stderr,"error: wlanframegen_write_frame_sc16(), frame not assembled\n");
+        exit(1);
+    } else if (_q->state != WLANFRAMEGEN_STATE_S0A || _q->buffer_index != _q->symbol_len) {
+        fprintf(stderr,"error: wlanframegen_write_frame_sc16(), frame partially written\n");
+        exit(1);
+    }
+
+    // convert one symbol at a time while it is still in cache; DATA
+    // symbols are still generated in batches
+    unsigned int n = 0;
+    while (!wlanframegen_writesymbol_sc16(_q, &_buffer[2*n]))
+        n += _q->symbol_len;
+    _q->frame_complete = 1;
+}
+
+// write samples as interleaved int16 I/Q
+//  _q          :   framing generator object
+//  _buffer     :   output I/Q buffer [size: 2*_n x 1]
+//  _n          :   number of samples to write
+int wlanframegen_write_samples_sc16(wlanframegen _q,
+                                    int16_t *    _buffer,
+                                    unsigned int _n)
+{
+    // write and convert in blocks small enough to remain in cache
+    float complex buffer[256];
+    unsigned int n = 0;
+    int frame_complete = 0;
+    do {
+        unsigned int k = _n - n < 256 ? _n - n : 256;
+        frame_complete = wlanframegen_write_samples(_q, buffer, k);
+        liquid_wlan_cf_to_sc16(buffer, k, _q->sc16_scale, &_buffer[2*n]);
+        n += k;
+    } while (n < _n);
+
+    return frame_complete;
+}
+
+// enable caching of DATA field waveform, effective at the next call to
+// wlanframegen_assemble(); assembling a frame with the same payload,
+// rate and seed as the previous one re-uses its samples
+void wlanframegen_payload_cache_enable(wlanframegen _q)
+{
+    _q->payload_cache_enabled = 1;
+}
+
+// disable caching of DATA field waveform
+void wlanframegen_payload_cache_disable(wlanframegen _q)
+{
+    _q->payload_cache_enabled = 0;
+    _q->payload_cache_valid   = 0;
+}
+
+// 
+// internal methods
+//
+
+// write OFDM symbol before interpolation, returning '1' when frame is
+// complete
+//  _q          :   framing generator object
+//  _buffer     :   output sample buffer [size: 80 x 1]
+int wlanframegen_writesymbol_base(wlanframegen    _q,
+                                  float complex * _buffer)
+{
     switch (_q->state) {
     case WLANFRAMEGEN_STATE_S0A:
-        wlanframegen_writesymbol_S0a(_q, _buffer);
+        wlanframegen_copy_preamble(_q, 0, 1, _buffer);
         _q->state = WLANFRAMEGEN_STATE_S0B;
         return 0;
     case WLANFRAMEGEN_STATE_S0B:
-        wlanframegen_writesymbol_S0b(_q, _buffer);
+        wlanframegen_copy_preamble(_q, 1, 1, _buffer);
         _q->state = WLANFRAMEGEN_STATE_S1A;
         return 0;
     case WLANFRAMEGEN_STATE_S1A:
-        wlanframegen_writesymbol_S1a(_q, _buffer);
+        wlanframegen_copy_preamble(_q, 2, 1, _buffer);
         _q->state = WLANFRAMEGEN_STATE_S1B;
         return 0;
     case WLANFRAMEGEN_STATE_S1B:
-        wlanframegen_writesymbol_S1b(_q, _buffer);
+        wlanframegen_copy_preamble(_q, 3, 1, _buffer);
         _q->state = WLANFRAMEGEN_STATE_SIGNAL;
         return 0;
     case WLANFRAMEGEN_STATE_SIGNAL:
@@ -364,7 +707,7 @@ int wlanframegen_writesymbol(wlanframegen    _q,
         return 1;
     default:
         // should never get to this point
-        fprintf(stderr,"error: wlanframegen_writesymbol(), invalid state\n");
+        fprintf(stderr,"error: wlanframegen_writesymbol_base(), invalid state\n");
         exit(1);
     }
 
@@ -373,17 +716,78 @@ int wlanframegen_writesymbol(wlanframegen    _q,
     return 1;
 }
 
-// 
-// internal methods
-//
+// write entire frame before interpolation
+//  _q          :   framing generator object
+//  _buffer     :   output sample buffer [size: 80*(6+nsym) x 1]
+void wlanframegen_write_frame_base(wlanframegen    _q,
+                                   float complex * _buffer)
+{
+    // write preamble and SIGNAL symbol
+    wlanframegen_copy_preamble(     _q, 0, 4, &_buffer[  0]);
+    wlanframegen_writesymbol_signal(_q,       &_buffer[320]);
+
+    // write all DATA symbols directly to output
+    if (_q->payload_cache_active && _q->payload_cache_valid) {
+        memmove(&_buffer[400], _q->payload_cache, 80*_q->nsym*sizeof(float complex));
+        memmove(_q->postfix, &_q->payload_cache[80*(_q->nsym-1)+16], _q->rampup_len*sizeof(float complex));
+    } else {
+        wlanframegen_gensymbols_data(_q, 0, _q->nsym, &_buffer[400]);
+
+        if (_q->payload_cache_active) {
+            memmove(_q->payload_cache, &_buffer[400], 80*_q->nsym*sizeof(float complex));
+            _q->payload_cache_valid = 1;
+        }
+    }
+
+    // write NULL symbol
+    wlanframegen_writesymbol_null(_q, &_buffer[400 + 80*_q->nsym]);
+
+    // update state
+    _q->data_symbol_counter = _q->nsym;
+    _q->state = WLANFRAMEGEN_STATE_NULL;
+    _q->frame_complete = 1;
+}
+
+// copy pre-computed preamble symbol(s) to buffer
+//  _q          :   framing generator object
+//  _k          :   index of first preamble symbol (0:S0a, 1:S0b, 2:S1a, 3:S1b)
+//  _num        :   number of symbols to copy
+//  _buffer     :   output sample buffer [size: 80*_num x 1]
+void wlanframegen_copy_preamble(wlanframegen    _q,
+                                unsigned int    _k,
+                                unsigned int    _num,
+                                float complex * _buffer)
+{
+    memmove(_buffer, &_q->preamble[80*_k], 80*_num*sizeof(float complex));
+
+    // post-fix is first _p samples of last symbol following its cyclic prefix
+    memmove(_q->postfix, &_q->preamble[80*(_k+_num-1)+16], _q->rampup_len*sizeof(float complex));
+}
+
+// pack, encode, and interleave SIGNAL field
+void wlanframegen_encode_signal(wlanframegen _q)
+{
+    // pack SIGNAL field
+    unsigned int R = 0; // 'reserved' bit
+    wlan_signal_pack(_q->rate, R, _q->length, _q->signal_dec);
+
+    // encode SIGNAL field
+    wlan_fec_signal_encode(_q->signal_dec, _q->signal_enc);
+
+    // interleave SIGNAL field
+    wlan_interleaver_encode_symbol(WLANFRAME_RATE_6, _q->signal_enc, _q->signal_int);
+}
 
 // compute symbol: add/update pilots, add nulls and compute transform
 //  * input stored in 'X' (internal ifft input)
 //  * output stored in 'x' (internal ifft output)
-void wlanframegen_compute_symbol(wlanframegen _q)
+//  _q          :   framing generator object
+//  _n          :   OFDM symbol index (0 for SIGNAL)
+void wlanframegen_compute_symbol(wlanframegen _q,
+                                 unsigned int _n)
 {
-    // update pilot phase
-    unsigned int pilot_phase = wlan_lfsr_advance(_q->ms_pilot);
+    // pilot phase
+    unsigned int pilot_phase = wlanframe_pilot_polarity[_n % WLANFRAME_PILOT_PERIOD];
 
     // set pilots
     _q->X[43] = pilot_phase ? -1.0f :  1.0f;
@@ -503,10 +907,47 @@ void wlanframegen_writesymbol_S1b(wlanframegen _q,
                            _buffer);
 }
 
-// write SIGNAL symbol
+// write SIGNAL symbol; the waveform depends only upon the rate and
+// length, and is kept in a small least-recently-used cache
 void wlanframegen_writesymbol_signal(wlanframegen _q,
                                      float complex * _buffer)
 {
+    // search cache, tracking least-recently-used entry
+    unsigned int i;
+    unsigned int i_lru = 0;
+    for (i=0; i<WLANFRAMEGEN_SIGNAL_CACHE_LEN; i++) {
+        struct wlanframegen_signal_s * e = &_q->signal_cache[i];
+        if (e->valid && e->rate == _q->rate && e->length == _q->length) {
+            // cache hit: copy waveform and update post-fix
+            e->timestamp = ++_q->signal_cache_timer;
+            memmove(_buffer, e->symbol, 80*sizeof(float complex));
+            memmove(_q->postfix, &e->symbol[16], _q->rampup_len*sizeof(float complex));
+            return;
+        }
+
+        // prefer empty entries, otherwise the oldest
+        if (!e->valid || (_q->signal_cache[i_lru].valid && e->timestamp < _q->signal_cache[i_lru].timestamp))
+            i_lru = i;
+    }
+
+    // cache miss: generate waveform and replace least-recently-used entry
+    wlanframegen_gensymbol_signal(_q, _buffer);
+
+    struct wlanframegen_signal_s * e = &_q->signal_cache[i_lru];
+    e->valid     = 1;
+    e->rate      = _q->rate;
+    e->length    = _q->length;
+    e->timestamp = ++_q->signal_cache_timer;
+    memmove(e->symbol, _buffer, 80*sizeof(float complex));
+}
+
+// generate SIGNAL symbol
+void wlanframegen_gensymbol_signal(wlanframegen _q,
+                                   float complex * _buffer)
+{
+    // pack, encode, and interleave SIGNAL field
+    wlanframegen_encode_signal(_q);
+
     // load 48 SIGNAL BPSK symbols onto appropriate subcarriers
     _q->X[38] = (_q->signal_int[0] & 0x80) ? 1.0f : -1.0f;
     _q->X[39] = (_q->signal_int[0] & 0x40) ? 1.0f : -1.0f;
@@ -563,7 +1004,7 @@ void wlanframegen_writesymbol_signal(wlanframegen _q,
     _q->X[26] = (_q->signal_int[5] & 0x01) ? 1.0f : -1.0f;
 
     // run transform
-    wlanframegen_compute_symbol(_q);
+    wlanframegen_compute_symbol(_q, 0);
 
     // validate against Table G.11
 
@@ -585,48 +1026,114 @@ void wlanframegen_writesymbol_signal(wlanframegen _q,
 // write data symbol(s)
 void wlanframegen_writesymbol_data(wlanframegen _q,
                                    float complex * _buffer)
+{
+    if (_q->payload_cache_active) {
+        // generate entire DATA field into cache on first symbol
+        if (!_q->payload_cache_valid && _q->data_symbol_counter == 0) {
+            wlanframegen_gensymbols_data(_q, 0, _q->nsym, _q->payload_cache);
+            _q->payload_cache_valid = 1;
+        }
+
+        // copy symbol from cache, updating post-fix after last symbol
+        float complex * symbol = &_q->payload_cache[80*_q->data_symbol_counter];
+        memmove(_buffer, symbol, 80*sizeof(float complex));
+        if (_q->data_symbol_counter == _q->nsym-1)
+            memmove(_q->postfix, &symbol[16], _q->rampup_len*sizeof(float complex));
+        return;
+    }
+
+    // index of symbol within batch
+    unsigned int k = _q->data_symbol_counter % WLANFRAMEGEN_BATCH_LEN;
+
+    // generate next batch of symbols as necessary
+    if (k == 0) {
+        unsigned int num = _q->nsym - _q->data_symbol_counter;
+        if (num > WLANFRAMEGEN_BATCH_LEN)
+            num = WLANFRAMEGEN_BATCH_LEN;
+
+        wlanframegen_gensymbols_data(_q, _q->data_symbol_counter, num, _q->buffer_data);
+    }
+
+    // copy symbol from batch buffer
+    memmove(_buffer, &_q->buffer_data[80*k], 80*sizeof(float complex));
+}
+
+// load DATA symbol onto subcarriers, adding pilots and applying gain
+//  _q          :   framing generator object
+//  _n          :   DATA symbol index
+//  _X          :   frequency-domain output (NULL subcarriers untouched) [size: 64 x 1]
+void wlanframegen_load_data_symbol(wlanframegen    _q,
+                                   unsigned int    _n,
+                                   float complex * _X)
 {
     // unpack modem symbols
     //printf("  %3u = %3u * %3u\n", _q->enc_msg_len, _q->nsym, _q->bytes_per_symbol);
     unsigned int num_written;
-    liquid_wlan_repack_bytes(&_q->msg_enc[_q->data_symbol_counter * _q->bytes_per_symbol], 8, _q->bytes_per_symbol,
+    liquid_wlan_repack_bytes(&_q->msg_enc[_n * _q->bytes_per_symbol], 8, _q->bytes_per_symbol,
                              _q->modem_syms, _q->nbpsc, 48,
                              &num_written);
     assert(num_written == 48);
 
-    // modulate symbols onto subcarriers
-    // TODO : do this more efficiently
+    // modulate symbols onto subcarriers, applying gain
+    float complex x[48];
+    wlan_modulate_block(_q->mod_scheme, _q->modem_syms, 48, x);
     unsigned int i;
-    unsigned int n=0;
-    for (i=0; i<64; i++) {
-        unsigned int k = (i + 32) % 64;
-
-        if ( k==0 || (k > 26 && k < 38) ) {
-            // NULL subcarrier
-        } else if (k==43 || k==57 || k==7 || k==21) {
-            // PILOT subcarrier
-        } else {
-            // DATA subcarrier
-            assert(n<48);
-            _q->X[k] = wlan_modulate(_q->mod_scheme, _q->modem_syms[n]);
-            n++;
+    for (i=0; i<48; i++)
+        _X[wlanframe_data_subcarriers[i]] = x[i] * _q->g;
+
+    // set pilots; SIGNAL is symbol 0 of pilot sequence
+    unsigned int pilot_phase = wlanframe_pilot_polarity[(_n+1) % WLANFRAME_PILOT_PERIOD];
+    _X[43] = pilot_phase ? -_q->g :  _q->g;
+    _X[57] = pilot_phase ? -_q->g :  _q->g;
+    _X[ 7] = pilot_phase ? -_q->g :  _q->g;
+    _X[21] = pilot_phase ?  _q->g : -_q->g;
+}
+
+// generate multiple DATA symbols, writing prefixed, windowed samples
+// directly to output buffer
+//  _q          :   framing generator object
+//  _n          :   index of first DATA symbol
+//  _num        :   number of DATA symbols to generate
+//  _buffer     :   output sample buffer [size: 80*_num x 1]
+void wlanframegen_gensymbols_data(wlanframegen    _q,
+                                  unsigned int    _n,
+                                  unsigned int    _num,
+                                  float complex * _buffer)
+{
+    unsigned int s = 0;
+    unsigned int i;
+
+#if HAVE_FFTW3_H
+    // run full batches through a single batched transform
+    while (_num - s >= WLANFRAMEGEN_BATCH_LEN) {
+        for (i=0; i<WLANFRAMEGEN_BATCH_LEN; i++)
+            wlanframegen_load_data_symbol(_q, _n + s + i, &_q->Xb[64*i]);
+
+        FFT_EXECUTE(_q->ifft_batch);
+
+        for (i=0; i<WLANFRAMEGEN_BATCH_LEN; i++) {
+            wlanframegen_gensymbol(&_q->xb[64*i],
+                                   _q->postfix,
+                                   _q->rampup,
+                                   _q->rampup_len,
+                                   &_buffer[80*(s+i)]);
         }
+        s += WLANFRAMEGEN_BATCH_LEN;
     }
-    assert(n==48);
+#endif
 
-    // run transform
-    wlanframegen_compute_symbol(_q);
+    // run remaining symbols through regular transform
+    for (i=s; i<_num; i++) {
+        wlanframegen_load_data_symbol(_q, _n + i, _q->X);
 
-    // apply gain
-    for (i=0; i<64; i++)
-        _q->x[i] /= sqrtf(64.0f);
-    
-    // generate SIGNAL symbol
-    wlanframegen_gensymbol(_q->x,
-                           _q->postfix,
-                           _q->rampup,
-                           _q->rampup_len,
-                           _buffer);
+        FFT_EXECUTE(_q->ifft);
+
+        wlanframegen_gensymbol(_q->x,
+                               _q->postfix,
+                               _q->rampup,
+                               _q->rampup_len,
+                               &_buffer[80*i]);
+    }
 }
 
 // write null symbol(s)
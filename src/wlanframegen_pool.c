@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanframegen_pool.c
+//
+// Multi-threaded frame generation: jobs are submitted to a bounded ring
+// of slots and claimed by worker threads, each with its own frame
+// generator; frames are read back in submission order.
+//
+// The ring indices are lock-free: the producer owns the head, the
+// consumer owns the tail, and workers claim jobs with an atomic
+// increment. Semaphores are used only to block when the ring is full,
+// empty, or the next frame is not yet ready.
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "liquid-wlan.internal.h"
+
+#define DEBUG_WLANFRAMEGEN_POOL       0
+
+// job/frame slot
+struct wlanframegen_pool_slot_s {
+    // job
+    unsigned char payload[4095];        // raw payload data
+    struct wlan_txvector_s txvector;    // framing options
+
+    // frame
+    float complex * frame;              // frame samples
+    unsigned int frame_len;             // number of samples in frame
+    unsigned int frame_alloc;           // number of samples allocated
+    sem_t ready;                        // frame ready for reading
+};
+
+// worker thread
+struct wlanframegen_pool_worker_s {
+    pthread_t thread;                   // thread handle
+    wlanframegen fg;                    // frame generator
+    wlanframegen_pool pool;             // parent pool
+};
+
+struct wlanframegen_pool_s {
+    unsigned int num_threads;           // number of worker threads
+    unsigned int num_slots;             // number of slots in ring
+    struct wlanframegen_pool_slot_s *   slots;
+    struct wlanframegen_pool_worker_s * workers;
+
+    // ring indices
+    unsigned long int head;             // next slot to submit (producer, atomic)
+    unsigned long int tail;             // next slot to read (consumer, atomic)
+    unsigned long int claim;            // next slot to process (workers, atomic)
+    int frame_read;                     // frame at tail has been read?
+    int stop;                           // stop workers (atomic)
+
+    // blocking
+    sem_t slots_free;                   // number of free slots
+    sem_t jobs_pending;                 // number of submitted jobs
+};
+
+// create frame generation pool
+//  _num_threads    :   number of worker threads, _num_threads > 0
+//  _num_slots      :   number of jobs/frames in flight, _num_slots > 0
+wlanframegen_pool wlanframegen_pool_create(unsigned int _num_threads,
+                                           unsigned int _num_slots)
+{
+    // validate input
+    if (_num_threads == 0) {
+        fprintf(stderr,"error: wlanframegen_pool_create(), number of threads must be greater than zero\n");
+        exit(1);
+    } else if (_num_slots == 0) {
+        fprintf(stderr,"error: wlanframegen_pool_create(), number of slots must be greater than zero\n");
+        exit(1);
+    }
+
+    wlanframegen_pool q = (wlanframegen_pool) malloc(sizeof(struct wlanframegen_pool_s));
+    q->num_threads = _num_threads;
+    q->num_slots   = _num_slots;
+
+    // initialize ring
+    q->head       = 0;
+    q->tail       = 0;
+    q->claim      = 0;
+    q->frame_read = 0;
+    q->stop       = 0;
+    sem_init(&q->slots_free,   0, q->num_slots);
+    sem_init(&q->jobs_pending, 0, 0);
+
+    unsigned int i;
+    q->slots = (struct wlanframegen_pool_slot_s*) malloc(q->num_slots*sizeof(struct wlanframegen_pool_slot_s));
+    for (i=0; i<q->num_slots; i++) {
+        q->slots[i].frame       = NULL;
+        q->slots[i].frame_len   = 0;
+        q->slots[i].frame_alloc = 0;
+        sem_init(&q->slots[i].ready, 0, 0);
+    }
+
+    // create frame generators serially; transform planners are not
+    // necessarily thread-safe
+    q->workers = (struct wlanframegen_pool_worker_s*) malloc(q->num_threads*sizeof(struct wlanframegen_pool_worker_s));
+    for (i=0; i<q->num_threads; i++) {
+        q->workers[i].fg   = wlanframegen_create();
+        q->workers[i].pool = q;
+    }
+
+    // start worker threads
+    for (i=0; i<q->num_threads; i++) {
+        if (pthread_create(&q->workers[i].thread, NULL, wlanframegen_pool_worker, &q->workers[i]) != 0) {
+            fprintf(stderr,"error: wlanframegen_pool_create(), could not create thread\n");
+            exit(1);
+        }
+    }
+
+    return q;
+}
+
+// destroy frame generation pool; frames not yet read are discarded
+void wlanframegen_pool_destroy(wlanframegen_pool _q)
+{
+    // stop and join worker threads
+    unsigned int i;
+    __atomic_store_n(&_q->stop, 1, __ATOMIC_RELEASE);
+    for (i=0; i<_q->num_threads; i++)
+        sem_post(&_q->jobs_pending);
+    for (i=0; i<_q->num_threads; i++)
+        pthread_join(_q->workers[i].thread, NULL);
+
+    // destroy frame generators serially
+    for (i=0; i<_q->num_threads; i++)
+        wlanframegen_destroy(_q->workers[i].fg);
+    free(_q->workers);
+
+    // free slots
+    for (i=0; i<_q->num_slots; i++) {
+        free(_q->slots[i].frame);
+        sem_destroy(&_q->slots[i].ready);
+    }
+    free(_q->slots);
+
+    sem_destroy(&_q->slots_free);
+    sem_destroy(&_q->jobs_pending);
+
+    // free main object memory
+    free(_q);
+}
+
+// print frame generation pool object internals
+void wlanframegen_pool_print(wlanframegen_pool _q)
+{
+    printf("wlanframegen_pool:\n");
+    printf("    threads     :   %u\n", _q->num_threads);
+    printf("    slots       :   %u\n", _q->num_slots);
+    printf("    submitted   :   %lu\n", _q->head);
+    printf("    read        :   %lu\n", _q->tail);
+}
+
+// submit frame for generation, blocking while all slots are in use
+//  _q          :   frame generation pool
+//  _payload    :   raw payload data [size: _txvector.LENGTH x 1]
+//  _txvector   :   framing options
+void wlanframegen_pool_submit(wlanframegen_pool      _q,
+                              unsigned char *        _payload,
+                              struct wlan_txvector_s _txvector)
+{
+    // validate input; workers cannot report errors
+    if (_txvector.DATARATE > 7 || _txvector.DATARATE == WLANFRAME_RATE_9) {
+        fprintf(stderr,"error: wlanframegen_pool_submit(), invalid rate\n");
+        exit(1);
+    } else if (_txvector.LENGTH == 0 || _txvector.LENGTH > 4095) {
+        fprintf(stderr,"error: wlanframegen_pool_submit(), invalid data length\n");
+        exit(1);
+    }
+
+    // wait for free slot
+    while (sem_wait(&_q->slots_free) != 0);
+
+    // copy job into slot; slot is owned by producer until released
+    struct wlanframegen_pool_slot_s * slot = &_q->slots[_q->head % _q->num_slots];
+    memmove(slot->payload, _payload, _txvector.LENGTH*sizeof(unsigned char));
+    slot->txvector = _txvector;
+    __atomic_store_n(&_q->head, _q->head+1, __ATOMIC_RELEASE);
+
+    // release job to workers
+    sem_post(&_q->jobs_pending);
+}
+
+// read next frame in submission order, blocking until it is ready; the
+// returned buffer is valid until wlanframegen_pool_release() is invoked
+//  _q          :   frame generation pool
+//  _frame_len  :   number of samples in frame
+float complex * wlanframegen_pool_read(wlanframegen_pool _q,
+                                       unsigned int *    _frame_len)
+{
+    // validate input
+    if (_q->frame_read) {
+        fprintf(stderr,"error: wlanframegen_pool_read(), previous frame not released\n");
+        exit(1);
+    } else if (_q->tail == __atomic_load_n(&_q->head, __ATOMIC_ACQUIRE)) {
+        fprintf(stderr,"error: wlanframegen_pool_read(), no frames submitted\n");
+        exit(1);
+    }
+
+    // wait for frame
+    struct wlanframegen_pool_slot_s * slot = &_q->slots[_q->tail % _q->num_slots];
+    while (sem_wait(&slot->ready) != 0);
+    _q->frame_read = 1;
+
+    *_frame_len = slot->frame_len;
+    return slot->frame;
+}
+
+// release frame returned by wlanframegen_pool_read(), freeing its slot
+void wlanframegen_pool_release(wlanframegen_pool _q)
+{
+    // validate input
+    if (!_q->frame_read) {
+        fprintf(stderr,"error: wlanframegen_pool_release(), no frame to release\n");
+        exit(1);
+    }
+
+    _q->frame_read = 0;
+    __atomic_store_n(&_q->tail, _q->tail+1, __ATOMIC_RELEASE);
+    sem_post(&_q->slots_free);
+}
+
+// get number of frames submitted but not yet released
+unsigned int wlanframegen_pool_get_backlog(wlanframegen_pool _q)
+{
+    unsigned long int head = __atomic_load_n(&_q->head, __ATOMIC_ACQUIRE);
+    unsigned long int tail = __atomic_load_n(&_q->tail, __ATOMIC_ACQUIRE);
+    return (unsigned int)(head - tail);
+}
+
+//
+// internal methods
+//
+
+// worker thread: claim jobs in order and generate frames
+void * wlanframegen_pool_worker(void * _arg)
+{
+    struct wlanframegen_pool_worker_s * w = (struct wlanframegen_pool_worker_s*) _arg;
+    wlanframegen_pool q = w->pool;
+
+    while (1) {
+        // wait for job (or stop signal)
+        while (sem_wait(&q->jobs_pending) != 0);
+        if (__atomic_load_n(&q->stop, __ATOMIC_ACQUIRE))
+            break;
+
+        // claim job; every wait consumed corresponds to exactly one
+        // submitted job, so the claimed slot is always populated
+        unsigned long int n = __atomic_fetch_add(&q->claim, 1, __ATOMIC_ACQ_REL);
+        struct wlanframegen_pool_slot_s * slot = &q->slots[n % q->num_slots];
+
+        // assemble frame and re-allocate slot buffer as needed
+        wlanframegen_assemble(w->fg, slot->payload, slot->txvector);
+        slot->frame_len = wlanframegen_getframelen(w->fg);
+        if (slot->frame_len > slot->frame_alloc) {
+            slot->frame_alloc = slot->frame_len;
+            slot->frame = (float complex*) realloc(slot->frame, slot->frame_alloc*sizeof(float complex));
+        }
+
+        // generate frame and release slot to consumer
+        wlanframegen_write_frame(w->fg, slot->frame);
+#if DEBUG_WLANFRAMEGEN_POOL
+        printf("wlanframegen_pool: frame %lu complete (%u samples)\n", n, slot->frame_len);
+#endif
+        sem_post(&slot->ready);
+    }
+
+    return NULL;
+}
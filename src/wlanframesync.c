@@ -35,6 +35,14 @@
 #define DEBUG_WLANFRAMESYNC_FILENAME    "wlanframesync_internal_debug.m"
 #define DEBUG_WLANFRAMESYNC_BUFFER_LEN  (2048)
 
+// number of samples converted at a time for integer input
+#define WLANFRAMESYNC_CONVERT_LEN       (256)
+
+// number of input samples passed through the front-end at a time, and
+// front-end filter semi-length at 20 MHz (scaled with the input rate)
+#define WLANFRAMESYNC_FRONTEND_LEN      (256)
+#define WLANFRAMESYNC_FRONTEND_M        (16)
+
 // Thresholds for detecting short sequences
 #define WLANFRAMESYNC_S0A_ABS_THRESH    (0.4f)
 //#define WLANFRAMESYNC_S0B_ABS_THRESH    (0.5f)
@@ -50,6 +58,7 @@
 struct wlanframesync_s {
     // callback
     wlanframesync_callback callback;
+    wlanframesync_reject_callback reject;   // frame detected but not decoded
     void * userdata;
 
     // options
@@ -63,10 +72,16 @@ struct wlanframesync_s {
     float complex * x;      // time-domain buffer
     windowcf input_buffer;  // input sequence buffer
 
+    // front-end: down-converter and resampler to 20 MHz (NULL if the
+    // input is already 20 MHz baseband)
+    wlan_resamp frontend;
+    float complex * frontend_buffer;    // resampled front-end output
+    unsigned int frontend_P;            // front-end interpolation factor
+    unsigned int frontend_Q;            // front-end decimation factor
+    unsigned int frontend_delay;        // front-end delay (input samples)
+
     // synchronizer objects
     nco_crcf nco_rx;        // numerically-controlled oscillator
-    wlan_lfsr ms_pilot;     // pilot sequence generator
-    unsigned int mod_scheme;// DATA field (de)modulation scheme
     float phi_prime;        // stored pilot phase
 
     // gain arrays
@@ -89,16 +104,17 @@ struct wlanframesync_s {
     unsigned int nsym;              // number of OFDM symbols in the DATA field
     unsigned int ndata;             // number of bits in the DATA field
     unsigned int npad;              // number of pad bits
-    unsigned int bytes_per_symbol;  // number of encoded data bytes per OFDM symbol
 
     // data arrays
     unsigned char   signal_int[6];  // interleaved message (SIGNAL field)
     unsigned char   signal_enc[6];  // encoded message (SIGNAL field)
     unsigned char   signal_dec[3];  // decoded message (SIGNAL field)
-    unsigned char * msg_enc;        // encoded message (DATA field)
-    unsigned char * msg_dec;        // decoded message (DATA field)
-    unsigned char   modem_syms[48]; // modem symbols
     int signal_valid;               // SIGNAL field decoded properly?
+
+    // DATA field reception
+    wlanframesync_rxdata rx;        // inline DATA field receiver
+    wlanframesync_pool pool;        // decoding pool (NULL if decoding inline)
+    struct wlanframesync_pool_frame_s * frame;  // frame being captured
     
     // counters/states
     enum {
@@ -109,9 +125,15 @@ struct wlanframesync_s {
         WLANFRAMESYNC_STATE_RXLONG1,    // receive second 'long' sequence
         WLANFRAMESYNC_STATE_RXSIGNAL,   // receive SIGNAL field
         WLANFRAMESYNC_STATE_RXDATA,     // receive DATA field
+        WLANFRAMESYNC_STATE_RXSPAN,     // capture DATA field for decoding pool
     } state;
     signed int timer;                   // sample timer
-    unsigned int num_symbols;           // number of received OFDM data symbols
+    unsigned long int num_samples;      // number of baseband samples received
+    unsigned long int frame_start;      // sample index of last frame's start
+    unsigned long int input_start;      // input index set by wlanframesync_set_sample_index()
+    unsigned long int baseband_start;   // baseband index at input_start
+    float cfo;                          // carrier offset of last frame
+    float rssi;                         // signal strength of last frame [dB]
 
 #if DEBUG_WLANFRAMESYNC
     // debugging structures
@@ -123,6 +145,42 @@ struct wlanframesync_s {
 #endif
 };
 
+// DATA field receiver: corrects carrier offset, equalizes, demodulates
+// and decodes aligned DATA symbols; owned by the synchronizer when
+// decoding inline, and by each worker thread of a decoding pool
+struct wlanframesync_rxdata_s {
+    // options
+    unsigned int rate;      // primitive data rate
+    unsigned int seed;      // data scrambler seed
+    unsigned int length;    // original data length (bytes)
+    unsigned int rssi;      // received signal strength indicator
+
+    // transform object
+    FFT_PLAN fft;           // fft object
+    float complex * X;      // frequency-domain buffer
+    float complex * x;      // time-domain buffer
+
+    // carrier and channel correction
+    nco_crcf nco;           // carrier offset, tracked by pilots
+    float complex R[64];    // complex channel correction
+    float phi_prime;        // stored pilot phase
+
+    // lengths
+    unsigned int mod_scheme;        // DATA field (de)modulation scheme
+    unsigned int nbpsc;             // number of bits per subcarrier
+    unsigned int nsym;              // number of OFDM symbols in the DATA field
+    unsigned int bytes_per_symbol;  // number of encoded data bytes per OFDM symbol
+    unsigned int num_symbols;       // number of received OFDM data symbols
+
+    // data arrays
+    float complex   syms[48];       // equalized DATA subcarriers
+    unsigned char   modem_syms[48]; // modem symbols
+    unsigned char * msg_enc;        // encoded message
+    unsigned char * msg_dec;        // decoded message
+    unsigned int enc_alloc;         // encoded message allocation (bytes)
+    unsigned int dec_alloc;         // decoded message allocation (bytes)
+};
+
 // create WLAN framing synchronizer object
 //  _callback   :   user-defined callback function
 //  _userdata   :   user-defined data structure
@@ -134,6 +192,7 @@ wlanframesync wlanframesync_create(wlanframesync_callback _callback,
     
     // set callback data
     q->callback = _callback;
+    q->reject   = NULL;
     q->userdata = _userdata;
 
     // create transform object
@@ -146,21 +205,32 @@ wlanframesync wlanframesync_create(wlanframesync_callback _callback,
 
     // synchronizer objects
     q->nco_rx = nco_crcf_create(LIQUID_VCO);
-    q->ms_pilot = wlan_lfsr_create(7, 0x91, 0x7f);
-    q->mod_scheme = WLAN_MODEM_BPSK;
+
+    // input is 20 MHz baseband by default
+    q->frontend        = NULL;
+    q->frontend_buffer = NULL;
+    q->frontend_P      = 1;
+    q->frontend_Q      = 1;
+    q->frontend_delay  = 0;
 
     // set initial properties
     q->rate   = WLANFRAME_RATE_6;
     q->length = 100;
     q->seed   = 0x5d;
 
-    // allocate memory for encoded message
-    q->enc_msg_len = wlan_packet_compute_enc_msg_len(q->rate, q->length);
-    q->msg_enc = (unsigned char*) malloc(q->enc_msg_len*sizeof(unsigned char));
+    // DATA field receiver; frames are decoded inline by default
+    q->rx    = wlanframesync_rxdata_create();
+    q->pool  = NULL;
+    q->frame = NULL;
 
-    // allocate memory for decoded message
-    q->dec_msg_len = 1;
-    q->msg_dec = (unsigned char*) malloc(q->dec_msg_len*sizeof(unsigned char));
+    // sample counters are not cleared by reset
+    q->num_samples = 0;
+    q->frame_start = 0;
+    q->input_start    = 0;
+    q->baseband_start = 0;
+    q->cfo         = 0.0f;
+    q->rssi        = 0.0f;
+    q->g0          = 1.0f;
 
     // reset object
     wlanframesync_reset(q);
@@ -178,9 +248,43 @@ wlanframesync wlanframesync_create(wlanframesync_callback _callback,
     return q;
 }
 
+// create WLAN framing synchronizer object which only detects frames,
+// handing each aligned DATA field to a pool of worker threads for
+// equalization, demodulation and decoding; the callback is invoked from
+// the worker threads, one frame at a time and in order of detection
+//  _callback       :   user-defined callback function
+//  _userdata       :   user-defined data structure
+//  _num_threads    :   number of decoding threads, _num_threads > 0
+//  _num_slots      :   number of frames in flight, _num_slots > 0
+wlanframesync wlanframesync_create_pool(wlanframesync_callback _callback,
+                                        void *                 _userdata,
+                                        unsigned int           _num_threads,
+                                        unsigned int           _num_slots)
+{
+    // validate input
+    if (_num_threads == 0) {
+        fprintf(stderr,"error: wlanframesync_create_pool(), number of threads must be greater than zero\n");
+        exit(1);
+    } else if (_num_slots == 0) {
+        fprintf(stderr,"error: wlanframesync_create_pool(), number of slots must be greater than zero\n");
+        exit(1);
+    }
+
+    wlanframesync q = wlanframesync_create(_callback, _userdata);
+    wlanframesync_set_pool(q, wlanframesync_pool_create(_callback, _userdata, _num_threads, _num_slots));
+    return q;
+}
+
 // destroy WLAN framing synchronizer object
 void wlanframesync_destroy(wlanframesync _q)
 {
+    // deliver frames still being decoded and stop workers; a frame
+    // only partially captured is discarded
+    if (_q->pool != NULL) {
+        wlanframesync_reset(_q);
+        wlanframesync_pool_destroy(_q->pool);
+    }
+
 #if DEBUG_WLANFRAMESYNC
     // free debugging objects if necessary
     if (_q->agc_rx          != NULL) agc_crcf_destroy(_q->agc_rx);
@@ -189,6 +293,12 @@ void wlanframesync_destroy(wlanframesync _q)
     if (_q->debug_framesyms != NULL) windowcf_destroy(_q->debug_framesyms);
 #endif
 
+    // destroy front-end
+    if (_q->frontend != NULL) {
+        wlan_resamp_destroy(_q->frontend);
+        free(_q->frontend_buffer);
+    }
+
     // free transform object
     windowcf_destroy(_q->input_buffer);
     free(_q->X);
@@ -197,10 +307,9 @@ void wlanframesync_destroy(wlanframesync _q)
     
     // destroy synchronizer objects
     nco_crcf_destroy(_q->nco_rx);       // numerically-controlled oscillator
-    wlan_lfsr_destroy(_q->ms_pilot);    // pilot sequence generator
 
-    // free memory for encoded message
-    free(_q->msg_enc);
+    // destroy DATA field receiver
+    wlanframesync_rxdata_destroy(_q->rx);
 
     // free main object memory
     free(_q);
@@ -215,8 +324,16 @@ void wlanframesync_print(wlanframesync _q)
 // reset WLAN framing synchronizer object internal state
 void wlanframesync_reset(wlanframesync _q)
 {
-    // clear buffer
+    // return frame slot if capture was interrupted
+    if (_q->frame != NULL) {
+        wlanframesync_pool_cancel(_q->pool);
+        _q->frame = NULL;
+    }
+
+    // clear buffers
     windowcf_reset(_q->input_buffer);
+    if (_q->frontend != NULL)
+        wlan_resamp_reset(_q->frontend);
 
     // reset NCO object
     nco_crcf_reset(_q->nco_rx);
@@ -224,11 +341,142 @@ void wlanframesync_reset(wlanframesync _q)
     // reset timers/state
     _q->state = WLANFRAMESYNC_STATE_SEEKPLCP;
     _q->timer = 0;
-    _q->num_symbols = 0;    // number of received OFDM data symbols
     _q->phi_prime = 0.0f;   // reset phase offset estimate
+}
+
+// set input front-end: the input is mixed down by _fc and resampled by
+// _P/_Q to 20 MHz in a single pass before synchronization, e.g.
+// _P/_Q = 4/5 for 25 MS/s, 125/192 for 30.72 MS/s, 1/2 for 40 MS/s;
+// _P = _Q with _fc = 0 removes the front-end; resets the object
+//  _q      :   framing synchronizer object
+//  _P      :   interpolation factor, _P > 0
+//  _Q      :   decimation factor, _Q > 0
+//  _fc     :   channel center frequency relative to input sample rate, -0.5 <= _fc <= 0.5
+void wlanframesync_set_frontend(wlanframesync _q,
+                                unsigned int  _P,
+                                unsigned int  _Q,
+                                float         _fc)
+{
+    // validate input
+    if (_P == 0 || _Q == 0) {
+        fprintf(stderr,"error: wlanframesync_set_frontend(), resampling factors must be greater than zero\n");
+        exit(1);
+    } else if (_fc < -0.5f || _fc > 0.5f) {
+        fprintf(stderr,"error: wlanframesync_set_frontend(), center frequency must be in [-0.5,0.5]\n");
+        exit(1);
+    }
+
+    // remove existing front-end
+    if (_q->frontend != NULL) {
+        wlan_resamp_destroy(_q->frontend);
+        free(_q->frontend_buffer);
+        _q->frontend        = NULL;
+        _q->frontend_buffer = NULL;
+    }
+    _q->frontend_P     = 1;
+    _q->frontend_Q     = 1;
+    _q->frontend_delay = 0;
+
+    if (_P != _Q || _fc != 0.0f) {
+        // keep the transition band the same width in Hz: the filter
+        // length grows with the input rate
+        unsigned int m = WLANFRAMESYNC_FRONTEND_M;
+        if (_Q > _P)
+            m = (m*_Q + _P - 1) / _P;
+        _q->frontend = wlan_resamp_create(_P, _Q, m);
+        wlan_resamp_set_frequency(_q->frontend, _fc);
+        _q->frontend_P     = _P;
+        _q->frontend_Q     = _Q;
+        _q->frontend_delay = m;
+
+        // allocate output for a full block of input
+        unsigned int n = (WLANFRAMESYNC_FRONTEND_LEN*_P + _Q - 1) / _Q;
+        _q->frontend_buffer = (float complex*) malloc(n*sizeof(float complex));
+    }
+
+    wlanframesync_reset(_q);
+}
+
+// start synchronizer on a frame detected externally: the object is
+// reset, its input buffer filled, and reception continues with the
+// first 'short' sequence as though it had detected the frame itself
+//  _q      :   frame synchronizer object
+//  _x      :   last 80 input samples [size: 80 x 1]
+//  _g0     :   nominal gain estimate
+//  _timer  :   sample timer for first 'short' sequence
+void wlanframesync_prime(wlanframesync   _q,
+                         float complex * _x,
+                         float           _g0,
+                         unsigned int    _timer)
+{
+    wlanframesync_reset(_q);
+
+    unsigned int i;
+    for (i=0; i<80; i++)
+        windowcf_push(_q->input_buffer, _x[i]);
+
+    _q->g0    = _g0;
+    _q->timer = _timer;
+    _q->state = WLANFRAMESYNC_STATE_RXSHORT0;
+}
+
+// is synchronizer seeking a frame (not receiving one)?
+int wlanframesync_is_seeking(wlanframesync _q)
+{
+    return _q->state == WLANFRAMESYNC_STATE_SEEKPLCP;
+}
+
+// set notification of frames detected but not decoded (SIGNAL field
+// not valid), invoked with the synchronizer's user data
+void wlanframesync_set_reject_callback(wlanframesync                 _q,
+                                       wlanframesync_reject_callback _reject)
+{
+    _q->reject = _reject;
+}
 
-    // reset pilot sequence generator
-    wlan_lfsr_reset(_q->ms_pilot);
+// set index of next input sample, before the front-end if any (see
+// wlanframesync_get_frame_start_input()); baseband samples continue
+// from the corresponding index
+void wlanframesync_set_sample_index(wlanframesync     _q,
+                                    unsigned long int _index)
+{
+    _q->input_start    = _index;
+    _q->baseband_start = (_index * _q->frontend_P) / _q->frontend_Q;
+    _q->num_samples    = _q->baseband_start;
+}
+
+// get index of first input sample of most recent frame, before the
+// front-end if any, counting from wlanframesync_set_sample_index()
+unsigned long int wlanframesync_get_frame_start_input(wlanframesync _q)
+{
+    // map baseband samples back through the resampling ratio, rounding
+    // to nearest, and remove the front-end filter delay
+    long int n = ((long int)_q->frame_start - (long int)_q->baseband_start) * (long int)_q->frontend_Q;
+    long int d = n >= 0 ? (n + _q->frontend_P/2) / _q->frontend_P :
+                         -((-n + _q->frontend_P/2) / _q->frontend_P);
+    long int v = (long int)_q->input_start + d - (long int)_q->frontend_delay;
+    return v > 0 ? (unsigned long int)v : 0;
+}
+
+// get front-end resampling factors (1/1 if none)
+//  _q      :   frame synchronizer object
+//  _P      :   interpolation factor (output)
+//  _Q      :   decimation factor (output)
+void wlanframesync_get_frontend(wlanframesync  _q,
+                                unsigned int * _P,
+                                unsigned int * _Q)
+{
+    *_P = _q->frontend_P;
+    *_Q = _q->frontend_Q;
+}
+
+// block until every frame handed to the decoding pool has been decoded
+// and delivered to the callback; returns immediately if frames are
+// decoded inline
+void wlanframesync_flush(wlanframesync _q)
+{
+    if (_q->pool != NULL)
+        wlanframesync_pool_flush(_q->pool);
 }
 
 // execute framing synchronizer on input buffer
@@ -239,14 +487,114 @@ void wlanframesync_execute(wlanframesync          _q,
                            liquid_float_complex * _buffer,
                            unsigned int           _n)
 {
-    unsigned int i;
+    if (_q->frontend == NULL) {
+        wlanframesync_execute_baseband(_q, _buffer, _n);
+        return;
+    }
+
+    // mix and resample in blocks small enough that the 20 MHz output
+    // is synchronized while still in cache
+    unsigned int n = 0;
+    while (n < _n) {
+        unsigned int k = _n - n < WLANFRAMESYNC_FRONTEND_LEN ? _n - n : WLANFRAMESYNC_FRONTEND_LEN;
+        unsigned int ny;
+        wlan_resamp_execute(_q->frontend, &_buffer[n], k, _q->frontend_buffer, &ny);
+        wlanframesync_execute_baseband(_q, _q->frontend_buffer, ny);
+        n += k;
+    }
+}
+
+// execute framing synchronizer on interleaved int16 I/Q input
+//  _q      :   framing synchronizer object
+//  _buffer :   input I/Q buffer [size: 2*_n x 1]
+//  _n      :   number of input samples
+void wlanframesync_execute_sc16(wlanframesync _q,
+                                int16_t *     _buffer,
+                                unsigned int  _n)
+{
+    // convert in blocks small enough to remain in cache
+    float complex buffer[WLANFRAMESYNC_CONVERT_LEN];
+    unsigned int n = 0;
+    while (n < _n) {
+        unsigned int k = _n - n < WLANFRAMESYNC_CONVERT_LEN ? _n - n : WLANFRAMESYNC_CONVERT_LEN;
+        liquid_wlan_sc16_to_cf(&_buffer[2*n], k, 1.0f/32768.0f, buffer);
+        wlanframesync_execute(_q, buffer, k);
+        n += k;
+    }
+}
+
+// execute framing synchronizer on interleaved int8 I/Q input
+//  _q      :   framing synchronizer object
+//  _buffer :   input I/Q buffer [size: 2*_n x 1]
+//  _n      :   number of input samples
+void wlanframesync_execute_sc8(wlanframesync _q,
+                               int8_t *      _buffer,
+                               unsigned int  _n)
+{
+    // convert in blocks small enough to remain in cache
+    float complex buffer[WLANFRAMESYNC_CONVERT_LEN];
+    unsigned int n = 0;
+    while (n < _n) {
+        unsigned int k = _n - n < WLANFRAMESYNC_CONVERT_LEN ? _n - n : WLANFRAMESYNC_CONVERT_LEN;
+        liquid_wlan_sc8_to_cf(&_buffer[2*n], k, 1.0f/128.0f, buffer);
+        wlanframesync_execute(_q, buffer, k);
+        n += k;
+    }
+}
+
+// get received signal strength of most recent frame [dB]
+float wlanframesync_get_rssi(wlanframesync _q)
+{
+    return _q->rssi;
+}
+
+// get carrier frequency offset estimate of most recent frame
+float wlanframesync_get_cfo(wlanframesync _q)
+{
+    return _q->cfo;
+}
+
+// get index of first sample of most recent frame
+unsigned long int wlanframesync_get_frame_start(wlanframesync _q)
+{
+    return _q->frame_start;
+}
+
+
+//
+// internal methods
+//
+
+// execute framing synchronizer on 20 MHz baseband samples, after the
+// front-end (if any)
+//  _q      :   frame synchronizer object
+//  _buffer :   input samples [size: _n x 1]
+//  _n      :   number of input samples
+void wlanframesync_execute_baseband(wlanframesync   _q,
+                                    float complex * _buffer,
+                                    unsigned int    _n)
+{
+    unsigned int i = 0;
     float complex x;
-    for (i=0; i<_n; i++) {
-        x = _buffer[i];
+    while (i < _n) {
+        // capture DATA field for decoding pool in bulk; the carrier
+        // offset is corrected by the worker
+        if (_q->state == WLANFRAMESYNC_STATE_RXSPAN) {
+            unsigned int k = wlanframesync_execute_rxspan(_q, &_buffer[i], _n - i);
+            _q->num_samples += k;
+            i += k;
+            continue;
+        }
+
+        x = _buffer[i++];
+        _q->num_samples++;
 
         // correct for carrier frequency offset (only if not in
-        // initial 'seek PLCP' state)
-        if (_q->state != WLANFRAMESYNC_STATE_SEEKPLCP) {
+        // initial 'seek PLCP' state); DATA symbols are corrected by
+        // the receiver which also tracks the residual offset
+        if (_q->state != WLANFRAMESYNC_STATE_SEEKPLCP &&
+            _q->state != WLANFRAMESYNC_STATE_RXDATA)
+        {
             nco_crcf_mix_down(_q->nco_rx, x, &x);
             nco_crcf_step(_q->nco_rx);
         }
@@ -289,29 +637,12 @@ void wlanframesync_execute(wlanframesync          _q,
             break;
         default:;
             // should never get to this point
-            fprintf(stderr,"error: wlanframesync_execute(), invalid state\n");
+            fprintf(stderr,"error: wlanframesync_execute_baseband(), invalid state\n");
             exit(1);
         }
-    } // for (i=0; i<_n; i++)
-}
-
-// get receiver RSSI
-float wlanframesync_get_rssi(wlanframesync _q)
-{
-    return 0.0f;
-}
-
-// get receiver carrier frequency offset estimate
-float wlanframesync_get_cfo(wlanframesync _q)
-{
-    return 0.0f;
+    } // while (i < _n)
 }
 
-
-//
-// internal methods
-//
-
 // frame detection
 void wlanframesync_execute_seekplcp(wlanframesync _q)
 {
@@ -341,7 +672,7 @@ void wlanframesync_execute_seekplcp(wlanframesync _q)
     }
     g = 64.0f / (g + 1e-12f);
     
-    // save gain (permits dynamic invocation of get_rssi() method)
+    // save gain, latched as signal strength once SIGNAL field decodes
     _q->g0 = g;
 
     // estimate S0 gain
@@ -627,7 +958,7 @@ void wlanframesync_execute_rxsignal(wlanframesync _q)
     FFT_EXECUTE(_q->fft);
   
     // recover symbol, correcting for gain, pilot phase, etc.
-    wlanframesync_rxsymbol(_q);
+    wlanframesync_rxsymbol(_q->X, _q->R, 0, &_q->phi_prime);
     
     // demodulate, decode, ...
     memset(_q->signal_int, 0x00, 6*sizeof(unsigned char));
@@ -689,15 +1020,52 @@ void wlanframesync_execute_rxsignal(wlanframesync _q)
     // decode SIGNAL field
     wlanframesync_decode_signal(_q);
 
+    // SIGNAL field ends with this sample, after the 320-sample preamble
+    _q->frame_start = _q->num_samples - 400;
+    _q->cfo         = nco_crcf_get_frequency(_q->nco_rx);
+    _q->rssi        = -10.0f*log10f(_q->g0);
+
     // validate proper decoding
     if (!_q->signal_valid) {
-        // reset synchronizer and return
+        // notify, reset synchronizer and return
+        if (_q->reject != NULL)
+            _q->reject(_q->userdata);
         wlanframesync_reset(_q);
         return;
     }
 
-    // set state
-    _q->state = WLANFRAMESYNC_STATE_RXDATA;
+    // DATA field starts with the next sample: hand the channel and
+    // carrier estimates to the receiver
+    float nu    = nco_crcf_get_frequency(_q->nco_rx);
+    float theta = nco_crcf_get_phase(_q->nco_rx);
+    unsigned int rssi = 200 + (unsigned int) (10*log10f(_q->g0));
+    if (_q->pool == NULL) {
+        wlanframesync_rxdata_init(_q->rx, _q->rate, _q->seed, _q->length, rssi,
+                                  _q->R, _q->phi_prime, nu, theta);
+        _q->state = WLANFRAMESYNC_STATE_RXDATA;
+        return;
+    }
+
+    // acquire frame slot, blocking while all slots are being decoded
+    struct wlanframesync_pool_frame_s * frame = wlanframesync_pool_acquire(_q->pool);
+    frame->rate      = _q->rate;
+    frame->seed      = _q->seed;
+    frame->length    = _q->length;
+    frame->rssi      = rssi;
+    frame->phi_prime = _q->phi_prime;
+    frame->nu        = nu;
+    frame->theta     = theta;
+    memmove(frame->R, _q->R, 64*sizeof(float complex));
+
+    // re-allocate sample buffer as needed
+    frame->num_samples = 0;
+    frame->span_len    = 80*_q->nsym;
+    if (frame->span_len > frame->span_alloc) {
+        frame->span_alloc = frame->span_len;
+        frame->span = (float complex*) realloc(frame->span, frame->span_alloc*sizeof(float complex));
+    }
+    _q->frame = frame;
+    _q->state = WLANFRAMESYNC_STATE_RXSPAN;
 }
 
 // receive data symbols
@@ -707,76 +1075,30 @@ void wlanframesync_execute_rxdata(wlanframesync _q)
     if (_q->timer < 80)
         return;
 
-    //printf("    receiving symbol %u...\n", _q->num_symbols);
-
     // reset timer
     _q->timer = 0;
 
-    // run fft
+    // receive symbol
     float complex * rc;
     windowcf_read(_q->input_buffer, &rc);
-    memmove(_q->x, &rc[16-2], 64*sizeof(float complex));
-
-    // compute fft, storing result into _q->X
-    FFT_EXECUTE(_q->fft);
-  
-    // recover symbol, correcting for gain, pilot phase, etc.
-    wlanframesync_rxsymbol(_q);
-   
-    // demodulate and pack
-    unsigned int i;
-    unsigned int n=0;
-    unsigned int sym;
-    for (i=0; i<64; i++) {
-        unsigned int k = (i + 32) % 64;
-
-        if ( k==0 || (k > 26 && k < 38) ) {
-            // NULL subcarrier
-        } else if (k==43 || k==57 || k==7 || k==21) {
-            // PILOT subcarrier
-        } else {
-            // DATA subcarrier
-            assert(n<48);
-            sym = wlan_demodulate(_q->mod_scheme, _q->X[k]);
-            _q->modem_syms[n] = sym;
-            n++;
+    int complete = wlanframesync_rxdata_execute(_q->rx, rc);
 #if DEBUG_WLANFRAMESYNC
-            // TODO : move this outside loop
-            if (_q->debug_enabled)
-                windowcf_push(_q->debug_framesyms, _q->X[k]);
-#endif
-
-        }
+    if (_q->debug_enabled) {
+        unsigned int i;
+        for (i=0; i<48; i++)
+            windowcf_push(_q->debug_framesyms, _q->rx->syms[i]);
     }
-    assert(n==48);
-
-    // pack modem symbols
-    //printf("  %3u = %3u * %3u\n", _q->enc_msg_len, _q->nsym, _q->bytes_per_symbol);
-    unsigned int num_written;
-    liquid_wlan_repack_bytes(_q->modem_syms, _q->nbpsc, 48,
-                             &_q->msg_enc[_q->num_symbols * _q->bytes_per_symbol], 8, _q->bytes_per_symbol,
-                             &num_written);
-    assert(num_written == _q->bytes_per_symbol);
-
-    // increment number of received symbols
-    _q->num_symbols++;
+#endif
 
-    // check number of symbols
-    if (_q->num_symbols == _q->nsym) {
+    if (complete) {
         // decode message
-        wlan_packet_decode(_q->rate, _q->seed, _q->length, _q->msg_enc, _q->msg_dec);
-
-        // assemble RX vector
         struct wlan_rxvector_s rxvector;
-        rxvector.LENGTH     = _q->length;
-        rxvector.RSSI       = 200 + (unsigned int) (10*log10f(_q->g0));
-        rxvector.DATARATE   = _q->rate;
-        rxvector.SERVICE    = 0;
+        unsigned char * msg_dec = wlanframesync_rxdata_decode(_q->rx, &rxvector);
 
         // invoke callback
         if (_q->callback != NULL) {
             //int retval = 
-            _q->callback(_q->msg_dec, rxvector, _q->userdata);
+            _q->callback(msg_dec, rxvector, _q->userdata);
         }
 
         // reset and return
@@ -784,6 +1106,31 @@ void wlanframesync_execute_rxdata(wlanframesync _q)
     }
 }
 
+// capture DATA field samples for the decoding pool, returning the
+// number of samples consumed
+//  _q      :   frame synchronizer object
+//  _x      :   input samples [size: _n x 1]
+//  _n      :   number of input samples
+unsigned int wlanframesync_execute_rxspan(wlanframesync   _q,
+                                          float complex * _x,
+                                          unsigned int    _n)
+{
+    struct wlanframesync_pool_frame_s * frame = _q->frame;
+    unsigned int k = frame->span_len - frame->num_samples;
+    if (k > _n)
+        k = _n;
+    memmove(&frame->span[frame->num_samples], _x, k*sizeof(float complex));
+    frame->num_samples += k;
+
+    if (frame->num_samples == frame->span_len) {
+        // release frame to workers and resume detection
+        _q->frame = NULL;
+        wlanframesync_pool_submit(_q->pool);
+        wlanframesync_reset(_q);
+    }
+    return k;
+}
+
 // estimate short sequence gain
 //  _q      :   wlanframesync object
 //  _x      :   input array (time), [size: M x 1]
@@ -1034,26 +1381,30 @@ void wlanframesync_estimate_eqgain_poly(wlanframesync _q)
 
 }
 
-// recover symbol, correcting for gain, pilot phase, etc.
-void wlanframesync_rxsymbol(wlanframesync _q)
+// recover symbol, correcting for gain, pilot phase, etc., returning the
+// pilot phase difference relative to the previous symbol
+float wlanframesync_rxsymbol(float complex *       _X,
+                             const float complex * _R,
+                             unsigned int          _n,
+                             float *               _phi_prime)
 {
     // apply gain
     unsigned int i;
     for (i=0; i<64; i++)
-        _q->X[i] *= _q->R[i];
+        _X[i] *= _R[i];
 
     // polynomial curve-fit
     float x_phase[4] = {-21.0f, -7.0f, 7.0f, 21.0f};
     float y_phase[4];
     float p_phase[2];
 
-    // update pilot phase
-    unsigned int pilot_phase = wlan_lfsr_advance(_q->ms_pilot);
+    // pilot phase
+    unsigned int pilot_phase = wlanframe_pilot_polarity[_n % WLANFRAME_PILOT_PERIOD];
 
-    y_phase[0] = pilot_phase ? cargf(-_q->X[43]) : cargf( _q->X[43]);
-    y_phase[1] = pilot_phase ? cargf(-_q->X[57]) : cargf( _q->X[57]);
-    y_phase[2] = pilot_phase ? cargf(-_q->X[ 7]) : cargf( _q->X[ 7]);
-    y_phase[3] = pilot_phase ? cargf( _q->X[21]) : cargf(-_q->X[21]);
+    y_phase[0] = pilot_phase ? cargf(-_X[43]) : cargf( _X[43]);
+    y_phase[1] = pilot_phase ? cargf(-_X[57]) : cargf( _X[57]);
+    y_phase[2] = pilot_phase ? cargf(-_X[ 7]) : cargf( _X[ 7]);
+    y_phase[3] = pilot_phase ? cargf( _X[21]) : cargf(-_X[21]);
 
     // unwrap phase
     if ( (y_phase[1]-y_phase[0]) >  M_PI ) y_phase[1] -= 2*M_PI;
@@ -1077,21 +1428,17 @@ void wlanframesync_rxsymbol(wlanframesync _q)
     for (i=0; i<64; i++) {
         float fx    = (i > 31) ? (float)i - (float)(64) : (float)i;
         float theta = polyf_val(p_phase, 2, fx);
-        _q->X[i] *= cexpf(-_Complex_I*theta);
+        _X[i] *= cexpf(-_Complex_I*theta);
     }
 
-    // adjust NCO frequency based on differential phase
-    if (_q->num_symbols > 0) {
-        // compute phase error (unwrapped)
-        float dphi_prime = p_phase[0] - _q->phi_prime;
-        if (dphi_prime >  M_PI) dphi_prime -= M_2_PI;
-        if (dphi_prime < -M_PI) dphi_prime += M_2_PI;
+    // compute phase error (unwrapped)
+    float dphi_prime = p_phase[0] - *_phi_prime;
+    if (dphi_prime >  M_PI) dphi_prime -= M_2_PI;
+    if (dphi_prime < -M_PI) dphi_prime += M_2_PI;
 
-        // adjust NCO proportionally to phase error
-        nco_crcf_adjust_frequency(_q->nco_rx, 1e-3f*dphi_prime);
-    }
     // set internal phase state
-    _q->phi_prime = p_phase[0];
+    *_phi_prime = p_phase[0];
+    return dphi_prime;
 }
 
 void wlanframesync_decode_signal(wlanframesync _q)
@@ -1138,28 +1485,6 @@ void wlanframesync_decode_signal(wlanframesync _q)
     // compute number of pad bits
     _q->npad = _q->ndata - (16 + 8*_q->length + 6);
 
-    // compute decoded message length (number of data bytes)
-    // NOTE : because ndbps is _always_ divisible by 8, so must ndata be
-    _q->dec_msg_len = _q->ndata / 8;
-
-    // re-allocate buffer for decoded message
-    _q->msg_dec = (unsigned char*) realloc(_q->msg_dec, _q->dec_msg_len*sizeof(unsigned char));
-
-    // compute encoded message length (number of data bytes)
-    _q->enc_msg_len = (_q->dec_msg_len * _q->ncbps) / _q->ndbps;
-
-    // compute number of encoded data bytes per OFDM symbol
-    _q->bytes_per_symbol = _q->enc_msg_len / _q->nsym;
-
-    // validate encoded message length
-    //assert(_q->enc_msg_len == wlan_packet_compute_enc_msg_len(_q->rate, _q->length));
-
-    // re-allocate buffer for encoded message
-    _q->msg_enc = (unsigned char*) realloc(_q->msg_enc, _q->enc_msg_len*sizeof(unsigned char));
-
-    // re-create modem object
-    _q->mod_scheme = wlanframe_ratetab[_q->rate].mod_scheme;
-
 #if DEBUG_WLANFRAMESYNC_PRINT
     // print properties
     printf("    signal int  :   [%.2x %.2x %.2x %.2x %.2x %.2x]\n",
@@ -1185,6 +1510,172 @@ void wlanframesync_decode_signal(wlanframesync _q)
 #endif
 }
 
+// hand DATA fields to a decoding pool, which is then owned (and
+// destroyed) by the synchronizer
+void wlanframesync_set_pool(wlanframesync      _q,
+                            wlanframesync_pool _pool)
+{
+    if (_q->pool != NULL) {
+        fprintf(stderr,"error: wlanframesync_set_pool(), decoding pool already set\n");
+        exit(1);
+    }
+    _q->pool = _pool;
+}
+
+//
+// DATA field receiver
+//
+
+// create DATA field receiver
+wlanframesync_rxdata wlanframesync_rxdata_create()
+{
+    wlanframesync_rxdata q = (wlanframesync_rxdata) malloc(sizeof(struct wlanframesync_rxdata_s));
+
+    // create transform object
+    q->X = (float complex*) malloc(64*sizeof(float complex));
+    q->x = (float complex*) malloc(64*sizeof(float complex));
+    q->fft = FFT_CREATE_PLAN(64, q->x, q->X, FFT_DIR_FORWARD, FFT_METHOD);
+
+    q->nco = nco_crcf_create(LIQUID_VCO);
+
+    // buffers are allocated for the first frame
+    q->msg_enc   = NULL;
+    q->msg_dec   = NULL;
+    q->enc_alloc = 0;
+    q->dec_alloc = 0;
+    return q;
+}
+
+// destroy DATA field receiver
+void wlanframesync_rxdata_destroy(wlanframesync_rxdata _q)
+{
+    free(_q->X);
+    free(_q->x);
+    FFT_DESTROY_PLAN(_q->fft);
+    nco_crcf_destroy(_q->nco);
+    free(_q->msg_enc);
+    free(_q->msg_dec);
+    free(_q);
+}
+
+// initialize DATA field receiver for a new frame
+void wlanframesync_rxdata_init(wlanframesync_rxdata  _q,
+                               unsigned int          _rate,
+                               unsigned int          _seed,
+                               unsigned int          _length,
+                               unsigned int          _rssi,
+                               const float complex * _R,
+                               float                 _phi_prime,
+                               float                 _nu,
+                               float                 _theta)
+{
+    _q->rate   = _rate;
+    _q->seed   = _seed;
+    _q->length = _length;
+    _q->rssi   = _rssi;
+
+    // carrier and channel correction
+    nco_crcf_reset(_q->nco);
+    nco_crcf_set_frequency(_q->nco, _nu);
+    nco_crcf_set_phase(_q->nco, _theta);
+    memmove(_q->R, _R, 64*sizeof(float complex));
+    _q->phi_prime = _phi_prime;
+
+    // compute frame parameters
+    _q->mod_scheme       = wlanframe_ratetab[_rate].mod_scheme;
+    _q->nbpsc            = wlanframe_ratetab[_rate].nbpsc;
+    _q->bytes_per_symbol = wlanframe_ratetab[_rate].ncbps / 8;
+    _q->num_symbols      = 0;
+
+    // re-allocate buffers as needed
+    unsigned int enc_msg_len = wlan_packet_compute_enc_msg_len(_rate, _length);
+    _q->nsym = enc_msg_len / _q->bytes_per_symbol;
+    if (enc_msg_len > _q->enc_alloc) {
+        _q->enc_alloc = enc_msg_len;
+        _q->msg_enc = (unsigned char*) realloc(_q->msg_enc, _q->enc_alloc*sizeof(unsigned char));
+    }
+    if (_length > _q->dec_alloc) {
+        _q->dec_alloc = _length;
+        _q->msg_dec = (unsigned char*) realloc(_q->msg_dec, _q->dec_alloc*sizeof(unsigned char));
+    }
+}
+
+// receive DATA symbol, returning 1 once every symbol has been received
+//  _q      :   DATA field receiver
+//  _x      :   symbol samples, cyclic prefix first [size: 80 x 1]
+int wlanframesync_rxdata_execute(wlanframesync_rxdata _q,
+                                 float complex *      _x)
+{
+    // correct carrier offset over entire symbol, keeping transform
+    // input (with timing backoff)
+    unsigned int i;
+    float complex y;
+    for (i=0; i<80; i++) {
+        nco_crcf_mix_down(_q->nco, _x[i], &y);
+        nco_crcf_step(_q->nco);
+        if (i >= 16-2 && i < 80-2)
+            _q->x[i-(16-2)] = y;
+    }
+
+    // compute fft, storing result into _q->X
+    FFT_EXECUTE(_q->fft);
+
+    // receive symbol and adjust NCO proportionally to phase error
+    float dphi;
+    int complete = wlanframesync_rxdata_execute_freq(_q, _q->X, &dphi);
+    if (_q->num_symbols > 1)
+        nco_crcf_adjust_frequency(_q->nco, 1e-3f*dphi);
+    return complete;
+}
+
+// receive transformed DATA symbol, after carrier offset correction,
+// returning 1 once every symbol has been received
+//  _q      :   DATA field receiver
+//  _X      :   frequency-domain symbol, corrected in place [size: 64 x 1]
+//  _dphi   :   pilot phase difference relative to previous symbol (output)
+int wlanframesync_rxdata_execute_freq(wlanframesync_rxdata _q,
+                                      float complex *      _X,
+                                      float *              _dphi)
+{
+    // recover symbol, correcting for gain, pilot phase, etc.
+    *_dphi = wlanframesync_rxsymbol(_X, _q->R, _q->num_symbols+1, &_q->phi_prime);
+
+    // gather DATA subcarriers and demodulate
+    unsigned int i;
+    for (i=0; i<48; i++)
+        _q->syms[i] = _X[wlanframe_data_subcarriers[i]];
+    wlan_demodulate_block(_q->mod_scheme, _q->syms, 48, _q->modem_syms);
+
+    // pack modem symbols
+    unsigned int num_written;
+    liquid_wlan_repack_bytes(_q->modem_syms, _q->nbpsc, 48,
+                             &_q->msg_enc[_q->num_symbols * _q->bytes_per_symbol], 8, _q->bytes_per_symbol,
+                             &num_written);
+    assert(num_written == _q->bytes_per_symbol);
+
+    // increment number of received symbols
+    _q->num_symbols++;
+    return _q->num_symbols == _q->nsym;
+}
+
+// decode received DATA field, returning the payload (valid until the
+// receiver is next initialized)
+//  _q          :   DATA field receiver
+//  _rxvector   :   received vector (output)
+unsigned char * wlanframesync_rxdata_decode(wlanframesync_rxdata     _q,
+                                            struct wlan_rxvector_s * _rxvector)
+{
+    // decode message
+    wlan_packet_decode(_q->rate, _q->seed, _q->length, _q->msg_enc, _q->msg_dec);
+
+    // assemble RX vector
+    _rxvector->LENGTH   = _q->length;
+    _rxvector->RSSI     = _q->rssi;
+    _rxvector->DATARATE = _q->rate;
+    _rxvector->SERVICE  = 0;
+    return _q->msg_dec;
+}
+
 void wlanframesync_debug_enable(wlanframesync _q)
 {
     // create debugging objects if necessary
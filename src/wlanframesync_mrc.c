@@ -0,0 +1,574 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanframesync_mrc.c
+//
+// Multi-antenna frame synchronizer with receive diversity: frame
+// detection, timing and carrier offset estimation accumulate their
+// statistics over every antenna, the channel is estimated separately
+// for each antenna, and subcarriers are combined by maximum-ratio
+// combining before demapping:
+//
+//   Y(k) = sum_a W_a(k) X_a(k),  W_a(k) = conj(G_a(k)) / sum_b |G_b(k)|^2
+//
+// The antennas are assumed to share a local oscillator, so a single
+// carrier offset is estimated and tracked.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "liquid-wlan.internal.h"
+
+// thresholds (see wlanframesync.c)
+#define WLANFRAMESYNC_MRC_S0A_ABS_THRESH    (0.4f)
+#define WLANFRAMESYNC_MRC_S1A_ABS_THRESH    (0.5f)
+#define WLANFRAMESYNC_MRC_S1A_ARG_THRESH    (0.2f)
+#define WLANFRAMESYNC_MRC_S1B_ABS_THRESH    (0.5f)
+#define WLANFRAMESYNC_MRC_S1B_ARG_THRESH    (0.2f)
+
+struct wlanframesync_mrc_s {
+    // callback
+    wlanframesync_callback callback;
+    void * userdata;
+
+    unsigned int num_antennas;  // number of antennas
+
+    // transform object
+    FFT_PLAN fft;               // fft object
+    float complex * X;          // frequency-domain buffer
+    float complex * x;          // time-domain buffer
+    windowcf * input_buffer;    // input sequence buffer for each antenna
+
+    // synchronizer objects
+    nco_crcf nco_rx;            // carrier offset, common to all antennas
+    float phi_prime;            // stored pilot phase
+
+    // gain arrays for each antenna [size: num_antennas x 64]
+    float g0;                   // nominal gain, over all antennas
+    float complex * G0a;        // complex channel gain (first 'short' sequence)
+    float complex * G0b;        // complex channel gain (second 'short' sequence)
+    float complex * G1a;        // complex channel gain (first 'long' sequence)
+    float complex * G1b;        // complex channel gain (second 'long' sequence)
+    float complex * W;          // combining weights
+    float complex * Xa;         // transformed symbol
+
+    // combined symbol
+    float complex Y[64];        // combined subcarriers
+    float complex R[64];        // residual correction (unity)
+
+    // SIGNAL field
+    unsigned char signal_int[6];    // interleaved message
+    unsigned char signal_enc[6];    // encoded message
+    unsigned char signal_dec[3];    // decoded message
+    unsigned int rate;              // primitive data rate
+    unsigned int length;            // original data length (bytes)
+    unsigned int seed;              // data scrambler seed
+
+    // DATA field
+    wlanframesync_rxdata rx;        // DATA field receiver
+    unsigned int num_symbols;       // number of received DATA symbols
+
+    // counters/states
+    enum {
+        WLANFRAMESYNC_MRC_STATE_SEEKPLCP=0, // seek initial PLCP
+        WLANFRAMESYNC_MRC_STATE_RXSHORT0,   // receive first 'short' sequence
+        WLANFRAMESYNC_MRC_STATE_RXSHORT1,   // receive second 'short' sequence
+        WLANFRAMESYNC_MRC_STATE_RXLONG0,    // receive first 'long' sequence
+        WLANFRAMESYNC_MRC_STATE_RXLONG1,    // receive second 'long' sequence
+        WLANFRAMESYNC_MRC_STATE_RXSIGNAL,   // receive SIGNAL field
+        WLANFRAMESYNC_MRC_STATE_RXDATA,     // receive DATA field
+    } state;
+    signed int timer;                       // sample timer
+};
+
+// create multi-antenna frame synchronizer
+//  _num_antennas   :   number of antennas, _num_antennas > 0
+//  _callback       :   user-defined callback function
+//  _userdata       :   user-defined data structure
+wlanframesync_mrc wlanframesync_mrc_create(unsigned int           _num_antennas,
+                                           wlanframesync_callback _callback,
+                                           void *                 _userdata)
+{
+    // validate input
+    if (_num_antennas == 0) {
+        fprintf(stderr,"error: wlanframesync_mrc_create(), number of antennas must be greater than zero\n");
+        exit(1);
+    }
+
+    wlanframesync_mrc q = (wlanframesync_mrc) malloc(sizeof(struct wlanframesync_mrc_s));
+    q->num_antennas = _num_antennas;
+    q->callback     = _callback;
+    q->userdata     = _userdata;
+
+    // create transform object
+    q->X = (float complex*) malloc(64*sizeof(float complex));
+    q->x = (float complex*) malloc(64*sizeof(float complex));
+    q->fft = FFT_CREATE_PLAN(64, q->x, q->X, FFT_DIR_FORWARD, FFT_METHOD);
+
+    // create input buffers and gain arrays
+    unsigned int i;
+    unsigned int n = q->num_antennas*64;
+    q->input_buffer = (windowcf*) malloc(q->num_antennas*sizeof(windowcf));
+    for (i=0; i<q->num_antennas; i++)
+        q->input_buffer[i] = windowcf_create(80);
+    q->G0a = (float complex*) malloc(n*sizeof(float complex));
+    q->G0b = (float complex*) malloc(n*sizeof(float complex));
+    q->G1a = (float complex*) malloc(n*sizeof(float complex));
+    q->G1b = (float complex*) malloc(n*sizeof(float complex));
+    q->W   = (float complex*) calloc(n, sizeof(float complex));
+    q->Xa  = (float complex*) malloc(n*sizeof(float complex));
+
+    // channel is corrected by the combining weights
+    for (i=0; i<64; i++)
+        q->R[i] = 1.0f;
+
+    // synchronizer objects
+    q->nco_rx = nco_crcf_create(LIQUID_VCO);
+    q->rx     = wlanframesync_rxdata_create();
+    q->seed   = 0x5d;
+
+    // reset object
+    wlanframesync_mrc_reset(q);
+
+    return q;
+}
+
+// destroy multi-antenna frame synchronizer
+void wlanframesync_mrc_destroy(wlanframesync_mrc _q)
+{
+    unsigned int i;
+    for (i=0; i<_q->num_antennas; i++)
+        windowcf_destroy(_q->input_buffer[i]);
+    free(_q->input_buffer);
+    free(_q->G0a);
+    free(_q->G0b);
+    free(_q->G1a);
+    free(_q->G1b);
+    free(_q->W);
+    free(_q->Xa);
+    free(_q->X);
+    free(_q->x);
+    FFT_DESTROY_PLAN(_q->fft);
+    nco_crcf_destroy(_q->nco_rx);
+    wlanframesync_rxdata_destroy(_q->rx);
+    free(_q);
+}
+
+// print multi-antenna frame synchronizer object internals
+void wlanframesync_mrc_print(wlanframesync_mrc _q)
+{
+    printf("wlanframesync_mrc:\n");
+    printf("    antennas    :   %u\n", _q->num_antennas);
+}
+
+// reset multi-antenna frame synchronizer object internal state
+void wlanframesync_mrc_reset(wlanframesync_mrc _q)
+{
+    unsigned int i;
+    for (i=0; i<_q->num_antennas; i++)
+        windowcf_reset(_q->input_buffer[i]);
+    nco_crcf_reset(_q->nco_rx);
+
+    _q->state     = WLANFRAMESYNC_MRC_STATE_SEEKPLCP;
+    _q->timer     = 0;
+    _q->phi_prime = 0.0f;
+}
+
+// execute multi-antenna frame synchronizer on the same number of
+// samples from every antenna
+//  _q      :   multi-antenna frame synchronizer object
+//  _x      :   input for each antenna [size: _num_antennas x _n]
+//  _n      :   number of input samples per antenna
+void wlanframesync_mrc_execute(wlanframesync_mrc       _q,
+                               liquid_float_complex ** _x,
+                               unsigned int            _n)
+{
+    unsigned int i, a;
+    float complex x;
+    for (i=0; i<_n; i++) {
+        // correct for carrier frequency offset (only while receiving
+        // the preamble and SIGNAL field); DATA symbols are corrected as
+        // they are received
+        int mix = _q->state != WLANFRAMESYNC_MRC_STATE_SEEKPLCP &&
+                  _q->state != WLANFRAMESYNC_MRC_STATE_RXDATA;
+        for (a=0; a<_q->num_antennas; a++) {
+            x = _x[a][i];
+            if (mix)
+                nco_crcf_mix_down(_q->nco_rx, x, &x);
+            windowcf_push(_q->input_buffer[a], x);
+        }
+        if (mix)
+            nco_crcf_step(_q->nco_rx);
+
+        switch (_q->state) {
+        case WLANFRAMESYNC_MRC_STATE_SEEKPLCP:
+            wlanframesync_mrc_execute_seekplcp(_q);
+            break;
+        case WLANFRAMESYNC_MRC_STATE_RXSHORT0:
+            wlanframesync_mrc_execute_rxshort(_q, _q->G0a);
+            break;
+        case WLANFRAMESYNC_MRC_STATE_RXSHORT1:
+            wlanframesync_mrc_execute_rxshort(_q, _q->G0b);
+            break;
+        case WLANFRAMESYNC_MRC_STATE_RXLONG0:
+            wlanframesync_mrc_execute_rxlong0(_q);
+            break;
+        case WLANFRAMESYNC_MRC_STATE_RXLONG1:
+            wlanframesync_mrc_execute_rxlong1(_q);
+            break;
+        case WLANFRAMESYNC_MRC_STATE_RXSIGNAL:
+            wlanframesync_mrc_execute_rxsignal(_q);
+            break;
+        case WLANFRAMESYNC_MRC_STATE_RXDATA:
+            wlanframesync_mrc_execute_rxdata(_q);
+            break;
+        default:;
+            // should never get to this point
+            fprintf(stderr,"error: wlanframesync_mrc_execute(), invalid state\n");
+            exit(1);
+        }
+    }
+}
+
+//
+// internal methods
+//
+
+// transform 64 samples of each antenna's input buffer
+//  _q      :   multi-antenna frame synchronizer object
+//  _offset :   index of first sample in input buffer
+void wlanframesync_mrc_transform(wlanframesync_mrc _q,
+                                 unsigned int      _offset)
+{
+    unsigned int a;
+    float complex * rc;
+    for (a=0; a<_q->num_antennas; a++) {
+        windowcf_read(_q->input_buffer[a], &rc);
+        memmove(_q->x, &rc[_offset], 64*sizeof(float complex));
+        FFT_EXECUTE(_q->fft);
+        memmove(&_q->Xa[a*64], _q->X, 64*sizeof(float complex));
+    }
+}
+
+// estimate 'short' sequence gains of each antenna from transformed
+// input, and return detection metric accumulated over antennas (see
+// wlanframesync_S0_metrics())
+//  _q      :   multi-antenna frame synchronizer object
+//  _G      :   gains [size: _num_antennas x 64]
+float complex wlanframesync_mrc_S0_metrics(wlanframesync_mrc _q,
+                                           float complex *   _G)
+{
+    float gain = 0.054127f; // sqrt(12)/64
+    float complex s_hat = 0.0f;
+    unsigned int a, k;
+    for (a=0; a<_q->num_antennas; a++) {
+        float complex * G = &_G[a*64];
+        float complex * X = &_q->Xa[a*64];
+        for (k=0; k<64; k++)
+            G[k] = (k % 4) == 0 && k != 0 && (k < 27 || k > 37) ? X[k] * conjf(wlanframe_S0[k]) * gain : 0.0f;
+
+        // accumulate phase difference across adjacent pilot subcarriers
+        for (k=40; k<60; k+=4)
+            s_hat += G[k+4] * conjf(G[k]);
+        for (k=4; k<24; k+=4)
+            s_hat += G[k+4] * conjf(G[k]);
+    }
+    return s_hat * 0.1f;
+}
+
+// estimate 'long' sequence gains of each antenna from transformed
+// input, and return timing metric accumulated over antennas (see
+// wlanframesync_S1_metrics())
+//  _q      :   multi-antenna frame synchronizer object
+//  _G      :   gains [size: _num_antennas x 64]
+float complex wlanframesync_mrc_S1_metrics(wlanframesync_mrc _q,
+                                           float complex *   _G)
+{
+    float gain = 0.11267f; // sqrt(52)/64
+    float complex s_hat = 0.0f;
+    unsigned int a, k;
+    for (a=0; a<_q->num_antennas; a++) {
+        float complex * G = &_G[a*64];
+        float complex * X = &_q->Xa[a*64];
+        for (k=0; k<64; k++)
+            G[k] = k == 0 || (k > 26 && k < 38) ? 0.0f : X[k] * conjf(wlanframe_S1[k]) * gain;
+        for (k=0; k<64; k++)
+            s_hat += G[(k+1)%64] * conjf(G[k]);
+    }
+    return s_hat * 0.019231f;   // 1/52
+}
+
+// frame detection
+void wlanframesync_mrc_execute_seekplcp(wlanframesync_mrc _q)
+{
+    _q->timer++;
+    if (_q->timer < 64)
+        return;
+
+    // reset timer
+    _q->timer = 0;
+
+    // estimate gain over all antennas
+    unsigned int a, i;
+    float complex * rc;
+    float g = 0.0f;
+    for (a=0; a<_q->num_antennas; a++) {
+        windowcf_read(_q->input_buffer[a], &rc);
+        for (i=16; i<80; i++)
+            g += crealf(rc[i])*crealf(rc[i]) + cimagf(rc[i])*cimagf(rc[i]);
+    }
+    g = 64.0f / (g + 1e-12f);
+    _q->g0 = g;
+
+    // compute S0 metrics
+    wlanframesync_mrc_transform(_q, 16);
+    float complex s_hat = wlanframesync_mrc_S0_metrics(_q, _q->G0a) * g;
+
+    if (cabsf(s_hat) > WLANFRAMESYNC_MRC_S0A_ABS_THRESH) {
+        float tau_hat = cargf(s_hat) * 16.0f / (2*M_PI);
+        int dt = (int)roundf(tau_hat);
+        _q->timer = (16 + dt) % 16;
+        _q->state = WLANFRAMESYNC_MRC_STATE_RXSHORT0;
+    }
+}
+
+// receive 'short' sequence, estimating carrier offset after the second
+//  _q      :   multi-antenna frame synchronizer object
+//  _G      :   gains for this sequence [size: _num_antennas x 64]
+void wlanframesync_mrc_execute_rxshort(wlanframesync_mrc _q,
+                                       float complex *   _G)
+{
+    _q->timer++;
+    if (_q->timer < 16)
+        return;
+
+    // reset timer
+    _q->timer = 0;
+
+    // re-estimate S0 gains
+    wlanframesync_mrc_transform(_q, 16);
+    wlanframesync_mrc_S0_metrics(_q, _G);
+
+    if (_q->state == WLANFRAMESYNC_MRC_STATE_RXSHORT0) {
+        _q->state = WLANFRAMESYNC_MRC_STATE_RXSHORT1;
+        return;
+    }
+
+    // estimate carrier frequency offset over all antennas (see
+    // wlanframesync_estimate_cfo_S0())
+    float complex g_hat = 0.0f;
+    unsigned int i;
+    for (i=0; i<_q->num_antennas*64; i++)
+        g_hat += _q->G0b[i] * conjf(_q->G0a[i]);
+    nco_crcf_set_frequency(_q->nco_rx, 4.0f * cargf(g_hat) / 64.0f);
+
+    _q->state = WLANFRAMESYNC_MRC_STATE_RXLONG0;
+}
+
+// receive first 'long' sequence
+void wlanframesync_mrc_execute_rxlong0(wlanframesync_mrc _q)
+{
+    _q->timer++;
+    if (_q->timer < 16)
+        return;
+
+    // reset timer
+    _q->timer = 0;
+
+    // estimate S1 gains, adding backoff, and compute metric rotated by
+    // phasor relative to timing backoff
+    wlanframesync_mrc_transform(_q, 16-2);
+    float complex s_hat = wlanframesync_mrc_S1_metrics(_q, _q->G1a) * _q->g0;
+    s_hat *= cexpf(_Complex_I * 0.19635f);
+
+    // magnitude should be near unity and phase near zero when aligned
+    if (cabsf(s_hat)        > WLANFRAMESYNC_MRC_S1A_ABS_THRESH &&
+        fabsf(cargf(s_hat)) < WLANFRAMESYNC_MRC_S1A_ARG_THRESH)
+    {
+        _q->state = WLANFRAMESYNC_MRC_STATE_RXLONG1;
+        _q->timer = 0;
+    }
+}
+
+// receive second 'long' sequence, estimating channel of each antenna
+void wlanframesync_mrc_execute_rxlong1(wlanframesync_mrc _q)
+{
+    _q->timer++;
+    if (_q->timer < 64)
+        return;
+
+    // estimate S1 gains, adding backoff
+    wlanframesync_mrc_transform(_q, 16-2);
+    float complex s_hat = wlanframesync_mrc_S1_metrics(_q, _q->G1b) * _q->g0;
+    s_hat *= cexpf(_Complex_I * 0.19635f);
+
+    if (cabsf(s_hat)        > WLANFRAMESYNC_MRC_S1B_ABS_THRESH &&
+        fabsf(cargf(s_hat)) < WLANFRAMESYNC_MRC_S1B_ARG_THRESH)
+    {
+        // refine carrier offset estimate over all antennas (see
+        // wlanframesync_estimate_cfo_S1())
+        float complex g_hat = 0.0f;
+        unsigned int i;
+        for (i=0; i<_q->num_antennas*64; i++)
+            g_hat += _q->G1b[i] * conjf(_q->G1a[i]);
+        nco_crcf_adjust_frequency(_q->nco_rx, cargf(g_hat) / 64.0f);
+
+        // estimate combining weights
+        wlanframesync_mrc_estimate_weights(_q);
+    }
+
+    _q->state = WLANFRAMESYNC_MRC_STATE_RXSIGNAL;
+    _q->timer = 0;
+}
+
+// estimate maximum-ratio combining weights from channel gain of each
+// antenna, averaged over both 'long' sequences; the weights include the
+// equalizer normalization (see wlanframesync_estimate_eqgain_poly()).
+// The gains are not smoothed: diversity matters most on channels too
+// frequency-selective for a low-order fit across subcarriers.
+void wlanframesync_mrc_estimate_weights(wlanframesync_mrc _q)
+{
+    unsigned int a, k;
+    float e[64];
+    for (k=0; k<64; k++)
+        e[k] = 1e-12f;
+
+    // channel gain of each antenna, stored in weights
+    for (a=0; a<_q->num_antennas; a++) {
+        float complex * G = &_q->W[a*64];
+        for (k=0; k<64; k++) {
+            G[k] = 0.5f*(_q->G1a[a*64+k] + _q->G1b[a*64+k]);
+            e[k] += crealf(G[k])*crealf(G[k]) + cimagf(G[k])*cimagf(G[k]);
+        }
+    }
+
+    // W_a(k) = conj(G_a(k)) / sum_b |G_b(k)|^2
+    for (a=0; a<_q->num_antennas; a++) {
+        float complex * W = &_q->W[a*64];
+        for (k=0; k<64; k++)
+            W[k] = 0.11267f * conjf(W[k]) / e[k];
+    }
+}
+
+// combine transformed symbol of each antenna into _q->Y
+void wlanframesync_mrc_combine(wlanframesync_mrc _q)
+{
+    unsigned int a, k;
+    for (k=0; k<64; k++)
+        _q->Y[k] = _q->W[k] * _q->Xa[k];
+    for (a=1; a<_q->num_antennas; a++) {
+        float complex * W  = &_q->W[a*64];
+        float complex * Xa = &_q->Xa[a*64];
+        for (k=0; k<64; k++)
+            _q->Y[k] += W[k] * Xa[k];
+    }
+}
+
+// receive the 'SIGNAL' field
+void wlanframesync_mrc_execute_rxsignal(wlanframesync_mrc _q)
+{
+    _q->timer++;
+    if (_q->timer < 80)
+        return;
+
+    // reset timer
+    _q->timer = 0;
+
+    // transform, combine and recover symbol
+    wlanframesync_mrc_transform(_q, 16-2);
+    wlanframesync_mrc_combine(_q);
+    wlanframesync_rxsymbol(_q->Y, _q->R, 0, &_q->phi_prime);
+
+    // demodulate (BPSK) DATA subcarriers, first subcarrier in the most
+    // significant bit
+    unsigned int i;
+    memset(_q->signal_int, 0x00, 6*sizeof(unsigned char));
+    for (i=0; i<48; i++) {
+        if (crealf(_q->Y[wlanframe_data_subcarriers[i]]) > 0.0f)
+            _q->signal_int[i/8] |= 0x80 >> (i%8);
+    }
+
+    // de-interleave, decode and unpack
+    unsigned int R;
+    wlan_interleaver_decode_symbol(WLANFRAME_RATE_6, _q->signal_int, _q->signal_enc);
+    wlan_fec_signal_decode(_q->signal_enc, _q->signal_dec);
+    if (!wlan_signal_unpack(_q->signal_dec, &_q->rate, &R, &_q->length)) {
+        wlanframesync_mrc_reset(_q);
+        return;
+    }
+
+    // DATA field starts with the next sample
+    unsigned int rssi = 200 + (unsigned int) (10*log10f(_q->g0));
+    wlanframesync_rxdata_init(_q->rx, _q->rate, _q->seed, _q->length, rssi,
+                              _q->R, _q->phi_prime, 0.0f, 0.0f);
+    _q->num_symbols = 0;
+    _q->state = WLANFRAMESYNC_MRC_STATE_RXDATA;
+}
+
+// receive data symbols
+void wlanframesync_mrc_execute_rxdata(wlanframesync_mrc _q)
+{
+    _q->timer++;
+    if (_q->timer < 80)
+        return;
+
+    // reset timer
+    _q->timer = 0;
+
+    // correct carrier offset over entire symbol of every antenna with
+    // the same phase, keeping transform input (with timing backoff)
+    unsigned int a, i;
+    float complex * rc[_q->num_antennas];
+    for (a=0; a<_q->num_antennas; a++)
+        windowcf_read(_q->input_buffer[a], &rc[a]);
+    float complex y;
+    for (i=0; i<80; i++) {
+        for (a=0; a<_q->num_antennas; a++) {
+            nco_crcf_mix_down(_q->nco_rx, rc[a][i], &y);
+            rc[a][i] = y;
+        }
+        nco_crcf_step(_q->nco_rx);
+    }
+    wlanframesync_mrc_transform(_q, 16-2);
+    wlanframesync_mrc_combine(_q);
+
+    // receive symbol and adjust NCO proportionally to phase error
+    float dphi;
+    int complete = wlanframesync_rxdata_execute_freq(_q->rx, _q->Y, &dphi);
+    if (_q->num_symbols > 0)
+        nco_crcf_adjust_frequency(_q->nco_rx, 1e-3f*dphi);
+    _q->num_symbols++;
+
+    if (!complete)
+        return;
+
+    // decode message and invoke callback
+    struct wlan_rxvector_s rxvector;
+    unsigned char * msg_dec = wlanframesync_rxdata_decode(_q->rx, &rxvector);
+    if (_q->callback != NULL)
+        _q->callback(msg_dec, rxvector, _q->userdata);
+
+    wlanframesync_mrc_reset(_q);
+}
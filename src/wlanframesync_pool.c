@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanframesync_pool.c
+//
+// Multi-threaded frame decoding: the synchronizer captures each aligned
+// DATA field into a bounded ring of slots along with its channel and
+// carrier estimates; worker threads, each with its own DATA field
+// receiver, equalize, demodulate and decode the frames and deliver them
+// to the callback in order of detection.
+//
+// The synchronizer owns the head and workers claim frames with an
+// atomic increment, as in wlanframegen_pool. Delivery is serialized by
+// a mutex: whichever worker completes the oldest outstanding frame
+// invokes the callback for it and for any later frames already decoded.
+//
+// A pool without threads is driven by an external scheduler (see
+// wlanrx): a notification is raised for every submitted frame, and the
+// scheduler decodes it with wlanframesync_pool_decode().
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>
+
+#include "liquid-wlan.internal.h"
+
+#define DEBUG_WLANFRAMESYNC_POOL      0
+
+// worker thread
+struct wlanframesync_pool_worker_s {
+    pthread_t thread;                   // thread handle
+    wlanframesync_rxdata rx;            // DATA field receiver
+    wlanframesync_pool pool;            // parent pool
+};
+
+struct wlanframesync_pool_s {
+    // callback
+    wlanframesync_callback callback;
+    void * userdata;
+
+    unsigned int num_threads;           // number of worker threads
+    unsigned int num_slots;             // number of slots in ring
+    struct wlanframesync_pool_frame_s * frames;
+    struct wlanframesync_pool_worker_s * workers;
+
+    // external scheduling (no worker threads)
+    wlanframesync_pool_notify notify;   // frame submitted
+    void * notify_arg;                  // notification argument
+    wlanframesync_rxdata rx;            // receiver for decoding while waiting
+
+    // ring indices
+    unsigned long int head;             // next slot to submit (producer, atomic)
+    unsigned long int tail;             // next slot to deliver (lock, atomic)
+    unsigned long int claim;            // next slot to decode (workers, atomic)
+    int stop;                           // stop workers (atomic)
+
+    // blocking
+    sem_t slots_free;                   // number of free slots
+    sem_t jobs_pending;                 // number of submitted frames
+    pthread_mutex_t lock;               // delivery lock
+    pthread_cond_t  delivered;          // frame(s) delivered
+};
+
+// create frame decoding pool
+//  _callback       :   user-defined callback function
+//  _userdata       :   user-defined data structure
+//  _num_threads    :   number of worker threads (0: externally scheduled)
+//  _num_slots      :   number of frames in flight, _num_slots > 0
+wlanframesync_pool wlanframesync_pool_create(wlanframesync_callback _callback,
+                                             void *                 _userdata,
+                                             unsigned int           _num_threads,
+                                             unsigned int           _num_slots)
+{
+    wlanframesync_pool q = (wlanframesync_pool) malloc(sizeof(struct wlanframesync_pool_s));
+    q->callback    = _callback;
+    q->userdata    = _userdata;
+    q->num_threads = _num_threads;
+    q->num_slots   = _num_slots;
+    q->notify      = NULL;
+    q->notify_arg  = NULL;
+    q->rx          = _num_threads == 0 ? wlanframesync_rxdata_create() : NULL;
+
+    // initialize ring
+    q->head  = 0;
+    q->tail  = 0;
+    q->claim = 0;
+    q->stop  = 0;
+    sem_init(&q->slots_free,   0, q->num_slots);
+    sem_init(&q->jobs_pending, 0, 0);
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->delivered, NULL);
+
+    unsigned int i;
+    q->frames = (struct wlanframesync_pool_frame_s*) malloc(q->num_slots*sizeof(struct wlanframesync_pool_frame_s));
+    for (i=0; i<q->num_slots; i++) {
+        q->frames[i].span       = NULL;
+        q->frames[i].span_len   = 0;
+        q->frames[i].span_alloc = 0;
+        q->frames[i].done       = 0;
+    }
+
+    // create receivers serially; transform planners are not
+    // necessarily thread-safe
+    q->workers = (struct wlanframesync_pool_worker_s*) malloc(q->num_threads*sizeof(struct wlanframesync_pool_worker_s));
+    for (i=0; i<q->num_threads; i++) {
+        q->workers[i].rx   = wlanframesync_rxdata_create();
+        q->workers[i].pool = q;
+    }
+
+    // start worker threads
+    for (i=0; i<q->num_threads; i++) {
+        if (pthread_create(&q->workers[i].thread, NULL, wlanframesync_pool_worker, &q->workers[i]) != 0) {
+            fprintf(stderr,"error: wlanframesync_pool_create(), could not create thread\n");
+            exit(1);
+        }
+    }
+
+    return q;
+}
+
+// destroy frame decoding pool, delivering every submitted frame first
+void wlanframesync_pool_destroy(wlanframesync_pool _q)
+{
+    wlanframesync_pool_flush(_q);
+
+    // stop and join worker threads
+    unsigned int i;
+    __atomic_store_n(&_q->stop, 1, __ATOMIC_RELEASE);
+    for (i=0; i<_q->num_threads; i++)
+        sem_post(&_q->jobs_pending);
+    for (i=0; i<_q->num_threads; i++)
+        pthread_join(_q->workers[i].thread, NULL);
+
+    // destroy receivers serially
+    for (i=0; i<_q->num_threads; i++)
+        wlanframesync_rxdata_destroy(_q->workers[i].rx);
+    free(_q->workers);
+
+    if (_q->rx != NULL)
+        wlanframesync_rxdata_destroy(_q->rx);
+
+    // free slots
+    for (i=0; i<_q->num_slots; i++)
+        free(_q->frames[i].span);
+    free(_q->frames);
+
+    sem_destroy(&_q->slots_free);
+    sem_destroy(&_q->jobs_pending);
+    pthread_mutex_destroy(&_q->lock);
+    pthread_cond_destroy(&_q->delivered);
+
+    // free main object memory
+    free(_q);
+}
+
+// set notification for externally scheduled pool, invoked from the
+// synchronizer's thread each time a frame is submitted
+//  _q          :   frame decoding pool
+//  _notify     :   notification function
+//  _arg        :   notification argument
+void wlanframesync_pool_set_notify(wlanframesync_pool        _q,
+                                   wlanframesync_pool_notify _notify,
+                                   void *                    _arg)
+{
+    _q->notify     = _notify;
+    _q->notify_arg = _arg;
+}
+
+// acquire next frame slot for capture, blocking while all slots are in
+// use; the slot is owned by the synchronizer until submitted or
+// cancelled
+struct wlanframesync_pool_frame_s * wlanframesync_pool_acquire(wlanframesync_pool _q)
+{
+    if (_q->num_threads > 0) {
+        while (sem_wait(&_q->slots_free) != 0);
+    } else {
+        // the caller may be the scheduler's only available thread:
+        // decode pending frames rather than waiting for them
+        while (sem_trywait(&_q->slots_free) != 0) {
+            if (!wlanframesync_pool_decode(_q, _q->rx))
+                sched_yield();
+        }
+    }
+    return &_q->frames[_q->head % _q->num_slots];
+}
+
+// release acquired frame slot to workers
+void wlanframesync_pool_submit(wlanframesync_pool _q)
+{
+    __atomic_store_n(&_q->head, _q->head+1, __ATOMIC_RELEASE);
+    sem_post(&_q->jobs_pending);
+    if (_q->notify != NULL)
+        _q->notify(_q->notify_arg);
+}
+
+// return acquired frame slot without submitting it
+void wlanframesync_pool_cancel(wlanframesync_pool _q)
+{
+    sem_post(&_q->slots_free);
+}
+
+// decode and deliver next submitted frame, if any, returning 1 if a
+// frame was decoded
+//  _q      :   frame decoding pool
+//  _rx     :   DATA field receiver owned by calling thread
+int wlanframesync_pool_decode(wlanframesync_pool   _q,
+                              wlanframesync_rxdata _rx)
+{
+    if (sem_trywait(&_q->jobs_pending) != 0)
+        return 0;
+    wlanframesync_pool_process(_q, _rx);
+    return 1;
+}
+
+// get number of frames submitted but not yet delivered
+unsigned int wlanframesync_pool_get_backlog(wlanframesync_pool _q)
+{
+    unsigned long int head = __atomic_load_n(&_q->head, __ATOMIC_ACQUIRE);
+    unsigned long int tail = __atomic_load_n(&_q->tail, __ATOMIC_ACQUIRE);
+    return (unsigned int)(head - tail);
+}
+
+// block until every submitted frame has been delivered
+void wlanframesync_pool_flush(wlanframesync_pool _q)
+{
+    unsigned long int head = __atomic_load_n(&_q->head, __ATOMIC_ACQUIRE);
+    pthread_mutex_lock(&_q->lock);
+    while (_q->tail != head)
+        pthread_cond_wait(&_q->delivered, &_q->lock);
+    pthread_mutex_unlock(&_q->lock);
+}
+
+//
+// internal methods
+//
+
+// worker thread: claim frames in order, decode and deliver them
+void * wlanframesync_pool_worker(void * _arg)
+{
+    struct wlanframesync_pool_worker_s * w = (struct wlanframesync_pool_worker_s*) _arg;
+    wlanframesync_pool q = w->pool;
+
+    while (1) {
+        // wait for frame (or stop signal)
+        while (sem_wait(&q->jobs_pending) != 0);
+        if (__atomic_load_n(&q->stop, __ATOMIC_ACQUIRE))
+            break;
+
+        wlanframesync_pool_process(q, w->rx);
+    }
+
+    return NULL;
+}
+
+// claim next submitted frame, decode it and deliver it along with any
+// later frames already decoded; a pending-frame count must have been
+// consumed by the caller
+void wlanframesync_pool_process(wlanframesync_pool   _q,
+                                wlanframesync_rxdata _rx)
+{
+    // claim frame; every wait consumed corresponds to exactly one
+    // submitted frame, so the claimed slot is always populated
+    unsigned long int n = __atomic_fetch_add(&_q->claim, 1, __ATOMIC_ACQ_REL);
+    struct wlanframesync_pool_frame_s * frame = &_q->frames[n % _q->num_slots];
+
+    // receive DATA symbols and decode
+    wlanframesync_rxdata_init(_rx, frame->rate, frame->seed, frame->length, frame->rssi,
+                              frame->R, frame->phi_prime, frame->nu, frame->theta);
+    unsigned int i;
+    for (i=0; i<frame->span_len; i+=80)
+        wlanframesync_rxdata_execute(_rx, &frame->span[i]);
+    unsigned char * msg_dec = wlanframesync_rxdata_decode(_rx, &frame->rxvector);
+    memmove(frame->payload, msg_dec, frame->length*sizeof(unsigned char));
+#if DEBUG_WLANFRAMESYNC_POOL
+    printf("wlanframesync_pool: frame %lu decoded (%u bytes)\n", n, frame->length);
+#endif
+
+    // deliver this frame and any later frames already decoded
+    pthread_mutex_lock(&_q->lock);
+    frame->done = 1;
+    while (_q->frames[_q->tail % _q->num_slots].done) {
+        frame = &_q->frames[_q->tail % _q->num_slots];
+        if (_q->callback != NULL)
+            _q->callback(frame->payload, frame->rxvector, _q->userdata);
+        frame->done = 0;
+        __atomic_store_n(&_q->tail, _q->tail+1, __ATOMIC_RELEASE);
+        sem_post(&_q->slots_free);
+    }
+    pthread_cond_broadcast(&_q->delivered);
+    pthread_mutex_unlock(&_q->lock);
+}
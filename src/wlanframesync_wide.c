@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanframesync_wide.c
+//
+// Wide frame synchronizer: many independent streams, fed in lockstep,
+// are searched for frames together with one stream in each vector
+// lane. The input of every stream is stored lane-interleaved and the
+// detection metric of wlanframesync_execute_seekplcp() is computed for
+// all streams every 64 samples. A stream on which a frame is detected
+// is handed to its own wlanframesync for reception, and rejoins the
+// search once that synchronizer is seeking again.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "liquid-wlan.internal.h"
+
+#if LIQUID_WLAN_HAVE_AVX2
+#   include <immintrin.h>
+#endif
+
+// detection threshold (see wlanframesync.c)
+#define WLANFRAMESYNC_WIDE_S0A_ABS_THRESH   (0.4f)
+
+// subcarriers of the 'short' sequence, in order of the weights
+static const unsigned int wlanframesync_wide_bins[12] = {
+     4,  8, 12, 16, 20, 24, 40, 44, 48, 52, 56, 60};
+
+// stream context for callback
+struct wlanframesync_wide_lane_s {
+    wlanframesync_wide q;       // parent object
+    unsigned int index;         // stream index
+};
+
+struct wlanframesync_wide_s {
+    unsigned int num_lanes;     // number of streams
+    unsigned int stride;        // lanes allocated, multiple of WLANFRAMESYNC_WIDE_LANES
+
+    // input: last 16 samples of the previous window followed by the
+    // current 64-sample window; real and imaginary parts of sample t
+    // at rows 2t and 2t+1
+    float * buffer;             // [size: 160 x stride]
+    unsigned int timer;         // samples in current window
+
+    // detection
+    float w[12*16*2];           // transform weights (see wlanframesync_wide_seek_generic)
+    float * s;                  // metrics [size: 3 x stride]
+    const struct wlan_cpu_s * cpu;
+
+    // reception
+    wlanframesync * fs;         // synchronizer for each stream
+    int * active;               // stream handed to its synchronizer?
+    struct wlanframesync_wide_lane_s * lanes;
+
+    // callback
+    wlanrx_callback callback;
+    void * userdata;
+};
+
+// internal callback: tag frame with stream index
+static int wlanframesync_wide_callback(unsigned char *        _payload,
+                                       struct wlan_rxvector_s _rxvector,
+                                       void *                 _userdata)
+{
+    struct wlanframesync_wide_lane_s * lane = (struct wlanframesync_wide_lane_s*) _userdata;
+    wlanframesync_wide q = lane->q;
+    return q->callback(lane->index, _payload, _rxvector, q->userdata);
+}
+
+// create wide frame synchronizer
+//  _num_lanes  :   number of streams, _num_lanes > 0
+//  _callback   :   user-defined callback function
+//  _userdata   :   user-defined data structure
+wlanframesync_wide wlanframesync_wide_create(unsigned int    _num_lanes,
+                                             wlanrx_callback _callback,
+                                             void *          _userdata)
+{
+    // validate input
+    if (_num_lanes == 0) {
+        fprintf(stderr,"error: wlanframesync_wide_create(), number of lanes must be greater than zero\n");
+        exit(1);
+    }
+
+    wlanframesync_wide q = (wlanframesync_wide) malloc(sizeof(struct wlanframesync_wide_s));
+    q->num_lanes = _num_lanes;
+    q->stride    = (_num_lanes + WLANFRAMESYNC_WIDE_LANES - 1) / WLANFRAMESYNC_WIDE_LANES * WLANFRAMESYNC_WIDE_LANES;
+    q->callback  = _callback;
+    q->userdata  = _userdata;
+    q->cpu       = wlan_cpu_get();
+
+    // allocate buffers; unused lanes remain zero
+    q->buffer = (float*) calloc(2*80*q->stride, sizeof(float));
+    q->s      = (float*) malloc(3*q->stride*sizeof(float));
+
+    // weights: bin k = 4m of the 64-point transform of x(r + 16b) is
+    // the 16-point transform of the window folded to 16 samples
+    //   X(4m) = sum_r exp(-j 2 pi m r/16) sum_b x(r + 16b)
+    // scaled as in wlanframesync_estimate_gain_S0()
+    float gain = 0.054127f; // sqrt(12)/64
+    unsigned int i, r;
+    for (i=0; i<12; i++) {
+        unsigned int k = wlanframesync_wide_bins[i];
+        for (r=0; r<16; r++) {
+            float complex w = cexpf(-_Complex_I*2*M_PI*(float)((k/4)*r % 16)/16.0f) * conjf(wlanframe_S0[k]) * gain;
+            q->w[2*(16*i + r) + 0] = crealf(w);
+            q->w[2*(16*i + r) + 1] = cimagf(w);
+        }
+    }
+
+    // create synchronizer for each stream
+    q->fs     = (wlanframesync*) malloc(q->num_lanes*sizeof(wlanframesync));
+    q->active = (int*) malloc(q->num_lanes*sizeof(int));
+    q->lanes  = (struct wlanframesync_wide_lane_s*) malloc(q->num_lanes*sizeof(struct wlanframesync_wide_lane_s));
+    for (i=0; i<q->num_lanes; i++) {
+        q->lanes[i].q     = q;
+        q->lanes[i].index = i;
+        q->fs[i] = wlanframesync_create(wlanframesync_wide_callback, &q->lanes[i]);
+    }
+
+    // reset object
+    wlanframesync_wide_reset(q);
+
+    return q;
+}
+
+// destroy wide frame synchronizer
+void wlanframesync_wide_destroy(wlanframesync_wide _q)
+{
+    unsigned int i;
+    for (i=0; i<_q->num_lanes; i++)
+        wlanframesync_destroy(_q->fs[i]);
+    free(_q->fs);
+    free(_q->active);
+    free(_q->lanes);
+    free(_q->buffer);
+    free(_q->s);
+    free(_q);
+}
+
+// print wide frame synchronizer object internals
+void wlanframesync_wide_print(wlanframesync_wide _q)
+{
+    printf("wlanframesync_wide:\n");
+    printf("    streams     :   %u (%u lanes)\n", _q->num_lanes, _q->stride);
+    printf("    active      :   %u\n", wlanframesync_wide_get_num_active(_q));
+    printf("    kernel      :   %s\n", _q->cpu->impl[WLAN_CPU_KERNEL_SEEK]);
+}
+
+// reset wide frame synchronizer object internal state
+void wlanframesync_wide_reset(wlanframesync_wide _q)
+{
+    memset(_q->buffer, 0x00, 2*80*_q->stride*sizeof(float));
+    _q->timer = 0;
+
+    unsigned int i;
+    for (i=0; i<_q->num_lanes; i++) {
+        wlanframesync_reset(_q->fs[i]);
+        _q->active[i] = 0;
+    }
+}
+
+// execute wide frame synchronizer on the same number of samples from
+// every stream
+//  _q      :   wide frame synchronizer object
+//  _x      :   input for each stream [size: _num_lanes x _n]
+//  _n      :   number of input samples per stream
+void wlanframesync_wide_execute(wlanframesync_wide      _q,
+                                liquid_float_complex ** _x,
+                                unsigned int            _n)
+{
+    unsigned int stride = _q->stride;
+    unsigned int i = 0;
+    unsigned int l, t;
+    while (i < _n) {
+        // run up to the end of the current window
+        unsigned int k = _n - i < 64 - _q->timer ? _n - i : 64 - _q->timer;
+
+        // store input of every stream, and run streams receiving a
+        // frame through their synchronizers
+        for (l=0; l<_q->num_lanes; l++) {
+            float complex * x = &_x[l][i];
+            float * b = &_q->buffer[2*(16 + _q->timer)*stride + l];
+            for (t=0; t<k; t++) {
+                b[(2*t+0)*stride] = crealf(x[t]);
+                b[(2*t+1)*stride] = cimagf(x[t]);
+            }
+            if (_q->active[l])
+                wlanframesync_execute(_q->fs[l], x, k);
+        }
+        _q->timer += k;
+        i += k;
+
+        if (_q->timer < 64)
+            continue;
+
+        // streams whose synchronizers are seeking rejoin the search
+        for (l=0; l<_q->num_lanes; l++) {
+            if (_q->active[l] && wlanframesync_is_seeking(_q->fs[l]))
+                _q->active[l] = 0;
+        }
+
+        // compute metrics for all lanes and hand off detected frames
+        _q->cpu->seek_metrics(&_q->buffer[2*16*stride], stride, _q->w, _q->s);
+        for (l=0; l<_q->num_lanes; l++) {
+            if (_q->active[l])
+                continue;
+            float complex s_hat = _q->s[l] + _Complex_I*_q->s[stride + l];
+            if (cabsf(s_hat) <= WLANFRAMESYNC_WIDE_S0A_ABS_THRESH)
+                continue;
+
+            // gather stream history and start its synchronizer with the
+            // timer set as by wlanframesync_execute_seekplcp()
+            float complex rc[80];
+            for (t=0; t<80; t++)
+                rc[t] = _q->buffer[(2*t+0)*stride + l] + _Complex_I*_q->buffer[(2*t+1)*stride + l];
+            float tau_hat = cargf(s_hat) * 16.0f / (2*M_PI);
+            int dt = (int)roundf(tau_hat);
+            wlanframesync_prime(_q->fs[l], rc, _q->s[2*stride + l], (16 + dt) % 16);
+            _q->active[l] = 1;
+        }
+
+        // retain last 16 samples of window
+        memmove(_q->buffer, &_q->buffer[2*64*stride], 2*16*stride*sizeof(float));
+        _q->timer = 0;
+    }
+}
+
+// get number of streams currently receiving a frame
+unsigned int wlanframesync_wide_get_num_active(wlanframesync_wide _q)
+{
+    unsigned int i, n = 0;
+    for (i=0; i<_q->num_lanes; i++)
+        n += _q->active[i];
+    return n;
+}
+
+//
+// internal methods
+//
+
+// compute frame detection metrics across lanes
+//  _x          :   input, lane-interleaved [size: 128 x _stride]
+//  _stride     :   row length, a multiple of WLANFRAMESYNC_WIDE_LANES
+//  _w          :   transform weights [size: 12 x 16 x 2]
+//  _s          :   metric and gain estimate [size: 3 x _stride]
+void wlanframesync_wide_seek_generic(const float * _x,
+                                     unsigned int  _stride,
+                                     const float * _w,
+                                     float *       _s)
+{
+    unsigned int l, j, t, r, i;
+    for (l=0; l<_stride; l+=WLANFRAMESYNC_WIDE_LANES) {
+        // fold window to 16 samples and accumulate energy
+        float e[WLANFRAMESYNC_WIDE_LANES];
+        float fr[16][WLANFRAMESYNC_WIDE_LANES];
+        float fi[16][WLANFRAMESYNC_WIDE_LANES];
+        memset(e,  0x00, sizeof(e));
+        memset(fr, 0x00, sizeof(fr));
+        memset(fi, 0x00, sizeof(fi));
+        for (t=0; t<64; t++) {
+            const float * xr = &_x[(2*t+0)*_stride + l];
+            const float * xi = &_x[(2*t+1)*_stride + l];
+            for (j=0; j<WLANFRAMESYNC_WIDE_LANES; j++) {
+                fr[t%16][j] += xr[j];
+                fi[t%16][j] += xi[j];
+                e[j] += xr[j]*xr[j] + xi[j]*xi[j];
+            }
+        }
+
+        // subcarrier gains
+        float gr[12][WLANFRAMESYNC_WIDE_LANES];
+        float gi[12][WLANFRAMESYNC_WIDE_LANES];
+        for (i=0; i<12; i++) {
+            for (j=0; j<WLANFRAMESYNC_WIDE_LANES; j++) {
+                gr[i][j] = 0.0f;
+                gi[i][j] = 0.0f;
+            }
+            for (r=0; r<16; r++) {
+                float wr = _w[2*(16*i + r) + 0];
+                float wi = _w[2*(16*i + r) + 1];
+                for (j=0; j<WLANFRAMESYNC_WIDE_LANES; j++) {
+                    gr[i][j] += fr[r][j]*wr - fi[r][j]*wi;
+                    gi[i][j] += fr[r][j]*wi + fi[r][j]*wr;
+                }
+            }
+        }
+
+        // accumulate phase difference across adjacent subcarriers (see
+        // wlanframesync_S0_metrics()) and scale by gain estimate
+        for (j=0; j<WLANFRAMESYNC_WIDE_LANES; j++) {
+            float sr = 0.0f;
+            float si = 0.0f;
+            for (i=0; i<11; i++) {
+                if (i == 5)
+                    continue;
+                sr += gr[i+1][j]*gr[i][j] + gi[i+1][j]*gi[i][j];
+                si += gi[i+1][j]*gr[i][j] - gr[i+1][j]*gi[i][j];
+            }
+            float g = 64.0f / (e[j] + 1e-12f);
+            _s[             l + j] = sr * 0.1f * g;
+            _s[  _stride + l + j] = si * 0.1f * g;
+            _s[2*_stride + l + j] = g;
+        }
+    }
+}
+
+#if LIQUID_WLAN_HAVE_AVX2
+// compute frame detection metrics across lanes, eight at a time
+//  _x          :   input, lane-interleaved [size: 128 x _stride]
+//  _stride     :   row length, a multiple of WLANFRAMESYNC_WIDE_LANES
+//  _w          :   transform weights [size: 12 x 16 x 2]
+//  _s          :   metric and gain estimate [size: 3 x _stride]
+LIQUID_WLAN_TARGET_AVX2
+void wlanframesync_wide_seek_avx2(const float * _x,
+                                  unsigned int  _stride,
+                                  const float * _w,
+                                  float *       _s)
+{
+    unsigned int l, t, r, i;
+    for (l=0; l<_stride; l+=8) {
+        // fold window to 16 samples and accumulate energy
+        __m256 e = _mm256_setzero_ps();
+        __m256 fr[16];
+        __m256 fi[16];
+        for (r=0; r<16; r++) {
+            fr[r] = _mm256_setzero_ps();
+            fi[r] = _mm256_setzero_ps();
+        }
+        for (t=0; t<64; t++) {
+            __m256 xr = _mm256_loadu_ps(&_x[(2*t+0)*_stride + l]);
+            __m256 xi = _mm256_loadu_ps(&_x[(2*t+1)*_stride + l]);
+            fr[t%16] = _mm256_add_ps(fr[t%16], xr);
+            fi[t%16] = _mm256_add_ps(fi[t%16], xi);
+            e = _mm256_add_ps(e, _mm256_add_ps(_mm256_mul_ps(xr,xr), _mm256_mul_ps(xi,xi)));
+        }
+
+        // subcarrier gains
+        __m256 gr[12];
+        __m256 gi[12];
+        for (i=0; i<12; i++) {
+            __m256 ar = _mm256_setzero_ps();
+            __m256 ai = _mm256_setzero_ps();
+            for (r=0; r<16; r++) {
+                __m256 wr = _mm256_set1_ps(_w[2*(16*i + r) + 0]);
+                __m256 wi = _mm256_set1_ps(_w[2*(16*i + r) + 1]);
+                ar = _mm256_add_ps(ar, _mm256_sub_ps(_mm256_mul_ps(fr[r],wr), _mm256_mul_ps(fi[r],wi)));
+                ai = _mm256_add_ps(ai, _mm256_add_ps(_mm256_mul_ps(fr[r],wi), _mm256_mul_ps(fi[r],wr)));
+            }
+            gr[i] = ar;
+            gi[i] = ai;
+        }
+
+        // accumulate phase difference across adjacent subcarriers
+        __m256 sr = _mm256_setzero_ps();
+        __m256 si = _mm256_setzero_ps();
+        for (i=0; i<11; i++) {
+            if (i == 5)
+                continue;
+            sr = _mm256_add_ps(sr, _mm256_add_ps(_mm256_mul_ps(gr[i+1],gr[i]), _mm256_mul_ps(gi[i+1],gi[i])));
+            si = _mm256_add_ps(si, _mm256_sub_ps(_mm256_mul_ps(gi[i+1],gr[i]), _mm256_mul_ps(gr[i+1],gi[i])));
+        }
+
+        // scale by gain estimate
+        __m256 g = _mm256_div_ps(_mm256_set1_ps(64.0f), _mm256_add_ps(e, _mm256_set1_ps(1e-12f)));
+        __m256 c = _mm256_mul_ps(g, _mm256_set1_ps(0.1f));
+        _mm256_storeu_ps(&_s[             l], _mm256_mul_ps(sr, c));
+        _mm256_storeu_ps(&_s[  _stride + l], _mm256_mul_ps(si, c));
+        _mm256_storeu_ps(&_s[2*_stride + l], g);
+    }
+}
+#endif
@@ -0,0 +1,546 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanrx.c
+//
+// Multi-channel receiver: one frame synchronizer per channel, with
+// frame detection and DATA field decoding scheduled as tasks on a
+// work-stealing pool of threads.
+//
+// Input samples are buffered in a ring per channel. A channel has at
+// most one detection task queued or running at a time, which keeps its
+// synchronizer single-threaded; the task processes a bounded chunk and
+// re-queues itself so that channels share the workers fairly. Frames
+// captured by a synchronizer are decoded by separate tasks with the
+// worker's own DATA field receiver (transform plan and buffers), and
+// delivered in order per channel (see wlanframesync_pool).
+//
+// Each worker owns a deque: it pushes and pops tasks at the bottom,
+// while idle workers steal from the top. Tasks raised by a worker stay
+// on its own deque; tasks raised by the caller are queued on the
+// channel's home worker.
+//
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "liquid-wlan.internal.h"
+
+#define DEBUG_WLANRX                0
+
+// number of samples processed by a detection task
+#define WLANRX_CHUNK_LEN            (4096)
+
+// number of frames in flight per channel
+#define WLANRX_NUM_SLOTS            (4)
+
+// task types
+enum {
+    WLANRX_TASK_DETECT=0,           // run synchronizer on buffered samples
+    WLANRX_TASK_DECODE,             // decode captured frame
+};
+
+struct wlanrx_task_s {
+    unsigned int type;              // task type
+    unsigned int channel;           // channel index
+};
+
+// work-stealing deque: the owner pushes and pops at the bottom, thieves
+// steal from the top
+struct wlanrx_deque_s {
+    pthread_mutex_t lock;
+    struct wlanrx_task_s * tasks;   // task ring
+    unsigned int capacity;          // ring capacity (power of 2)
+    unsigned long int top;          // next task to steal
+    unsigned long int bottom;       // next free position
+};
+
+struct wlanrx_channel_s {
+    wlanrx rx;                      // parent receiver
+    unsigned int index;             // channel index
+    unsigned int home;              // home worker
+    wlanframesync fs;               // frame synchronizer
+    wlanframesync_pool pool;        // frame decoding pool (owned by fs)
+
+    // input sample ring
+    float complex * buffer;         // samples [size: buffer_len x 1]
+    unsigned long int read;         // samples processed (lock)
+    unsigned long int write;        // samples buffered (lock)
+    int scheduled;                  // detection task queued or running (lock)
+    pthread_mutex_t lock;
+    pthread_cond_t  progress;       // samples processed
+};
+
+struct wlanrx_worker_s {
+    pthread_t thread;               // thread handle
+    wlanrx rx;                      // parent receiver
+    unsigned int index;             // worker index
+    struct wlanrx_deque_s deque;    // task deque
+    wlanframesync_rxdata rxdata;    // DATA field receiver
+};
+
+struct wlanrx_s {
+    // callback
+    wlanrx_callback callback;
+    void * userdata;
+
+    // options
+    unsigned int num_channels;      // number of channels
+    unsigned int num_threads;       // number of worker threads
+    unsigned int buffer_len;        // input samples buffered per channel
+    int flags;                      // LIQUID_WLAN_RX_* options
+
+    struct wlanrx_channel_s * channels;
+    struct wlanrx_worker_s  * workers;
+
+    // scheduling
+    unsigned long int num_tasks;    // tasks queued (atomic)
+    unsigned int num_sleeping;      // workers waiting for tasks (atomic)
+    int stop;                       // stop workers (lock)
+    unsigned int num_ready;         // workers started (lock)
+    pthread_mutex_t lock;
+    pthread_cond_t  work;           // task queued or stop requested
+    pthread_cond_t  ready;          // worker started
+};
+
+// worker running on this thread, if any
+static __thread struct wlanrx_worker_s * wlanrx_worker_self = NULL;
+
+// create multi-channel receiver
+//  _num_channels   :   number of channels, _num_channels > 0
+//  _num_threads    :   number of worker threads, _num_threads > 0
+//  _buffer_len     :   input samples buffered per channel, _buffer_len > 0
+//  _flags          :   options (LIQUID_WLAN_RX_PIN_THREADS, etc.)
+//  _callback       :   user-defined callback function
+//  _userdata       :   user-defined data structure
+wlanrx wlanrx_create(unsigned int    _num_channels,
+                     unsigned int    _num_threads,
+                     unsigned int    _buffer_len,
+                     int             _flags,
+                     wlanrx_callback _callback,
+                     void *          _userdata)
+{
+    // validate input
+    if (_num_channels == 0) {
+        fprintf(stderr,"error: wlanrx_create(), number of channels must be greater than zero\n");
+        exit(1);
+    } else if (_num_threads == 0) {
+        fprintf(stderr,"error: wlanrx_create(), number of threads must be greater than zero\n");
+        exit(1);
+    } else if (_buffer_len == 0) {
+        fprintf(stderr,"error: wlanrx_create(), buffer length must be greater than zero\n");
+        exit(1);
+    }
+#if !HAVE_PTHREAD_SETAFFINITY_NP
+    if (_flags & LIQUID_WLAN_RX_PIN_THREADS)
+        fprintf(stderr,"warning: wlanrx_create(), thread pinning unsupported; ignoring\n");
+#endif
+
+    wlanrx q = (wlanrx) malloc(sizeof(struct wlanrx_s));
+    q->callback     = _callback;
+    q->userdata     = _userdata;
+    q->num_channels = _num_channels;
+    q->num_threads  = _num_threads;
+    q->buffer_len   = _buffer_len;
+    q->flags        = _flags;
+
+    q->num_tasks    = 0;
+    q->num_sleeping = 0;
+    q->stop         = 0;
+    q->num_ready    = 0;
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->work,  NULL);
+    pthread_cond_init(&q->ready, NULL);
+
+    // create channels; synchronizers are created serially as transform
+    // planners are not necessarily thread-safe
+    unsigned int i;
+    q->channels = (struct wlanrx_channel_s*) malloc(q->num_channels*sizeof(struct wlanrx_channel_s));
+    for (i=0; i<q->num_channels; i++) {
+        struct wlanrx_channel_s * c = &q->channels[i];
+        c->rx        = q;
+        c->index     = i;
+        c->home      = i % q->num_threads;
+        c->read      = 0;
+        c->write     = 0;
+        c->scheduled = 0;
+        pthread_mutex_init(&c->lock, NULL);
+        pthread_cond_init(&c->progress, NULL);
+
+        // frames are decoded by the receiver's workers
+        c->fs   = wlanframesync_create(wlanrx_channel_callback, c);
+        c->pool = wlanframesync_pool_create(wlanrx_channel_callback, c, 0, WLANRX_NUM_SLOTS);
+        wlanframesync_pool_set_notify(c->pool, wlanrx_channel_notify, c);
+        wlanframesync_set_pool(c->fs, c->pool);
+
+        // with NUMA placement, buffers are allocated by the home worker
+        // so that first touch places them on its node
+        c->buffer = (q->flags & LIQUID_WLAN_RX_NUMA_LOCAL) ? NULL :
+                    (float complex*) malloc(q->buffer_len*sizeof(float complex));
+    }
+
+    // create workers
+    q->workers = (struct wlanrx_worker_s*) malloc(q->num_threads*sizeof(struct wlanrx_worker_s));
+    for (i=0; i<q->num_threads; i++) {
+        struct wlanrx_worker_s * w = &q->workers[i];
+        w->rx     = q;
+        w->index  = i;
+        w->rxdata = wlanframesync_rxdata_create();
+        pthread_mutex_init(&w->deque.lock, NULL);
+        w->deque.capacity = 64;
+        w->deque.tasks    = (struct wlanrx_task_s*) malloc(w->deque.capacity*sizeof(struct wlanrx_task_s));
+        w->deque.top      = 0;
+        w->deque.bottom   = 0;
+    }
+
+    // start worker threads and wait for them to be ready
+    for (i=0; i<q->num_threads; i++) {
+        if (pthread_create(&q->workers[i].thread, NULL, wlanrx_worker, &q->workers[i]) != 0) {
+            fprintf(stderr,"error: wlanrx_create(), could not create thread\n");
+            exit(1);
+        }
+    }
+    pthread_mutex_lock(&q->lock);
+    while (q->num_ready < q->num_threads)
+        pthread_cond_wait(&q->ready, &q->lock);
+    pthread_mutex_unlock(&q->lock);
+
+    return q;
+}
+
+// destroy multi-channel receiver, processing buffered samples first
+void wlanrx_destroy(wlanrx _q)
+{
+    wlanrx_flush(_q);
+
+    // stop and join worker threads
+    unsigned int i;
+    pthread_mutex_lock(&_q->lock);
+    _q->stop = 1;
+    pthread_cond_broadcast(&_q->work);
+    pthread_mutex_unlock(&_q->lock);
+    for (i=0; i<_q->num_threads; i++)
+        pthread_join(_q->workers[i].thread, NULL);
+
+    // destroy channels (synchronizers destroy their pools)
+    for (i=0; i<_q->num_channels; i++) {
+        struct wlanrx_channel_s * c = &_q->channels[i];
+        wlanframesync_destroy(c->fs);
+        free(c->buffer);
+        pthread_mutex_destroy(&c->lock);
+        pthread_cond_destroy(&c->progress);
+    }
+    free(_q->channels);
+
+    // destroy workers
+    for (i=0; i<_q->num_threads; i++) {
+        struct wlanrx_worker_s * w = &_q->workers[i];
+        wlanframesync_rxdata_destroy(w->rxdata);
+        free(w->deque.tasks);
+        pthread_mutex_destroy(&w->deque.lock);
+    }
+    free(_q->workers);
+
+    pthread_mutex_destroy(&_q->lock);
+    pthread_cond_destroy(&_q->work);
+    pthread_cond_destroy(&_q->ready);
+
+    // free main object memory
+    free(_q);
+}
+
+// print multi-channel receiver object internals
+void wlanrx_print(wlanrx _q)
+{
+    printf("wlanrx:\n");
+    printf("    channels    :   %u\n", _q->num_channels);
+    printf("    threads     :   %u%s\n", _q->num_threads,
+            (_q->flags & LIQUID_WLAN_RX_PIN_THREADS) ? " (pinned)" : "");
+    printf("    buffer      :   %u samples/channel%s\n", _q->buffer_len,
+            (_q->flags & LIQUID_WLAN_RX_NUMA_LOCAL) ? " (node-local)" : "");
+    unsigned int i;
+    for (i=0; i<_q->num_channels; i++) {
+        printf("    channel %-3u :   backlog %u samples, %u frames\n", i,
+                wlanrx_get_backlog(_q, i),
+                wlanrx_get_frame_backlog(_q, i));
+    }
+}
+
+// push samples for channel, blocking while its buffer is full
+//  _q          :   multi-channel receiver
+//  _channel    :   channel index
+//  _x          :   input samples [size: _n x 1]
+//  _n          :   number of input samples
+void wlanrx_execute(wlanrx                 _q,
+                    unsigned int           _channel,
+                    liquid_float_complex * _x,
+                    unsigned int           _n)
+{
+    // validate input
+    if (_channel >= _q->num_channels) {
+        fprintf(stderr,"error: wlanrx_execute(), channel index (%u) out of range\n", _channel);
+        exit(1);
+    }
+
+    struct wlanrx_channel_s * c = &_q->channels[_channel];
+    while (_n > 0) {
+        pthread_mutex_lock(&c->lock);
+        while (c->write - c->read == _q->buffer_len)
+            pthread_cond_wait(&c->progress, &c->lock);
+
+        // copy contiguous block into free space
+        unsigned int offset = c->write % _q->buffer_len;
+        unsigned int k = _q->buffer_len - (unsigned int)(c->write - c->read);
+        if (k > _q->buffer_len - offset) k = _q->buffer_len - offset;
+        if (k > _n)                      k = _n;
+        memmove(&c->buffer[offset], _x, k*sizeof(float complex));
+        c->write += k;
+
+        // schedule detection if idle
+        int schedule = !c->scheduled;
+        c->scheduled = 1;
+        pthread_mutex_unlock(&c->lock);
+        if (schedule)
+            wlanrx_push_task(_q, c->home, WLANRX_TASK_DETECT, _channel);
+
+        _x += k;
+        _n -= k;
+    }
+}
+
+// block until every buffered sample has been processed and every
+// detected frame delivered
+void wlanrx_flush(wlanrx _q)
+{
+    unsigned int i;
+    for (i=0; i<_q->num_channels; i++) {
+        struct wlanrx_channel_s * c = &_q->channels[i];
+        pthread_mutex_lock(&c->lock);
+        while (c->scheduled)
+            pthread_cond_wait(&c->progress, &c->lock);
+        pthread_mutex_unlock(&c->lock);
+
+        wlanframesync_flush(c->fs);
+    }
+}
+
+// get number of input samples buffered for channel but not yet processed
+unsigned int wlanrx_get_backlog(wlanrx       _q,
+                                unsigned int _channel)
+{
+    struct wlanrx_channel_s * c = &_q->channels[_channel];
+    pthread_mutex_lock(&c->lock);
+    unsigned int n = (unsigned int)(c->write - c->read);
+    pthread_mutex_unlock(&c->lock);
+    return n;
+}
+
+// get number of frames detected on channel but not yet delivered
+unsigned int wlanrx_get_frame_backlog(wlanrx       _q,
+                                      unsigned int _channel)
+{
+    return wlanframesync_pool_get_backlog(_q->channels[_channel].pool);
+}
+
+//
+// internal methods
+//
+
+// queue task on worker's deque and wake an idle worker
+//  _q          :   multi-channel receiver
+//  _worker     :   worker index
+//  _type       :   task type
+//  _channel    :   channel index
+void wlanrx_push_task(wlanrx       _q,
+                      unsigned int _worker,
+                      unsigned int _type,
+                      unsigned int _channel)
+{
+    struct wlanrx_deque_s * d = &_q->workers[_worker].deque;
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom - d->top == d->capacity) {
+        // grow ring, preserving task order
+        struct wlanrx_task_s * tasks = (struct wlanrx_task_s*) malloc(2*d->capacity*sizeof(struct wlanrx_task_s));
+        unsigned long int i;
+        for (i=d->top; i<d->bottom; i++)
+            tasks[i & (2*d->capacity-1)] = d->tasks[i & (d->capacity-1)];
+        free(d->tasks);
+        d->tasks = tasks;
+        d->capacity *= 2;
+    }
+    d->tasks[d->bottom & (d->capacity-1)].type    = _type;
+    d->tasks[d->bottom & (d->capacity-1)].channel = _channel;
+    d->bottom++;
+    pthread_mutex_unlock(&d->lock);
+
+    // a worker going to sleep increments the count of sleeping workers
+    // before checking for tasks, so one of the two always sees the other
+    __atomic_add_fetch(&_q->num_tasks, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&_q->num_sleeping, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&_q->lock);
+        pthread_cond_signal(&_q->work);
+        pthread_mutex_unlock(&_q->lock);
+    }
+}
+
+// take task from worker's own deque (bottom) or steal one from another
+// worker's deque (top), returning 1 if a task was found
+//  _w      :   worker
+//  _task   :   task (output)
+int wlanrx_take_task(struct wlanrx_worker_s * _w,
+                     struct wlanrx_task_s *   _task)
+{
+    wlanrx q = _w->rx;
+    unsigned int i;
+    for (i=0; i<q->num_threads; i++) {
+        struct wlanrx_deque_s * d = &q->workers[(_w->index + i) % q->num_threads].deque;
+        pthread_mutex_lock(&d->lock);
+        if (d->bottom == d->top) {
+            pthread_mutex_unlock(&d->lock);
+            continue;
+        }
+        if (i == 0) {
+            d->bottom--;
+            *_task = d->tasks[d->bottom & (d->capacity-1)];
+        } else {
+            *_task = d->tasks[d->top & (d->capacity-1)];
+            d->top++;
+        }
+        pthread_mutex_unlock(&d->lock);
+        __atomic_sub_fetch(&q->num_tasks, 1, __ATOMIC_SEQ_CST);
+        return 1;
+    }
+    return 0;
+}
+
+// detection task: run channel's synchronizer on a chunk of buffered
+// samples, re-queueing the task while samples remain
+//  _w          :   worker
+//  _channel    :   channel index
+void wlanrx_detect(struct wlanrx_worker_s * _w,
+                   unsigned int             _channel)
+{
+    wlanrx q = _w->rx;
+    struct wlanrx_channel_s * c = &q->channels[_channel];
+
+    // contiguous chunk of buffered samples; the producer only writes
+    // outside of it
+    pthread_mutex_lock(&c->lock);
+    unsigned int offset = c->read % q->buffer_len;
+    unsigned int k = (unsigned int)(c->write - c->read);
+    if (k > q->buffer_len - offset) k = q->buffer_len - offset;
+    if (k > WLANRX_CHUNK_LEN)       k = WLANRX_CHUNK_LEN;
+    pthread_mutex_unlock(&c->lock);
+
+    wlanframesync_execute(c->fs, &c->buffer[offset], k);
+
+    pthread_mutex_lock(&c->lock);
+    c->read += k;
+    int more = c->write != c->read;
+    c->scheduled = more;
+    pthread_cond_broadcast(&c->progress);
+    pthread_mutex_unlock(&c->lock);
+
+    if (more)
+        wlanrx_push_task(q, _w->index, WLANRX_TASK_DETECT, _channel);
+}
+
+// worker thread: run own tasks, steal tasks, or wait for tasks
+void * wlanrx_worker(void * _arg)
+{
+    struct wlanrx_worker_s * w = (struct wlanrx_worker_s*) _arg;
+    wlanrx q = w->rx;
+    wlanrx_worker_self = w;
+    unsigned int i;
+
+#if HAVE_PTHREAD_SETAFFINITY_NP
+    if (q->flags & LIQUID_WLAN_RX_PIN_THREADS) {
+        long int num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(w->index % (num_cpus > 0 ? num_cpus : 1), &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpus);
+    }
+#endif
+
+    // place home channels' buffers on this worker's node (first touch)
+    if (q->flags & LIQUID_WLAN_RX_NUMA_LOCAL) {
+        for (i=w->index; i<q->num_channels; i+=q->num_threads) {
+            q->channels[i].buffer = (float complex*) malloc(q->buffer_len*sizeof(float complex));
+            memset(q->channels[i].buffer, 0x00, q->buffer_len*sizeof(float complex));
+        }
+    }
+
+    pthread_mutex_lock(&q->lock);
+    q->num_ready++;
+    pthread_cond_signal(&q->ready);
+    pthread_mutex_unlock(&q->lock);
+
+    struct wlanrx_task_s task;
+    while (1) {
+        if (wlanrx_take_task(w, &task)) {
+            if (task.type == WLANRX_TASK_DETECT)
+                wlanrx_detect(w, task.channel);
+            else
+                wlanframesync_pool_decode(q->channels[task.channel].pool, w->rxdata);
+            continue;
+        }
+
+        // wait for task (or stop signal)
+        pthread_mutex_lock(&q->lock);
+        __atomic_add_fetch(&q->num_sleeping, 1, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&q->num_tasks, __ATOMIC_SEQ_CST) == 0 && !q->stop)
+            pthread_cond_wait(&q->work, &q->lock);
+        __atomic_sub_fetch(&q->num_sleeping, 1, __ATOMIC_SEQ_CST);
+        int stop = q->stop && __atomic_load_n(&q->num_tasks, __ATOMIC_SEQ_CST) == 0;
+        pthread_mutex_unlock(&q->lock);
+        if (stop)
+            break;
+    }
+
+    return NULL;
+}
+
+// frame submitted by channel's synchronizer: queue decoding task on the
+// current worker, or on the channel's home worker otherwise
+void wlanrx_channel_notify(void * _arg)
+{
+    struct wlanrx_channel_s * c = (struct wlanrx_channel_s*) _arg;
+    struct wlanrx_worker_s * w = wlanrx_worker_self;
+    unsigned int worker = (w != NULL && w->rx == c->rx) ? w->index : c->home;
+    wlanrx_push_task(c->rx, worker, WLANRX_TASK_DECODE, c->index);
+}
+
+// frame delivered by channel's synchronizer: invoke callback
+int wlanrx_channel_callback(unsigned char *        _payload,
+                            struct wlan_rxvector_s _rxvector,
+                            void *                 _userdata)
+{
+    struct wlanrx_channel_s * c = (struct wlanrx_channel_s*) _userdata;
+    if (c->rx->callback == NULL)
+        return 0;
+    return c->rx->callback(c->index, _payload, _rxvector, c->rx->userdata);
+}
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Joseph Gaeddert
+ * Copyright (c) 2007, 2008, 2009, 2010, 2012 Virginia Polytechnic
+ *                                      Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlansynthesizer.c
+//
+// Polyphase synthesis filterbank: combines M 20 MHz channel streams
+// into one wideband stream sampled at M x 20 MHz, the inverse of the
+// channelizer. Channel k is interpolated by M, low-pass filtered and
+// mixed up by k/M cycles/sample:
+//
+//   y(t)     = sum_n sum_k x_k(n) g(t-nM) exp(j 2 pi k t/M)
+//   y(sM+p)  = sum_l g(lM+p) v_p(s-l),  v_p(n) = sum_k x_k(n) exp(j 2 pi k p/M)
+//
+// so a single M-point inverse transform of the channel samples at time
+// n feeds the M polyphase branches, each of which produces every M-th
+// output sample. The cost per output sample is one tap per branch plus
+// the transform, rather than a full-rate interpolator and mixer for
+// every channel.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "liquid-wlan.internal.h"
+
+struct wlansynthesizer_s {
+    unsigned int M;             // number of channels
+    unsigned int m;             // filter semi-length (input samples)
+    unsigned int L;             // number of taps per polyphase branch
+    int offset;                 // channel centers offset by half a channel?
+
+    // polyphase filter bank, time-reversed with duplicated taps (see
+    // wlan_dotprod_crcf)
+    float * h;                  // [size: M x 2L]
+
+    // branch buffers: L-1 transformed samples of history followed by
+    // one for each new input
+    float complex * buffer;     // [size: M x stride]
+    unsigned int stride;        // branch buffer length, L-1 + num_alloc
+    unsigned int num_alloc;     // maximum number of inputs per call
+
+    // half-channel offset: exp(j pi t/M)
+    float complex * mix;        // [size: 2M x 1]
+    unsigned int t;             // output time modulo 2M
+
+    // transform
+    FFT_PLAN ifft;              // inverse transform object
+    float complex * X;          // channel samples
+    float complex * V;          // branch inputs
+};
+
+// create synthesizer
+//  _M      :   number of channels, _M > 0
+//  _m      :   filter semi-length (input samples), _m > 0
+//  _offset :   channel centers offset by half a channel?
+wlansynthesizer wlansynthesizer_create(unsigned int _M,
+                                       unsigned int _m,
+                                       int          _offset)
+{
+    // validate input
+    if (_M == 0) {
+        fprintf(stderr,"error: wlansynthesizer_create(), number of channels must be greater than zero\n");
+        exit(1);
+    } else if (_m == 0) {
+        fprintf(stderr,"error: wlansynthesizer_create(), filter semi-length must be greater than zero\n");
+        exit(1);
+    }
+
+    wlansynthesizer q = (wlansynthesizer) malloc(sizeof(struct wlansynthesizer_s));
+    q->M      = _M;
+    q->m      = _m;
+    q->L      = 2*q->m;
+    q->offset = _offset ? 1 : 0;
+
+    // design prototype: windowed sinc with cut-off at the input Nyquist
+    // rate, Kaiser window (beta = 7), gain M to preserve the level of
+    // each channel after interpolation
+    float fc = 0.5f / (float)q->M;
+    float beta = 7.0f;
+    unsigned int h_len = q->M * q->L;
+    float h[h_len];
+    unsigned int i;
+    for (i=0; i<h_len; i++) {
+        float t = (float)i - (float)(q->m*q->M);
+        float r = t / (float)(q->m*q->M);
+        float w = fabsf(r) < 1.0f ? wlan_resamp_besseli0(beta*sqrtf(1.0f - r*r)) / wlan_resamp_besseli0(beta) : 0.0f;
+        float s = t == 0.0f ? 1.0f : sinf(2.0f*M_PI*fc*t) / (2.0f*M_PI*fc*t);
+        h[i] = 2.0f * fc * s * w * (float)(q->M);
+    }
+
+    // split into polyphase branches, time-reversing each so that the
+    // filter runs forward over the branch buffer
+    //   y(sM+p) = sum_l h[p + l*M] v_p(s - l)
+    q->h = (float*) malloc(q->M*2*q->L*sizeof(float));
+    unsigned int p, l;
+    for (p=0; p<q->M; p++) {
+        for (l=0; l<q->L; l++) {
+            float v = h[p + l*q->M];
+            q->h[p*2*q->L + 2*(q->L-l-1) + 0] = v;
+            q->h[p*2*q->L + 2*(q->L-l-1) + 1] = v;
+        }
+    }
+
+    // half-channel offset phasors
+    q->mix = (float complex*) malloc(2*q->M*sizeof(float complex));
+    for (i=0; i<2*q->M; i++)
+        q->mix[i] = cexpf(_Complex_I*M_PI*(float)i/(float)q->M);
+
+    // create transform object
+    q->X = (float complex*) malloc(q->M*sizeof(float complex));
+    q->V = (float complex*) malloc(q->M*sizeof(float complex));
+    q->ifft = FFT_CREATE_PLAN(q->M, q->X, q->V, FFT_DIR_BACKWARD, FFT_METHOD);
+
+    // buffers are grown as needed
+    q->num_alloc = 0;
+    q->stride    = q->L - 1;
+    q->buffer    = (float complex*) malloc(q->M*q->stride*sizeof(float complex));
+
+    // reset object
+    wlansynthesizer_reset(q);
+
+    return q;
+}
+
+// destroy synthesizer
+void wlansynthesizer_destroy(wlansynthesizer _q)
+{
+    free(_q->h);
+    free(_q->mix);
+    free(_q->X);
+    free(_q->V);
+    FFT_DESTROY_PLAN(_q->ifft);
+    free(_q->buffer);
+    free(_q);
+}
+
+// print synthesizer object internals
+void wlansynthesizer_print(wlansynthesizer _q)
+{
+    printf("wlansynthesizer:\n");
+    printf("    channels    :   %u (output %u MHz)\n", _q->M, 20*_q->M);
+    printf("    filter      :   %u taps (%u per branch)\n", _q->M*_q->L, _q->L);
+    unsigned int k;
+    for (k=0; k<_q->M; k++) {
+        // channel center relative to the output center, in MHz
+        float fk = (float)(2*k + _q->offset) * 10.0f;
+        if (2*k + _q->offset > _q->M)
+            fk -= 20.0f*(float)_q->M;
+        printf("    channel %-3u :   %+6.1f MHz\n", k, fk);
+    }
+}
+
+// reset synthesizer object internal state
+void wlansynthesizer_reset(wlansynthesizer _q)
+{
+    unsigned int p;
+    for (p=0; p<_q->M; p++)
+        memset(&_q->buffer[p*_q->stride], 0x00, (_q->L-1)*sizeof(float complex));
+    _q->t = 0;
+}
+
+// execute synthesizer on a block of samples from each channel
+//  _q          :   synthesizer object
+//  _x          :   input for each channel, NULL for a silent channel
+//                  [size: M x _n]
+//  _n          :   number of input samples per channel
+//  _y          :   output samples [size: M*_n x 1]
+void wlansynthesizer_execute(wlansynthesizer         _q,
+                             liquid_float_complex ** _x,
+                             unsigned int            _n,
+                             liquid_float_complex *  _y)
+{
+    unsigned int M = _q->M;
+    unsigned int L = _q->L;
+
+    // grow buffers as necessary, retaining history
+    if (_n > _q->num_alloc) {
+        unsigned int stride = L - 1 + _n;
+        float complex * buffer = (float complex*) malloc(M*stride*sizeof(float complex));
+        unsigned int p;
+        for (p=0; p<M; p++)
+            memmove(&buffer[p*stride], &_q->buffer[p*_q->stride], (L-1)*sizeof(float complex));
+        free(_q->buffer);
+        _q->buffer    = buffer;
+        _q->stride    = stride;
+        _q->num_alloc = _n;
+    }
+
+    // transform channel samples at each input time into branch inputs
+    unsigned int n, k, p;
+    for (n=0; n<_n; n++) {
+        for (k=0; k<M; k++)
+            _q->X[k] = _x[k] != NULL ? _x[k][n] : 0.0f;
+        FFT_EXECUTE(_q->ifft);
+        for (p=0; p<M; p++)
+            _q->buffer[p*_q->stride + L-1 + n] = _q->V[p];
+    }
+
+    // filter branches: branch p produces output samples nM+p
+    for (n=0; n<_n; n++) {
+        for (p=0; p<M; p++)
+            _y[n*M + p] = wlan_dotprod_crcf(&_q->h[p*2*L], &_q->buffer[p*_q->stride + n], L);
+    }
+
+    // shift channel centers by half a channel
+    if (_q->offset) {
+        unsigned int i;
+        for (i=0; i<M*_n; i++) {
+            _y[i] *= _q->mix[_q->t];
+            _q->t = (_q->t + 1) % (2*M);
+        }
+    }
+
+    // retain history
+    for (p=0; p<M; p++)
+        memmove(&_q->buffer[p*_q->stride], &_q->buffer[p*_q->stride + _n], (L-1)*sizeof(float complex));
+}